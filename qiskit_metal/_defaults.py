@@ -42,6 +42,13 @@ class DefaultMetalOptions(Dict):
         # Used for numpy.round()
         PRECISION=9,
 
+        # Database unit of the qgeometry, in units, such as 1e-6 for 1 nm.
+        # When set, the coordinates are snapped to integer multiples of it,
+        # see QGeometryTables.get_fixed_point_coordinates. When None, they
+        # are rounded to PRECISION decimals. Read when the tables are
+        # created; change it with QGeometryTables.set_dbu.
+        DBU=None,
+
         # Geometric
         geometry=Dict(
             buffer_resolution=16,  # for shapely buffer
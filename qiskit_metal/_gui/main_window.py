@@ -32,8 +32,10 @@ from qiskit_metal._gui.widgets.qlibrary_display.proxy_model_qlibrary import \
 
 from .. import config, qlibrary
 from ..designs.design_base import QDesign
+from ..toolbox_python.profiler import profiler
 from .elements_window import ElementsWindow
 from .net_list_window import NetListWindow
+from .rebuild_worker import RebuildWorker
 from .main_window_base import (QMainWindowBaseHandler, QMainWindowExtensionBase,
                                kick_start_qApp)
 from .main_window_ui import Ui_MainWindow
@@ -208,7 +210,7 @@ class QMainWindowExtension(QMainWindowExtensionBase):
         self.logger.info(
             r'Rebuilding all components in the model (and refreshing widgets)...'
         )
-        self.gui.rebuild()
+        self.gui.schedule_rebuild()
         #self.gui.ui.mainViewTab.doShow()
 
     @slot_catch_error()
@@ -317,6 +319,9 @@ class MetalGUI(QMainWindowBaseHandler):
         self.variables_window = PropertyTableWidget(self, gui=self)
 
         self.build_log_window = None
+        self.rebuild_worker = RebuildWorker(self, self.main_window)
+        self.rebuild_worker.progress.connect(self._rebuild_progress)
+        self.rebuild_worker.finished.connect(self._rebuild_finished)
 
         self._setup_component_widget()
         self._setup_plot_widget()
@@ -381,11 +386,13 @@ class MetalGUI(QMainWindowBaseHandler):
             design (QDesign): A qiskit metal design, such as a planar one.
                 The design contains all components and elements
         """
+        self.rebuild_worker.cancel()
         self.design = design
 
         self._set_enabled_design_widgets(True)
 
         self.plot_win.set_design(design)
+        self.ui.tableComponents.model().sourceModel().set_design(design)
         self.elements_win.force_refresh()
         self.net_list_win.force_refresh()
 
@@ -787,13 +794,43 @@ class MetalGUI(QMainWindowBaseHandler):
     def rebuild(self, autoscale: bool = False):
         """
         Rebuild all components in the design from scratch and refresh the gui.
-        """
 
+        The rebuild runs before the call returns, as scripts expect.  A
+        background rebuild, see `schedule_rebuild`, is cancelled first.
+        """
+        self.rebuild_worker.cancel()
         self.design.rebuild()
         self.refresh()
         if autoscale:
             self.autoscale()
 
+    def schedule_rebuild(self, component_names: List[str] = None):
+        """Rebuild components in a background thread, keeping the GUI
+        responsive.  The requests made while a rebuild waits or runs are
+        coalesced into the next one, and the gui is refreshed once they are
+        all done.
+
+        Args:
+            component_names (List[str]): Names of the components to rebuild.
+                Defaults to None, for all the components.
+        """
+        self.rebuild_worker.request(component_names)
+
+    def _rebuild_progress(self, count: int, total: int, name: str):
+        """Show the progress of the background rebuild."""
+        text = f'Rebuilding {count}/{total}: {name}'
+        self.statusbar_label.setText(text)
+        if self.build_log_window:
+            self.build_log_window.set_progress(text)
+
+    def _rebuild_finished(self, success: bool):
+        """Swap the rebuilt geometry into the gui."""
+        text = 'Rebuild done' if success else 'Rebuild failed'
+        self.statusbar_label.setText(text)
+        if self.build_log_window:
+            self.build_log_window.set_progress(text)
+        self.refresh()
+
     def refresh(self):
         """Refreshes everything. Overkill in general.
 
@@ -804,7 +841,12 @@ class MetalGUI(QMainWindowBaseHandler):
         Warning:
             This does *not* rebuild the components.
             For that, call rebuild.
+
+        Does nothing while a background rebuild changes the design; the gui is
+        refreshed when it is done.
         """
+        if self.rebuild_worker.is_running:
+            return
 
         # Global level
         self.refresh_design()
@@ -817,6 +859,8 @@ class MetalGUI(QMainWindowBaseHandler):
 
     def refresh_plot(self):
         """Redraw only the plot window contents."""
+        if self.rebuild_worker.is_running:
+            return
         self.plot_win.replot()
 
     def autoscale(self):
@@ -866,6 +910,10 @@ class MetalGUI(QMainWindowBaseHandler):
         Args:
             _ (object, optional): Default parameters for slot  - used to call from action
         """
+        # Time spent per stage, if the profiler collected any builds
+        summary = profiler.summary()
+        summary = None if summary.empty else summary.to_string(
+            float_format='%.2f')
         self.build_log_window = BuildHistoryScrollArea(
-            self.design.build_logs.data())
+            self.design.build_logs.data(), profile_summary=summary)
         self.build_log_window.show()
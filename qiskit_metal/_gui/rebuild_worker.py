@@ -0,0 +1,200 @@
+# -*- coding: utf-8 -*-
+
+# This code is part of Qiskit.
+#
+# (C) Copyright IBM 2017, 2021.
+#
+# This code is licensed under the Apache License, Version 2.0. You may
+# obtain a copy of this license in the LICENSE.txt file in the root directory
+# of this source tree or at http://www.apache.org/licenses/LICENSE-2.0.
+#
+# Any modifications or derivative works of this code must retain this
+# copyright notice, and modified files need to carry a notice indicating
+# that they have been altered from the originals.
+"""Rebuild of the design in a background thread, for the GUI.
+
+The option editors and the variable table ask for a rebuild of the
+components they change.  The requests are coalesced: a request cancels the
+rebuild which is waiting or running, and a single rebuild of all the
+requested components starts once the edits pause.  The rebuild reports its
+progress per component, and `finished` is only emitted once no request is
+left, so that the GUI swaps the new geometry into the plot in one refresh.
+
+The editors change the options and variables within `editing`, which stops
+the running rebuild first, so that `make` never reads them mid-edit.
+"""
+
+import threading
+from contextlib import contextmanager
+from typing import TYPE_CHECKING, List
+
+from PySide2.QtCore import QObject, QTimer, Signal
+
+from .. import Dict
+
+if TYPE_CHECKING:
+    from .main_window import MetalGUI
+
+
+class RebuildWorker(QObject):
+    """Runs the rebuilds asked for by the GUI in a background thread, one at
+    a time.
+
+    This class extends the `QObject` class.
+
+    Signals:
+        progress (int, int, str): Components made, their total and the name
+            of the last one. Emitted from the rebuild thread.
+        finished (bool): Emitted on the Qt thread when no rebuild is left,
+            with False if the last one failed.
+    """
+
+    progress = Signal(int, int, str)
+    finished = Signal(bool)
+    _done = Signal(object)
+
+    def __init__(self, gui: 'MetalGUI', parent: QObject = None, delay=300):
+        """
+        Args:
+            gui (MetalGUI): The GUI, whose design is rebuilt.
+            parent (QObject): Parent of the worker. Defaults to None.
+            delay (int): Time without request after which the rebuild starts,
+                in ms. Defaults to 300.
+        """
+        super().__init__(parent)
+        self.gui = gui
+        self.logger = gui.logger
+
+        self._pending = dict()  # names of the components to rebuild, ordered
+        self._pending_all = False
+        self._job = None  # type: Dict
+        self._job_count = 0
+        self._editing = False
+
+        self._timer = QTimer(self)
+        self._timer.setSingleShot(True)
+        self._timer.setInterval(delay)
+        self._timer.timeout.connect(self._start)
+        self._done.connect(self._on_done)
+
+    @property
+    def is_running(self) -> bool:
+        """True while a rebuild thread changes the design."""
+        return self._job is not None
+
+    def request(self, component_names: List[str] = None):
+        """Ask for a rebuild.  Cancels the rebuild waiting or running, which
+        is started again with the new components once the requests pause.
+
+        Args:
+            component_names (List[str]): Names of the components to rebuild.
+                Defaults to None, for all the components.
+        """
+        if component_names is None:
+            self._pending_all = True
+        else:
+            self._pending.update(dict.fromkeys(component_names))
+        if self._job is not None:
+            self._job.stop.set()
+        self._timer.start()
+
+    def cancel(self):
+        """Drop the requests and stop the running rebuild, waiting for its
+        thread to end.  The design is then only changed by the caller."""
+        self._timer.stop()
+        self._pending.clear()
+        self._pending_all = False
+        job, self._job = self._job, None
+        if job is not None:
+            job.stop.set()
+            job.thread.join()
+
+    @contextmanager
+    def editing(self):
+        """Stop the running rebuild, waiting for the component being made, so
+        that the caller can change the options or variables of the design.
+        The components not made yet are rebuilt after the block.
+
+        Example:
+            .. code-block:: python
+
+                with gui.rebuild_worker.editing():
+                    component.options[key] = value
+                gui.schedule_rebuild([component.name])
+        """
+        # Set first, so that _on_done only requeues and starts no new rebuild
+        self._editing = True
+        job = self._job
+        if job is not None:
+            job.stop.set()
+            job.thread.join()
+            self._on_done(job)  # requeue what was not made
+        try:
+            yield
+        finally:
+            self._editing = False
+            if self._pending or self._pending_all:
+                self._timer.start()
+
+    def _start(self):
+        """Start a rebuild of the pending components, unless one is still
+        stopping; it is then started when that one is done."""
+        if (self._job is not None or self._editing or
+                not (self._pending or self._pending_all)):
+            return
+        names = None if self._pending_all else list(self._pending)
+        self._pending.clear()
+        self._pending_all = False
+
+        self._job_count += 1
+        job = Dict(id=self._job_count,
+                   names=names,
+                   made=[],
+                   stop=threading.Event(),
+                   complete=False,
+                   error=None)
+        job.thread = threading.Thread(target=self._run,
+                                      args=(job, self.gui.design),
+                                      name='metal-rebuild',
+                                      daemon=True)
+        self._job = job
+        job.thread.start()
+
+    def _run(self, job: Dict, design):
+        """Body of the rebuild thread."""
+
+        def progress(count: int, total: int, name: str):
+            job.made.append(name)
+            self.progress.emit(count, total, name)
+
+        try:
+            job.complete = design.rebuild(job.names,
+                                          stop=job.stop.is_set,
+                                          progress=progress)
+        except Exception as error:  # pylint: disable=broad-except
+            job.error = error
+        self._done.emit(job)
+
+    def _on_done(self, job: Dict):
+        """Called on the Qt thread when a rebuild thread ends."""
+        if self._job is None or job.id != self._job.id:
+            return  # cancelled, the caller has taken over
+        self._job = None
+
+        if job.error is not None:
+            self.logger.error(f'Rebuild failed: {job.error}')
+        elif not job.complete:
+            # Cancelled by a newer request: redo what was not made yet
+            if job.names is None:
+                self._pending_all = True
+            else:
+                made = set(job.made)
+                self._pending.update(
+                    dict.fromkeys(
+                        name for name in job.names if name not in made))
+
+        if self._pending or self._pending_all:
+            if not self._timer.isActive():
+                self._start()
+        else:
+            self.finished.emit(job.error is None)
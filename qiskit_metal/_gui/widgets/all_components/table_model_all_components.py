@@ -41,7 +41,9 @@ class QTableModel_AllComponents(QAbstractTableModel):
         index = model.index(1,0)
         model.data(index)
     """
-    __timer_interval = 500  # ms
+    # Design events, emitted from the thread which changed the design, are
+    # handled on the thread of the model
+    _design_event = QtCore.Signal(str, object)
 
     def __init__(self,
                  gui,
@@ -63,52 +65,116 @@ class QTableModel_AllComponents(QAbstractTableModel):
             'Name', 'QComponent class', 'QComponent module', 'Build status',
             'id'
         ]
-        self._row_count = -1
+        # Ids of the components, one per row.  The cells are read from the
+        # component when the view asks for them, for the visible rows only.
+        self._ids = []
+        self._listened_design = None
 
-        self._create_timer()
+        self._design_event.connect(self._on_design_event)
+        self.set_design(self.design)
 
     @property
     def design(self):
         """Returns the design."""
         return self.gui.design
 
-    def _create_timer(self):
-        """Refresh the model number of rows, etc.
+    def set_design(self, design):
+        """Listen to the changes of the components of a new design, instead of
+        the previous one, and reset the model.
 
-        there must be a smarter way?
+        Args:
+            design (QDesign): The design
         """
-        self._timer = QtCore.QTimer(self)
-        self._timer.start(self.__timer_interval)
-        self._timer.timeout.connect(self.refresh_auto)
+        if self._listened_design is not None:
+            self._listened_design.remove_component_listener(
+                self._design_event.emit)
+        self._listened_design = design
+        if design is not None:
+            design.add_component_listener(self._design_event.emit)
+        self._reset()
 
     def refresh(self):
         """Force refresh.
 
-        Completly rebuild the model.
+        Resets the model if the components differ from the rows, else
+        updates all the cells, which keeps the selection.
         """
-        self.modelReset.emit()
-
-    def refresh_auto(self):
-        """Automatic refresh, update row count, view, etc."""
-        # We could not do if the widget is hidden
-        new_count = self.rowCount()
-
-        # if the number of rows have changed
-        if self._row_count != new_count:
-            #self.logger.info('Number of components changed')
-
-            # When a model is reset it should be considered that all
-            # information previously retrieved from it is invalid.
-            # This includes but is not limited to the rowCount() and
-            # columnCount(), flags(), data retrieved through data(), and roleNames().
-            # This will loose the current selection.
-            self.modelReset.emit()
+        if self.design is not self._listened_design:
+            self.set_design(self.design)
+        elif self._ids != self._design_ids():
+            self._reset()
+        elif self._ids:
+            self.dataChanged.emit(
+                self.index(0, 0),
+                self.index(len(self._ids) - 1,
+                           len(self.columns) - 1))
+
+    def _design_ids(self) -> list:
+        """Returns the ids of the components of the design, in order."""
+        if self.design:
+            # pylint: disable=protected-access
+            return list(self.design._components.keys())
+        return []
+
+    def _reset(self):
+        """Completly rebuild the model."""
+        self.beginResetModel()
+        self._ids = self._design_ids()
+        self.endResetModel()
+        self._update_placeholder()
 
+        if self._tableView:
             # for some reason the horizontal header is hidden even if i call this in init
             self._tableView.horizontalHeader().show()
+        self.update_view()
+
+    def _on_design_event(self, event: str, component_id: int):
+        """Apply a change of the components of the design to the rows.
 
-            self._row_count = new_count
-            self.update_view()
+        The events are queued when the design changes in another thread, so
+        the design may have changed again since.
+
+        Args:
+            event (str): The event, see QDesign.add_component_listener
+            component_id (int): Id of the component
+        """
+        # pylint: disable=protected-access
+        components = self.design._components if self.design else {}
+
+        if event == 'added':
+            if component_id in components and component_id not in self._ids:
+                row = len(self._ids)
+                self.beginInsertRows(QModelIndex(), row, row)
+                self._ids.append(component_id)
+                self.endInsertRows()
+                self._update_placeholder()
+
+        elif event == 'deleted':
+            if component_id in self._ids:
+                row = self._ids.index(component_id)
+                self.beginRemoveRows(QModelIndex(), row, row)
+                del self._ids[row]
+                self.endRemoveRows()
+                self._update_placeholder()
+
+        elif event in ('renamed', 'status'):
+            if component_id in self._ids:
+                row = self._ids.index(component_id)
+                self.dataChanged.emit(self.index(row, 0),
+                                      self.index(row,
+                                                 len(self.columns) - 1))
+
+        else:  # 'cleared'
+            self._reset()
+
+    def _update_placeholder(self):
+        """Show the placeholder text if there are no components."""
+        if not self._tableView:
+            return
+        if self._ids:
+            self._tableView.hide_placeholder_text()
+        else:
+            self._tableView.show_placeholder_text()
 
     def update_view(self):
         """Updates the view."""
@@ -124,16 +190,7 @@ class QTableModel_AllComponents(QAbstractTableModel):
         Returns:
             int: The number of rows
         """
-        if self.design:  # should we just enforce this
-            num = int(len(self.design.components))
-            if num == 0:
-                self._tableView.show_placeholder_text()
-            else:
-                self._tableView.hide_placeholder_text()
-            return num
-        else:
-            self._tableView.show_placeholder_text()
-            return 0
+        return len(self._ids)
 
     def columnCount(self, parent: QModelIndex = None):
         """Returns the number of columns.
@@ -203,22 +260,23 @@ class QTableModel_AllComponents(QAbstractTableModel):
         if not index.isValid() or not self.design:
             return
 
-        component_name = list(self.design.components.keys())[index.row()]
+        # pylint: disable=protected-access
+        component = self.design._components.get(self._ids[index.row()])
+        if component is None:
+            return
 
         if role == Qt.DisplayRole:
 
             if index.column() == 0:
-                return str(component_name)
+                return str(component.name)
             elif index.column() == 1:
-                return str(
-                    self.design.components[component_name].__class__.__name__)
+                return str(component.__class__.__name__)
             elif index.column() == 2:
-                return str(
-                    self.design.components[component_name].__class__.__module__)
+                return str(component.__class__.__module__)
             elif index.column() == 3:
-                return str(self.design.components[component_name].status)
+                return str(component.status)
             elif index.column() == 4:
-                return str(self.design.components[component_name].id)
+                return str(component.id)
 
         # The font used for items rendered with the default delegate. (QFont)
         elif role == Qt.FontRole:
@@ -229,7 +287,6 @@ class QTableModel_AllComponents(QAbstractTableModel):
 
         elif role == Qt.BackgroundRole:
 
-            component = self.design.components[component_name]
             if component.status != 'good':  # Did the component fail the build
                 #    and index.column()==0:
                 if not self._tableView:
@@ -242,11 +299,9 @@ class QTableModel_AllComponents(QAbstractTableModel):
         elif role == Qt.DecorationRole:
 
             if index.column() == 0:
-                component = self.design.components[component_name]
                 if component.status != 'good':  # Did the component fail the build
                     return QIcon(":/sample_shapes/warning")
 
         elif role == Qt.ToolTipRole or role == Qt.StatusTipRole:
-            component = self.design.components[component_name]
             text = f"""Component name= "{component.name}" instance of class "{component.__class__.__name__}" from module "{component.__class__.__module__}" """
             return text
@@ -65,6 +65,8 @@ class QTableView_AllComponents(QTableView, QWidget_PlaceholderText):
         # Do in the ui file
         self.horizontalHeader().hide()
         self.verticalHeader().show()
+        # Size the columns to the visible rows only, not to all the components
+        self.horizontalHeader().setResizeContentsPrecision(0)
 
         self.setVerticalScrollMode(QAbstractItemView.ScrollPerPixel)
         self.setHorizontalScrollMode(QAbstractItemView.ScrollPerPixel)
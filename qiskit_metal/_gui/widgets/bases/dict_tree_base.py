@@ -448,7 +448,6 @@ class QTreeModel_Base(QAbstractItemModel):
 
                     # Set the value of an option when the new value is different
                     else:
-                        dic = self.data_dict  # option dict
                         lbl = node.label  # option key
 
                         self.logger.info(
@@ -469,18 +468,32 @@ class QTreeModel_Base(QAbstractItemModel):
                             value = processed_value
                         #################################################
 
-                        if node.path:  # if nested option
-                            for x in node.path[:-1]:
-                                dic = dic[x]
-                            dic[node.path[-1]] = value
-                        else:  # if top-level option
-                            dic[lbl] = value
                         if self.optionstype == 'component':
-                            self.component.rebuild()
-                            self.gui.refresh()
+                            # Not while the background rebuild reads them
+                            with self.gui.rebuild_worker.editing():
+                                self._set_option(node, lbl, value)
+                            self.gui.schedule_rebuild([self.component.name])
+                        else:
+                            self._set_option(node, lbl, value)
                         return True
         return False
 
+    def _set_option(self, node: 'LeafNode', lbl: str, value):
+        """Set the value of the option of a leaf node.
+
+        Args:
+            node (LeafNode): The node of the option
+            lbl (str): The option key, for a top-level option
+            value (Any): The new value
+        """
+        dic = self.data_dict  # option dict
+        if node.path:  # if nested option
+            for x in node.path[:-1]:
+                dic = dic[x]
+            dic[node.path[-1]] = value
+        else:  # if top-level option
+            dic[lbl] = value
+
     def headerData(self, section: int, orientation: Qt.Orientation,
                    role: Qt.ItemDataRole):
         """Set the headers to be displayed.
@@ -14,6 +14,7 @@ class BuildHistoryScrollArea(QScrollArea, Ui_BuildHistory):
                  previous_builds: List[str],
                  parent=None,
                  *args,
+                 profile_summary: str = None,
                  **kwargs):
         """
         Args:
@@ -25,15 +26,34 @@ class BuildHistoryScrollArea(QScrollArea, Ui_BuildHistory):
                 BuildHistoryScrollArea should always display the latest logs at the top
             parent (QWidget):
                 Parent widget if necessary
+            profile_summary (str):
+                Table of the time spent in each stage of the builds, from the
+                profiler, displayed above the logs. Defaults to None.
 
         """
         super(BuildHistoryScrollArea, self).__init__(parent, *args, **kwargs)
         self.setupUi(self)
         self._previous_builds = previous_builds
+        self._profile_summary = profile_summary
+        self._progress_label = None
         self._display_logs()
 
+    def set_progress(self, text: str):
+        """Show the progress of the running rebuild above the logs.
+
+        Args:
+            text (str): Progress, such as 'Rebuilding 3/10: Q1'
+        """
+        self._progress_label.setText(text)
+
     def _display_logs(self):
         """Create UI for BuildHistoryScrollAreas."""
+        self._progress_label = QLabel('')
+        self.build_display_vertical_layout.addWidget(self._progress_label)
+        if self._profile_summary:
+            label = QLabel(self._profile_summary)
+            label.setStyleSheet('font-family: monospace')
+            self.build_display_vertical_layout.addWidget(label)
         for build_log_indx in range(len(self._previous_builds)):
             label = QLabel(self._previous_builds[build_log_indx])
             if 'ERROR' in self._previous_builds[build_log_indx]:
@@ -252,17 +252,18 @@ class QTableModel_Options(QAbstractTableModel):
                         f'Component options: Old value={old_val}; New value={value};'
                     )
                     if isinstance(old_val, str):
-                        data[key] = str(value)
+                        processed_value = str(value)
                     else:
                         processed_value, used_ast = parse_param_from_str(value)
                         self.logger.info(
                             f'  Used paring:  Old value type={type(old_val)}; '
                             f'New value type={type(processed_value)};  New value={processed_value};'
                             f'; Used ast={used_ast}')
+                    # Not while the background rebuild reads the options
+                    with self.gui.rebuild_worker.editing():
                         data[key] = processed_value
 
-                    self.component.rebuild()
-                    self.gui.refresh()
+                    self.gui.schedule_rebuild([self.component.name])
 
                 # except and finally restore the value
                 return True
@@ -24,7 +24,7 @@ import random
 from pathlib import Path
 
 from PySide2 import QtGui
-from PySide2.QtCore import Qt
+from PySide2.QtCore import Qt, Signal
 from PySide2.QtWidgets import QAction, QDockWidget, QTextEdit
 
 from .... import Dict, __version__, config
@@ -45,6 +45,10 @@ class QTextEditLogger(QTextEdit):
     timestamp_len = 19
     _logo = 'metal_logo.png'
 
+    # (name, html message) of a record, queued to the GUI thread when logged
+    # from another thread, such as the background rebuild
+    _message_logged = Signal(str, str)
+
     def __init__(self, img_path='/', dock_window: QDockWidget = None):
         """Widget to handle logging. Based on QTextEdit, an advanced WYSIWYG
         viewer/editor supporting rich text formatting using HTML-style tags. It
@@ -71,6 +75,7 @@ class QTextEditLogger(QTextEdit):
         self._auto_scroll = True  # autoscroll to end or not
         self._show_timestamps = False
         self._level_name = ''
+        self._message_logged.connect(self.log_message_to)
 
         # Props of the Widget
         self.setTextInteractionFlags(Qt.TextSelectableByMouse |
@@ -432,7 +437,9 @@ class LogHandler_for_QTextLog(logging.Handler):
         html_log_message = '<span class="%s"><pre>%s</pre></span>' % (
             record.levelname, html_record)
         try:
-            self.log_qtextedit.log_message_to(self.name, html_log_message)
+            # Qt widgets may only be changed from the GUI thread
+            self.log_qtextedit._message_logged.emit(  # pylint: disable=protected-access
+                self.name, html_log_message)
         except RuntimeError as e:
             # trying to catch
             #  RuntimeError('wrapped C/C++ object of type QTextEditLogger has been deleted',)
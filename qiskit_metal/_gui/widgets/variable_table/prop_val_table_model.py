@@ -12,6 +12,8 @@
 # copyright notice, and modified files need to carry a notice indicating
 # that they have been altered from the originals.
 
+from typing import List
+
 from PySide2 import QtCore
 from PySide2.QtCore import QAbstractTableModel, QModelIndex, Qt
 from PySide2.QtGui import QFont
@@ -164,13 +166,16 @@ class PropValTable(QAbstractTableModel):
                 # TODO: LRU Cache for speed?
                 oldkey = list(self._data.keys())[r]
                 if value != oldkey:
-                    self.design.rename_variable(oldkey, value)
-                    self._gui.rebuild()
+                    with self._gui.rebuild_worker.editing():
+                        self.design.rename_variable(oldkey, value)
+                    self._rebuild_dependents([oldkey, value])
                     return True
 
             elif c == 1:
-                self._data[list(self._data.keys())[r]] = value
-                self._gui.rebuild()
+                key = list(self._data.keys())[r]
+                with self._gui.rebuild_worker.editing():
+                    self._data[key] = value
+                self._rebuild_dependents([key])
                 return True
 
         return False
@@ -213,9 +218,11 @@ class PropValTable(QAbstractTableModel):
         """
         self.beginRemoveRows(parent, row, row + count - 1)
         lst = list(self._data.keys())
-        for k in range(row + count - 1, row - 1, -1):
-            del self._data[lst[k]]
+        with self._gui.rebuild_worker.editing():
+            for k in range(row + count - 1, row - 1, -1):
+                del self._data[lst[k]]
         self.endRemoveRows()
+        self._rebuild_dependents(lst[row:row + count])
 
     def flags(self, index: QModelIndex) -> Qt.ItemFlags:
         """Determine how user may interact with each cell in the table.
@@ -237,5 +244,18 @@ class PropValTable(QAbstractTableModel):
             key (str): The key
             val (str): The value
         """
-        self._data[key] = val
+        with self._gui.rebuild_worker.editing():
+            self._data[key] = val
         self._view.resizeColumnsToContents()
+        self._rebuild_dependents([key])
+
+    def _rebuild_dependents(self, variable_names: List[str]):
+        """Rebuild, in the background, only the components which depend on
+        the changed variables.
+
+        Args:
+            variable_names (List[str]): Names of the changed variables
+        """
+        dependents = self.design.variable_dependents(variable_names)
+        if dependents:
+            self._gui.schedule_rebuild(dependents)
@@ -42,6 +42,7 @@ Hamiltonian
     Hcpb_analytic
     HO_wavefunctions
     transmon_analytics
+    charge_dispersion
 
 Electromagnetic & quantization / parameter extraction
 -----------------------------------------------------
@@ -59,6 +60,10 @@ Sweeping Options
     :toctree:
 
     Sweeper
+    SweepStore
+    SurrogateOptimizer
+    grid_points
+    latin_hypercube_points
 
 Quantization
 ------------
@@ -98,4 +103,8 @@ from .hamiltonian.transmon_charge_basis import Hcpb
 from .hamiltonian import HO_wavefunctions
 from .hamiltonian import transmon_analytics
 from .hamiltonian.transmon_CPB_analytic import Hcpb_analytic
+from .hamiltonian import charge_dispersion
 from .sweep_and_optimize.sweeper import Sweeper
+from .sweep_and_optimize.sweep_store import SweepStore
+from .sweep_and_optimize.optimizer import SurrogateOptimizer
+from .sweep_and_optimize.optimizer import grid_points, latin_hypercube_points
@@ -103,6 +103,27 @@ class QAnalysis(ABC):
         all_sweep, return_code = self._sweeper.run_sweep(*args, **kwargs)
         return all_sweep, return_code
 
+    def run_sweep_parallel(self, *args, **kwargs):
+        """User requests a parallel, resumable sweep based on arguments from
+        Sweeper.run_sweep_parallel().
+        """
+        if not self._sweeper:
+            self._initialize_sweep()
+
+        all_sweep, return_code = self._sweeper.run_sweep_parallel(
+            *args, **kwargs)
+        return all_sweep, return_code
+
+    def run_multi_sweep(self, *args, **kwargs):
+        """User requests a sweep of several options at once, based on
+        arguments from Sweeper.run_multi_sweep().
+        """
+        if not self._sweeper:
+            self._initialize_sweep()
+
+        all_sweep, return_code = self._sweeper.run_multi_sweep(*args, **kwargs)
+        return all_sweep, return_code
+
     def save_run_args(self, **kwargs):
         """Intended to be used to store the kwargs passed to the run() method,
         for repeatability and for later identification of the QAnalysis instance.
@@ -0,0 +1,282 @@
+# -*- coding: utf-8 -*-
+
+# This code is part of Qiskit.
+#
+# (C) Copyright IBM 2017, 2021.
+#
+# This code is licensed under the Apache License, Version 2.0. You may
+# obtain a copy of this license in the LICENSE.txt file in the root directory
+# of this source tree or at http://www.apache.org/licenses/LICENSE-2.0.
+#
+# Any modifications or derivative works of this code must retain this
+# copyright notice, and modified files need to carry a notice indicating
+# that they have been altered from the originals.
+"""Batched solver of the Cooper pair box Hamiltonian in the charge basis.
+
+The Hamiltonian of the CPB, see Hcpb, is a symmetric tridiagonal matrix.
+Only its lowest few eigenvalues are needed for the transition frequencies,
+the anharmonicity and the charge dispersion.  Instead of diagonalizing one
+matrix per (Ej, Ec, ng) in a python loop, the lowest eigenvalues of all the
+matrices are found at once by bisection on the Sturm sequence, vectorized
+with numpy over every matrix and every level.
+
+Example use:
+
+    .. code-block::
+
+        Ej = np.linspace(10e3, 20e3, 1001)  # MHz
+        levels = cpb_levels(Ej, 300, ng=np.linspace(-1, 1, 301)[:, None])
+        # levels.shape == (301, 1001, 3)
+
+        disp = charge_dispersion(Ej, 300)
+        t2 = dephasing_time_charge_noise(disp.dispersion[..., 1] * 1e6)
+"""
+# pylint: disable=invalid-name
+
+from functools import lru_cache
+
+import numpy as np
+
+from qiskit_metal import Dict
+
+__all__ = [
+    'tridiagonal_lowest_eigvals', 'cpb_levels', 'charge_dispersion',
+    'dephasing_time_charge_noise', 'spectrum_table', 'params_from_spectrum'
+]
+
+
+def tridiagonal_lowest_eigvals(diag: np.ndarray, off: np.ndarray,
+                               num_levels: int) -> np.ndarray:
+    """Lowest eigenvalues of a stack of real symmetric tridiagonal matrices.
+
+    Each eigenvalue is found by bisection of its Gershgorin bracket, using
+    the Sturm sequence to count the eigenvalues below the trial value.  All
+    the matrices and levels are bisected together, so the python loop only
+    runs over the size of the matrices, never over the batch.
+
+    Args:
+        diag (np.ndarray): Diagonals, shape (..., n).
+        off (np.ndarray): Off-diagonals, shape (..., n - 1), broadcast
+            against diag.
+        num_levels (int): Number of eigenvalues to return, from the lowest.
+
+    Returns:
+        np.ndarray: Eigenvalues in increasing order, shape (..., num_levels).
+    """
+    diag = np.asarray(diag, dtype=float)
+    off = np.broadcast_to(np.asarray(off, dtype=float),
+                          diag.shape[:-1] + (diag.shape[-1] - 1,))
+    batch_shape = diag.shape[:-1]
+    size = diag.shape[-1]
+
+    # One lane per (matrix, level), with the lanes along the last axis so
+    # every step of the Sturm sequence works on contiguous memory.
+    diag = np.repeat(diag.reshape(-1, size), num_levels, axis=0).T.copy()
+    off_sq = np.repeat(off.reshape(-1, size - 1)**2, num_levels,
+                       axis=0).T.copy()
+    level = np.tile(np.arange(num_levels), diag.shape[1] // num_levels)
+
+    off_abs = np.sqrt(off_sq)
+    # Keeps 0 / 0 out of the Sturm sequence of decoupled blocks.
+    off_sq = np.maximum(off_sq, np.finfo(float).tiny)
+    radius = np.zeros_like(diag)
+    radius[:-1] += off_abs
+    radius[1:] += off_abs
+    lower = np.min(diag - radius, axis=0)
+    upper = np.max(diag + radius, axis=0)
+    tol = 2 * np.finfo(float).eps * np.maximum(np.abs(lower), np.abs(upper))
+
+    pivots = np.empty_like(diag)
+    ratio = np.empty_like(lower)
+    # Each step halves the bracket: 64 steps reach the precision of a float
+    # from any Gershgorin bracket.
+    with np.errstate(divide='ignore', invalid='ignore'):
+        for _ in range(64):
+            x = 0.5 * (lower + upper)
+            # Sturm sequence of T - x; the number of negative pivots is the
+            # number of eigenvalues below x.  A zero pivot gives an infinite
+            # ratio, which IEEE arithmetic carries through correctly.
+            np.subtract(diag, x, out=pivots)
+            for i in range(1, size):
+                np.divide(off_sq[i - 1], pivots[i - 1], out=ratio)
+                np.subtract(pivots[i], ratio, out=pivots[i])
+            above = np.count_nonzero(pivots < 0, axis=0) > level
+            upper = np.where(above, x, upper)
+            lower = np.where(above, lower, x)
+            if np.all(upper - lower <= tol):
+                break
+    x = 0.5 * (lower + upper)
+
+    return x.reshape(batch_shape + (num_levels,))
+
+
+def cpb_levels(Ej, Ec, ng=0.5, nlevels: int = 15, num_levels: int = 3):
+    """Lowest energy levels of the Cooper pair box for every combination of
+    Ej, Ec and ng, which are broadcast against each other.
+
+    Same Hamiltonian as Hcpb: diagonal 4 Ec (n - ng)^2 for the charge states
+    n in [-nlevels, nlevels], and off-diagonal -Ej/2.
+
+    Args:
+        Ej (np.ndarray): Josephson energy of the JJ.
+        Ec (np.ndarray): Charging energy of the CPB, in the units of Ej.
+        ng (np.ndarray): Offset charge of the CPB, in units of 2e.
+            Defaults to 0.5.
+        nlevels (int): Number of charge states of the CPB [-nlevels, nlevels].
+            Defaults to 15.
+        num_levels (int): Number of energy levels to return. Defaults to 3.
+
+    Returns:
+        np.ndarray: Energies, in the units of Ej, of shape
+        broadcast(Ej, Ec, ng).shape + (num_levels,).
+    """
+    Ej, Ec, ng = np.broadcast_arrays(np.asarray(Ej, dtype=float),
+                                     np.asarray(Ec, dtype=float),
+                                     np.asarray(ng, dtype=float))
+    n = np.arange(-nlevels, nlevels + 1)
+    diag = 4 * Ec[..., None] * (n - ng[..., None])**2
+    off = -0.5 * Ej[..., None] * np.ones(2 * nlevels)
+    return tridiagonal_lowest_eigvals(diag, off, num_levels)
+
+
+def charge_dispersion(Ej, Ec, nlevels: int = 15, num_levels: int = 3) -> Dict:
+    """Transition frequencies, anharmonicity and charge dispersion of the CPB,
+    for arrays of Ej and Ec.
+
+    The bands of the CPB have their extrema at ng = 0 and ng = 0.5, so only
+    these two charge offsets are solved.
+
+    Args:
+        Ej (np.ndarray): Josephson energy of the JJ.
+        Ec (np.ndarray): Charging energy of the CPB, in the units of Ej.
+        nlevels (int): Number of charge states of the CPB. Defaults to 15.
+        num_levels (int): Number of energy levels. Defaults to 3.
+
+    Returns:
+        Dict: Arrays of shape broadcast(Ej, Ec).shape, in the units of Ej:
+
+        * f01: Transition 0-1, averaged over the charge offset.
+        * anharm: E12 - E01, averaged over the charge offset.
+        * dispersion: Peak to peak dispersion of each level relative to the
+          ground state, with a last axis of length num_levels.
+    """
+    levels = cpb_levels(np.asarray(Ej)[..., None],
+                        np.asarray(Ec)[..., None],
+                        np.array([0., 0.5]),
+                        nlevels=nlevels,
+                        num_levels=max(num_levels, 3))
+    relative = levels - levels[..., :1]
+    mean = np.mean(relative, axis=-2)
+    dispersion = np.abs(relative[..., 0, :] - relative[..., 1, :])
+    return Dict(f01=mean[..., 1],
+                anharm=mean[..., 2] - 2 * mean[..., 1],
+                dispersion=dispersion[..., :num_levels])
+
+
+def dephasing_time_charge_noise(dispersion_hz, delta_ng: float = 1e-4):
+    """Estimate of the dephasing time due to charge noise, for a qubit with
+    a peak to peak charge dispersion of the 0-1 transition `dispersion_hz`.
+
+    Same estimate as levels_vs_ng_real_units:
+    T2 = 1 / (pi^2 * dispersion * delta_ng).
+
+    Args:
+        dispersion_hz (np.ndarray): Charge dispersion, in Hz.
+        delta_ng (float): Amplitude of the charge noise, in units of 2e.
+            Defaults to 1e-4.
+
+    Returns:
+        np.ndarray: Dephasing time, in seconds.
+    """
+    return 2 / (2 * np.pi * np.asarray(dispersion_hz) * np.pi * delta_ng)
+
+
+def _ratio_spectrum(ratio, ng: float, nlevels: int):
+    """f01 / Ec and anharmonicity / Ec of the CPB with Ej / Ec = ratio."""
+    levels = cpb_levels(ratio, 1., ng, nlevels=nlevels, num_levels=3)
+    f01 = levels[..., 1] - levels[..., 0]
+    return f01, (levels[..., 2] - levels[..., 1]) - f01
+
+
+@lru_cache(maxsize=16)
+def spectrum_table(ng: float = 0.5,
+                   nlevels: int = 15,
+                   ratio_max: float = 2000.,
+                   num_points: int = 4001) -> Dict:
+    """Table of the spectrum of the CPB as a function of Ej / Ec, computed
+    once per set of arguments and cached.
+
+    In units of Ec, f01 and the anharmonicity depend only on Ej / Ec.  The
+    table keeps the range of Ej / Ec up to ratio_max where anharm / f01 is
+    strictly increasing, so that it can be inverted.
+
+    Args:
+        ng (float): Offset charge of the CPB. Defaults to 0.5.
+        nlevels (int): Number of charge states of the CPB. Defaults to 15.
+        ratio_max (float): Largest Ej / Ec of the table. Defaults to 2000.
+        num_points (int): Number of log spaced values of Ej / Ec.
+            Defaults to 4001.
+
+    Returns:
+        Dict: Arrays ratio (Ej / Ec), f01 (f01 / Ec), anharm (anharm / Ec)
+        and anharm_over_f01.
+    """
+    ratio = np.geomspace(1e-2, ratio_max, num_points)
+    f01, anharm = _ratio_spectrum(ratio, ng, nlevels)
+    anharm_over_f01 = anharm / f01
+    decreasing = np.nonzero(np.diff(anharm_over_f01) <= 0)[0]
+    start = decreasing[-1] + 1 if len(decreasing) else 0
+    return Dict(ratio=ratio[start:],
+                f01=f01[start:],
+                anharm=anharm[start:],
+                anharm_over_f01=anharm_over_f01[start:])
+
+
+def params_from_spectrum(f01,
+                         anharm,
+                         ng: float = 0.5,
+                         nlevels: int = 15,
+                         max_iter: int = 5):
+    """Ej and Ec of the CPB with the target transition frequencies f01 and
+    anharmonicities, for whole arrays of targets at once.
+
+    The ratio anharm / f01 fixes Ej / Ec, which is read from the cached
+    spectrum_table by interpolation, and then polished by a few Newton steps
+    on the exact spectrum.  f01 then fixes Ec.
+
+    Args:
+        f01 (np.ndarray): Target qubit frequencies.
+        anharm (np.ndarray): Target anharmonicities, in the units of f01.
+            The sign is ignored, the anharmonicity of the transmon being
+            negative.
+        ng (float): Offset charge of the CPB. Defaults to 0.5.
+        nlevels (int): Number of charge states of the CPB. Defaults to 15.
+        max_iter (int): Maximum number of Newton steps. Defaults to 5.
+
+    Returns:
+        tuple: Ej and Ec, of the broadcast shape of f01 and anharm, in the
+        units of f01.  NaN for targets outside of the range of the table.
+    """
+    f01, anharm = np.broadcast_arrays(np.asarray(f01, dtype=float),
+                                      -np.abs(np.asarray(anharm, dtype=float)))
+    table = spectrum_table(ng, nlevels)
+    target = anharm / f01
+    log_table = np.log(table.ratio)
+    outside = (target < table.anharm_over_f01[0]) | (
+        target > table.anharm_over_f01[-1])
+
+    log_ratio = np.interp(target, table.anharm_over_f01, log_table)
+    slope = np.gradient(table.anharm_over_f01, log_table)
+    for _ in range(max_iter):
+        f01_unit, anharm_unit = _ratio_spectrum(np.exp(log_ratio), ng, nlevels)
+        error = anharm_unit / f01_unit - target
+        log_ratio = np.clip(
+            log_ratio - error / np.interp(log_ratio, log_table, slope),
+            log_table[0], log_table[-1])
+        if np.all(np.abs(error[~outside]) <= 1e-12 * np.abs(target[~outside])):
+            break
+
+    ratio = np.exp(log_ratio)
+    Ec = f01 / _ratio_spectrum(ratio, ng, nlevels)[0]
+    Ej = ratio * Ec
+    return np.where(outside, np.nan, Ej), np.where(outside, np.nan, Ec)
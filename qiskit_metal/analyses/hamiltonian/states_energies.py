@@ -16,11 +16,12 @@ This file contains functions related to extracting and manipulating Hamiltonians
 and their energy levels.
 """
 from typing import Dict as Dict_
-from typing import List
+from typing import List, Tuple
 
 import numpy as np
 import qutip
-from qutip import Qobj
+from scipy import sparse
+from scipy.sparse.linalg import eigsh
 
 
 def basis_state_on(mode_size: List[int], excitations: Dict_[int, int]):
@@ -53,7 +54,9 @@ def extract_energies(esys_array: np.ndarray,
         esys_array (np.ndarray): numpy array of shape (2, ). It's an array of objects.
             The first element of the array is an array of eigenvalues of the diagonalized
             hamiltonian. The second element of the array is an QutipEigenStates object,
-            which is a list of the corresponding eigenstates of the diagonalized hamiltonian
+            which is a list of the corresponding eigenstates of the diagonalized hamiltonian,
+            or an array whose columns are the eigenvectors, as returned by
+            lowest_eigensystem
         mode_size (List[int]): list of integers specifying number of fock states
             for each mode, respectively
         zero_evals (bool, optional): If true, the "ground state" eigenvalue is substracted
@@ -73,53 +76,16 @@ def extract_energies(esys_array: np.ndarray,
 
     N = len(mode_size)
 
-    def state_on(excitations):
-        return basis_state_on(mode_size, excitations)  # eigenstate on
-
     chis = np.empty((N, N))
 
-    # Reformat the set of eigenvectors as a matrix where each row of the matrix
-    # is the hermitian conjugate of the original eigenvector
-    evecs_dag_mat = np.squeeze(
-        np.array([evecs[ii].dag() for ii in range(evecs.size)]))
+    evecs_mat = _eigenvectors_as_columns(evecs)
+    single_idx, double_idx, mode_idx_to_state = _excitation_indices(mode_size)
 
-    single_excitation_states = [state_on({i: 1}) for i in range(N)]
-
-    # Prepare states with 2-photon excitations, either in two separate modes or
-    # the same mode
-    double_excitation_states = []
-    mode_idx_to_state = {}
-    for i in range(N):
-        for j in range(i, N):
-            d = {k: 0 for k in range(N)}  # put 0 photons in each mode (k)
-            # load ith mode and jth mode with 1 photon
-            d[i] += 1
-            d[j] += 1
-            # mode_idx_to_state keeps track of mode excitation index for each state
-            mode_idx_to_state[(i, j)] = len(double_excitation_states)
-            double_excitation_states.append(state_on(d))
-
-    # Format the target states as a matrix where each column of the matrix
-    # is one of the target states
-
-    single_excitation_states_mat = np.squeeze(
-        np.array([
-            single_excitation_states[ii]
-            for ii in range(len(single_excitation_states))
-        ])).T
-
-    double_excitation_states_mat = np.squeeze(
-        np.array([
-            double_excitation_states[ii]
-            for ii in range(len(double_excitation_states))
-        ])).T
-
-    # Find the inner product of each of the target state with each of the
-    # eigenvector; hence overlap has dimension of number of eigenvectors x number of target states
-    overlap_single = np.absolute(
-        np.array((Qobj(evecs_dag_mat) * Qobj(single_excitation_states_mat))))
-    overlap_double = np.absolute(
-        np.array((Qobj(evecs_dag_mat) * Qobj(double_excitation_states_mat))))
+    # The overlap of a target basis state with an eigenvector is the magnitude
+    # of its component; overlap has dimension of number of eigenvectors x number
+    # of target states
+    overlap_single = np.absolute(evecs_mat[single_idx, :]).T
+    overlap_double = np.absolute(evecs_mat[double_idx, :]).T
 
     # find the index of the eigenvector that is closest to each target state
     # hence evec_idx has shape of (number of target states, )
@@ -134,3 +100,166 @@ def extract_energies(esys_array: np.ndarray,
             chis[j, i] = chi
 
     return evals[evec_idx_single], chis
+
+
+def _eigenvectors_as_columns(evecs) -> np.ndarray:
+    """Eigenvectors as the columns of an array, from a list of qutip
+    eigenstates or from such an array."""
+    if isinstance(evecs, np.ndarray) and evecs.dtype != object:
+        return evecs
+    return np.column_stack([np.asarray(evec.full()).ravel() for evec in evecs])
+
+
+def _excitation_indices(mode_size: List[int]):
+    """Indices, in the tensor product basis, of the states with one
+    excitation in a mode, and with two excitations in one or two modes.
+
+    Returns:
+        list, list, dict: the indices of the single excitation states, of the
+        double excitation states, and the position in the latter of the state
+        with excitations in modes (i, j)
+    """
+    N = len(mode_size)
+
+    def state_idx(excitations):
+        return int(
+            np.ravel_multi_index([excitations.get(i, 0) for i in range(N)],
+                                 mode_size))
+
+    single_excitation_idx = [state_idx({i: 1}) for i in range(N)]
+
+    # States with 2-photon excitations, either in two separate modes or
+    # the same mode
+    double_excitation_idx = []
+    mode_idx_to_state = {}
+    for i in range(N):
+        for j in range(i, N):
+            d = {k: 0 for k in range(N)}  # put 0 photons in each mode (k)
+            # load ith mode and jth mode with 1 photon
+            d[i] += 1
+            d[j] += 1
+            # mode_idx_to_state keeps track of mode excitation index for each state
+            mode_idx_to_state[(i, j)] = len(double_excitation_idx)
+            double_excitation_idx.append(state_idx(d))
+
+    return single_excitation_idx, double_excitation_idx, mode_idx_to_state
+
+
+def _to_sparse(hamiltonian) -> sparse.csr_matrix:
+    """The matrix of a hamiltonian given as a qutip Qobj, a scipy sparse
+    matrix or an array."""
+    if isinstance(hamiltonian, np.ndarray) or sparse.issparse(hamiltonian):
+        return sparse.csr_matrix(hamiltonian)
+    data = hamiltonian.data
+    if sparse.issparse(data):
+        return data.tocsr()
+    # qutip >= 5 keeps its own data layers
+    return sparse.csr_matrix(hamiltonian.data_as('csr_matrix'))
+
+
+def lowest_eigensystem(
+        hamiltonian,
+        evals_count: int,
+        warm_start: Tuple[np.ndarray, np.ndarray] = None,
+        shift_invert: bool = False) -> Tuple[np.ndarray, np.ndarray]:
+    """
+    Lowest eigenvalues and eigenvectors of a hermitian hamiltonian, found
+    with the sparse Lanczos solver instead of diagonalizing the full matrix.
+
+    Args:
+        hamiltonian (Qobj): the hamiltonian, as a qutip Qobj, a scipy sparse
+            matrix or an array
+        evals_count (int): number of eigenvalues
+        warm_start (Tuple[np.ndarray, np.ndarray], optional): eigenvalues and
+            eigenvectors of a nearby hamiltonian of the same dimension, such as
+            the previous point of a sweep. Its eigenvectors start the Lanczos
+            iteration, and its ground energy places the shift when shift_invert
+            is True. Defaults to None.
+        shift_invert (bool, optional): if true, factorize the hamiltonian
+            shifted just below its ground energy, and find the eigenvalues
+            nearest to the shift. Converges in fewer iterations, at the cost
+            of the memory of the factorization. Defaults to False.
+
+    Returns:
+        np.ndarray, np.ndarray: the eigenvalues in ascending order, and an
+        array whose columns are the corresponding eigenvectors
+    """
+    mat = _to_sparse(hamiltonian)
+    dim = mat.shape[0]
+    evals_count = min(evals_count, dim)
+
+    # the sparse solver needs evals_count < dim - 1
+    if evals_count >= dim - 1:
+        evals, evecs = np.linalg.eigh(mat.toarray())
+        return evals[:evals_count], evecs[:, :evals_count]
+
+    v0 = None
+    ground_energy = None
+    if warm_start is not None and np.shape(warm_start[1])[0] == dim:
+        v0 = np.asarray(warm_start[1]).sum(axis=1)
+        ground_energy = np.min(warm_start[0])
+
+    if shift_invert:
+        if ground_energy is None:
+            ground_energy = eigsh(mat,
+                                  k=1,
+                                  which='SA',
+                                  v0=v0,
+                                  tol=1e-3,
+                                  return_eigenvectors=False)[0]
+        sigma = ground_energy - 1e-2 * max(abs(ground_energy), 1.)
+        evals, evecs = eigsh(mat, k=evals_count, sigma=sigma, which='LM', v0=v0)
+    else:
+        evals, evecs = eigsh(mat, k=evals_count, which='SA', v0=v0)
+
+    order = np.argsort(evals)
+    return evals[order], evecs[:, order]
+
+
+def low_lying_eigensystem(
+        hamiltonian,
+        mode_size: List[int],
+        evals_count: int = None,
+        warm_start: Tuple[np.ndarray, np.ndarray] = None,
+        shift_invert: bool = False) -> Tuple[np.ndarray, np.ndarray]:
+    """
+    The eigenstates that extract_energies needs: enough of the lowest ones to
+    contain the dressed states of the single and double excitations of the
+    modes.
+
+    Starts from evals_count eigenstates, or from twice the number of target
+    states, and doubles the count until each target state has most of its
+    weight in the computed eigenstates.
+
+    Args:
+        hamiltonian (Qobj): the hamiltonian, as a qutip Qobj, a scipy sparse
+            matrix or an array
+        mode_size (List[int]): list of integers specifying number of fock states
+            for each mode, respectively
+        evals_count (int, optional): number of eigenstates to start from.
+            Defaults to None.
+        warm_start (Tuple[np.ndarray, np.ndarray], optional): see
+            lowest_eigensystem. Defaults to None.
+        shift_invert (bool, optional): see lowest_eigensystem. Defaults to False.
+
+    Returns:
+        np.ndarray, np.ndarray: the eigenvalues in ascending order, and an
+        array whose columns are the corresponding eigenvectors
+    """
+    mat = _to_sparse(hamiltonian)
+    dim = mat.shape[0]
+    single_idx, double_idx, _ = _excitation_indices(mode_size)
+    target_idx = single_idx + double_idx
+
+    if evals_count is None:
+        evals_count = 2 * (1 + len(target_idx))
+    evals_count = min(evals_count, dim)
+
+    while True:
+        evals, evecs = lowest_eigensystem(mat, evals_count, warm_start,
+                                          shift_invert)
+        weight = np.sum(np.absolute(evecs[target_idx, :])**2, axis=1)
+        if evals_count == dim or np.all(weight > 0.5):
+            return evals, evecs
+        warm_start = (evals, evecs)
+        evals_count = min(2 * evals_count, dim)
@@ -25,6 +25,10 @@ import qutip as qt
 import scipy.linalg as linalg
 import scipy.optimize as opt
 
+from .charge_dispersion import cpb_levels
+from .charge_dispersion import charge_dispersion as cpb_charge_dispersion
+from .charge_dispersion import params_from_spectrum as spectrum_to_params
+
 
 class Hcpb:
     """Hamiltonian-model Cooper pair box (Hcpb) class.
@@ -188,6 +192,39 @@ class Hcpb:
         """
         return self.fij(1, 2) - self.fij(0, 1)
 
+    def levels_vs_ng(self, ng, num_levels: int = 3):
+        """Compute the lowest energy levels for an array of offset charges,
+        all at once, with the Ej, Ec and nlevels of this CPB.
+
+        Args:
+            ng (np.ndarray): Offset charges, in units of cooper pairs (2e)
+            num_levels (int): Number of levels to return. Defaults to 3.
+
+        Returns:
+            np.ndarray: Energies of shape ng.shape + (num_levels,)
+        """
+        return cpb_levels(self._Ej,
+                          self._Ec,
+                          ng,
+                          nlevels=self._nlevels,
+                          num_levels=num_levels)
+
+    def charge_dispersion(self, num_levels: int = 3):
+        """Compute the peak to peak charge dispersion of the levels, relative
+        to the ground state.
+
+        Args:
+            num_levels (int): Number of levels. Defaults to 3.
+
+        Returns:
+            np.ndarray: Dispersion of each of the num_levels levels, the
+            first one being 0
+        """
+        return cpb_charge_dispersion(self._Ej,
+                                     self._Ec,
+                                     nlevels=self._nlevels,
+                                     num_levels=num_levels).dispersion
+
     def n_ij(self, i: int, j: int):
         """Compute the value of the number operator for coupling elements
         together in the energy eigen-basis.
@@ -257,6 +294,11 @@ class Hcpb:
         fabrication. Updates the class to include these Ej and Ec as the new
         values for extracting properties.
 
+        The solution is read from the cached spectrum table of
+        charge_dispersion.params_from_spectrum, which also inverts whole
+        arrays of targets at once.  least_squares is only used when the
+        target is outside of the table, or when keyword arguments are given.
+
         Args:
             f01 (float): Desired qubit frequency
             anharm (float): Desired qubit anharmonicity (should be negative)
@@ -273,6 +315,11 @@ class Hcpb:
         if anharm > 0:
             anharm = -anharm
 
+        Ej, Ec = spectrum_to_params(f01, anharm, self._ng, self._nlevels)
+        if not kwargs and np.isfinite(Ej):
+            self.Ej, self.Ec = float(Ej), float(Ec)
+            return np.array([self.Ej, self.Ec])
+
         def fun(x):
             self.Ej = x[0]
             self.Ec = x[1]
@@ -287,6 +334,8 @@ class Hcpb:
         ops = dict(bounds=[(0, 0), (x0[0] * 3, x0[1] * 3)],
                    f_scale=1 / x0[0],
                    max_nfev=2000)
+        if np.isfinite(Ej):
+            x0 = [float(Ej), float(Ec)]
         res = opt.least_squares(fun, x0, **{**ops, **kwargs})
         self.Ej, self.Ec = res.x
         return res.x
@@ -40,7 +40,6 @@ import argparse
 import numpy as np
 import pandas as pd
 import scqubits as scq
-from sympy import Matrix
 from scipy import optimize, integrate
 
 from pyEPR.calcs.convert import Convert
@@ -48,7 +47,7 @@ from pyEPR.calcs.constants import e_el as ele, hbar
 
 from qiskit_metal.toolbox_python.utility_functions import get_all_args
 from qiskit_metal.analyses.em.cpw_calculations import guided_wavelength
-from qiskit_metal.analyses.hamiltonian.states_energies import extract_energies
+from qiskit_metal.analyses.hamiltonian.states_energies import extract_energies, low_lying_eigensystem
 from .constants import (MHzRad, GHzRad, NANO, FEMTO, ONE_OVER_FEMTO)
 
 from qiskit_metal import logger
@@ -352,6 +351,34 @@ class LabeledNdarray(np.ndarray):
         return f'{_make_cmat_df(self, self.labels)}'
 
 
+def _single_node_nullspace(mat: np.ndarray) -> np.ndarray:
+    """
+    indices of the basis vectors spanning the nullspace of a symmetric matrix,
+    i.e., of its all-zero columns. Raises ValueError if the nullspace is not
+    spanned by individual basis vectors.
+
+    The zero columns are found structurally, and only the rest of the matrix,
+    which should then be full rank, is decomposed numerically.
+    """
+    mat = np.asarray(mat, dtype=np.float64)
+    dim = mat.shape[0]
+    if dim == 0:
+        return np.zeros(0, dtype=int)
+    tol = np.abs(mat).max() * dim * np.finfo(np.float64).eps
+    is_zero = np.all(np.abs(mat) <= tol, axis=0)
+    nonzero_idx = np.where(~is_zero)[0]
+    reduced = mat[np.ix_(nonzero_idx, nonzero_idx)]
+    if reduced.size and np.linalg.matrix_rank(reduced) < len(nonzero_idx):
+        _, _, vh = np.linalg.svd(reduced)
+        v = np.zeros(dim)
+        v[nonzero_idx] = vh[-1]
+        raise ValueError(
+            f'Nullspace column vector {v} has more than one non-zero element. \
+                             Only individual nodes in the current flux [see self.node_jj_basis] basis can be removed'
+        )
+    return np.where(is_zero)[0]
+
+
 #----------------------------------------------------------------------------------------------------
 
 
@@ -390,6 +417,11 @@ class CircuitGraph:
     units = {'capacitance': 'fF', 'inductance': 'nH'}
     _IGNORE_GRD_NODE = True
 
+    # Results which only depend on the circuit topology, shared by all the
+    # instances; see _topology_key
+    _topology_cache = dict()
+    _MAX_TOPOLOGY_CACHE = 256
+
     def __init__(
         self,
         nodes: Sequence,
@@ -498,18 +530,41 @@ class CircuitGraph:
         """ convert adjacency list representation of capacitance graph to
         a matrix representation
         """
-        idx = self.idx
-        dim = len(idx)
+        dim = len(self.idx)
+        edges = [(n1, n2, w) for n1 in adj_list for n2, w in adj_list[n1]]
+        n1s, n2s, ws = zip(*edges) if edges else ((), (), ())
+        r = self.idx.get_indexer(list(n1s))
+        c = self.idx.get_indexer(list(n2s))
+        ws = np.asarray(ws, dtype=np.float64)
+        off_diag = r != c
         mat = np.zeros((dim, dim))
-        for n1 in adj_list:
-            for n2, w in adj_list[n1]:
-                r = idx.get_indexer([n1])[0]
-                c = idx.get_indexer([n2])[0]
-                mat[r, c] += w
-                if r != c:
-                    mat[c, r] += w
+        np.add.at(mat, (r, c), ws)
+        np.add.at(mat, (c[off_diag], r[off_diag]), ws[off_diag])
         return mat
 
+    def _topology_key(self, *extra) -> tuple:
+        """ key identifying the topology of the circuit: its nodes, its
+        junctions and the pairs of nodes joined by inductors. The values of
+        the capacitances and inductances are not part of it, so the
+        transform to the node-junction basis and the reduction matrices
+        S_remove and S_keep are reused across a sweep of these values.
+        """
+        ind_edges = frozenset(
+            frozenset(pair) for l_dict in self._ind_lists for pair in l_dict)
+        return (tuple(self.nodes), self._grd_node, self.ignore_grd_node,
+                tuple(self._junctions.items()), ind_edges) + extra
+
+    def _cached_by_topology(self, name: str, compute: Callable, *extra):
+        """ result of compute(), computed once per circuit topology
+        """
+        cache = CircuitGraph._topology_cache
+        key = (name,) + self._topology_key(*extra)
+        if key not in cache:
+            if len(cache) >= CircuitGraph._MAX_TOPOLOGY_CACHE:
+                cache.clear()
+            cache[key] = compute()
+        return cache[key]
+
     def _inductance_list_to_Linv_mat(self, ind_dict):
         """ convert inductance list to inductance inverse matrix
         """
@@ -564,13 +619,18 @@ class CircuitGraph:
         .
         $\Phi = S_{n}^{-1}\Phi_n$
         """
-        t = _transform_to_junction_flux_basis(self.nodes,
-                                              self._junctions,
-                                              choose_least_num_neg=True)
-        S_n_inv = _extract_matrix_from_transform(t, self._junctions, self.idx)
-        S_n = np.linalg.inv(S_n_inv)
-        self._node_jj_basis = t.node_jj_basis
-        return S_n
+
+        def compute():
+            t = _transform_to_junction_flux_basis(self.nodes,
+                                                  self._junctions,
+                                                  choose_least_num_neg=True)
+            S_n_inv = _extract_matrix_from_transform(t, self._junctions,
+                                                     self.idx)
+            # A tuple, so the basis shared through the cache can't be changed
+            return np.linalg.inv(S_n_inv), tuple(t.node_jj_basis)
+
+        S_n, self._node_jj_basis = self._cached_by_topology('S_n', compute)
+        return S_n.copy()
 
     @property
     def C(self):
@@ -610,7 +670,7 @@ class CircuitGraph:
         """
         if self._node_jj_basis is None:
             _ = self.S_n
-        _node_jj_basis = self._node_jj_basis
+        _node_jj_basis = list(self._node_jj_basis)
         if self.ignore_grd_node:
             _node_jj_basis = [
                 _node for _node in _node_jj_basis if _node != self._grd_node
@@ -624,9 +684,21 @@ class CircuitGraph:
         in the kernel space of the transformed inverse inductance
         matrix. These are nodes that are only touched by capacitors and are
         considered non-dynamic nodes.
+
+        Computed once per circuit topology, see _topology_key.
         """
         if self._s_remove_provided is not False:
             return self._s_remove_provided
+        nodes_force_keep = tuple(
+            self.nodes_force_keep) if self.nodes_force_keep else ()
+        s_remove = self._cached_by_topology('S_remove', self._compute_s_remove,
+                                            nodes_force_keep)
+        return s_remove.copy() if s_remove is not None else None
+
+    def _compute_s_remove(self):
+        """ S_remove from the nullspace of the transformed inverse
+        inductance matrix
+        """
         nodes_force_keep = self.nodes_force_keep if self.nodes_force_keep else []
         force_keep_idx = pd.Index(
             self.node_jj_basis).get_indexer(nodes_force_keep)
@@ -639,23 +711,13 @@ class CircuitGraph:
             )
 
         L_inv = self.L_inv
-        _s_r = []
-        null_space = Matrix(L_inv).nullspace()
-        for _v in null_space:
-            v = _v / _v.norm()
-            v = np.array(v).astype(np.float64)
-            if np.count_nonzero(v) != 1:
-                raise ValueError(
-                    f'Nullspace column vector {v} has more than one non-zero element. \
-                                 Only individual nodes in the current flux [see self.node_jj_basis] basis can be removed'
-                )
-
-            # if the node to be removed is in the list of nodes that are forced to be kept, don't remove
-            if np.where(force_keep_idx == np.where(v)[0][0])[0].size:
-                continue
-            _s_r.append(v)
+        # if the node to be removed is in the list of nodes that are forced to be kept, don't remove
+        remove_idx = [
+            ii for ii in _single_node_nullspace(L_inv)
+            if ii not in force_keep_idx
+        ]
 
-        return np.concatenate(_s_r, axis=1) if _s_r else None
+        return np.eye(L_inv.shape[0])[:, remove_idx] if remove_idx else None
 
     @property
     def S_keep(self):
@@ -665,6 +727,16 @@ class CircuitGraph:
         # S_remove (which itself is constructed from the identity matrix) and the identity matrix
         if self._s_keep_provided is not False:
             return self._s_keep_provided
+        if self._s_remove_provided is False:
+            nodes_force_keep = tuple(
+                self.nodes_force_keep) if self.nodes_force_keep else ()
+            return self._cached_by_topology('S_keep', self._compute_s_keep,
+                                            nodes_force_keep).copy()
+        return self._compute_s_keep()
+
+    def _compute_s_keep(self):
+        """ S_keep from S_remove
+        """
         S_remove = self.S_remove
         dim = self.L_inv.shape[0]
         eye = np.eye(dim)
@@ -1111,14 +1183,16 @@ class TLResonatorBuilder(QuantumBuilder):
         resonator = scq.Oscillator(**builder_options.view_as(scq.Oscillator))
         subsystem._quantum_system = resonator
 
-        Q_zpf, *_ = analyze_loaded_tl(f_res,
-                                      vp,
-                                      Z0,
-                                      cap_loading=loading_capacitor,
-                                      shorted=builder_options.other_end_shorted)
+        Q_zpf, Phi_zpf, *_ = analyze_loaded_tl(
+            f_res,
+            vp,
+            Z0,
+            cap_loading=loading_capacitor,
+            shorted=builder_options.other_end_shorted)
 
         for node in subsystem.nodes:
             subsystem._h_params[node]['Q_zpf'] = Q_zpf[node]
+            subsystem._h_params[node]['Phi_zpf'] = Phi_zpf[node]
             subsystem._h_params[node]['default_charge_op'] = Operator(
                 1j * (resonator.creation_operator() -
                       resonator.annihilation_operator()), False)
@@ -1184,6 +1258,7 @@ class LumpedResonatorBuilder(QuantumBuilder):
 
         node = subsystem.nodes[0]
         subsystem._h_params[node]['Q_zpf'] = Q_zpf
+        subsystem._h_params[node]['Phi_zpf'] = np.sqrt(hbar * Z / 2)
         subsystem._h_params[node]['default_charge_op'] = Operator(
             1j *
             (resonator.creation_operator() - resonator.annihilation_operator()),
@@ -1310,6 +1385,11 @@ class CompositeSystem:
         self.quantum_subsystems = []
 
         self._cg = None
+        self._nodes_keep_idx = None
+
+        # (eigenvalues, eigenvectors) of the last sparse diagonalization of the
+        # Hamiltonian, see hamiltonian_results
+        self.eigensystem = None
 
     def circuitGraph(self) -> CircuitGraph:
         """create a CircuitGraph object with circuit parameters of the composite system
@@ -1347,16 +1427,27 @@ class CompositeSystem:
         Args:
             node (str): name of the node
         """
-        cg = self.circuitGraph()
-        nodes_keep = cg.get_nodes_keep()
-        reduced_mat_idx = pd.Index(nodes_keep)
+        return self.node_indices([node])[0]
 
-        node_idx = reduced_mat_idx.get_indexer([node])
-        subsystem_idx = node_idx[node_idx >= 0]
+    def node_indices(self, nodes: Sequence[str]) -> np.ndarray:
+        """Obtain the indices of the given nodes in the composite system's
+        reduced capacitance matrix. The index of the reduced basis is built
+        once.
+
+        Args:
+            nodes (Sequence[str]): names of the nodes
+
+        Returns:
+            np.ndarray: indices of the nodes, in the same order
+        """
+        if self._nodes_keep_idx is None:
+            self._nodes_keep_idx = pd.Index(
+                self.circuitGraph().get_nodes_keep())
+        node_idx = self._nodes_keep_idx.get_indexer(list(nodes))
 
-        if subsystem_idx.size == 0:
+        if np.any(node_idx < 0):
             raise ValueError('Subsystem not found in the circuit\'s nodes.')
-        return subsystem_idx[0]
+        return node_idx
 
     def create_hilbertspace(self) -> scq.HilbertSpace:
         """ create the composite hilbertspace including all the subsystems. Interaction
@@ -1389,38 +1480,44 @@ class CompositeSystem:
 
         Note: the resulting matrix is in the basis of nodes_keep, which may not be in the same order of
         subsystems
+
+        The capacitive g's are C^{-1}_{k} times the outer product of the Q_zpf's of the
+        subsystem nodes, and the inductive g's are L^{-1}_{k} times the outer product
+        of their Phi_zpf's
         """
         cg = self.circuitGraph()
         nodes = cg.get_nodes_keep()
 
         if coupling_type == CouplingType.CAPACITIVE:
-            c_inv_k = cg.C_inv_k
-            g = np.zeros_like(c_inv_k)
-            for ii in range(self.num_subsystems):
-                sub1 = self._subsystems[ii]
-                sub1_nodes = sub1.nodes
-                for jj in range(ii, self.num_subsystems):
-                    sub2 = self._subsystems[jj]
-                    sub2_nodes = sub2.nodes
-                    for node1 in sub1_nodes:
-                        for node2 in sub2_nodes:
-                            if node1 == node2:
-                                continue
-                            idx1 = self.node_index(node1)
-                            idx2 = self.node_index(node2)
-                            c_i = c_inv_k[idx1, idx2]
-                            if c_i == 0:
-                                continue
-                            Q_zpf_1 = sub1.h_params[node1]['Q_zpf']
-                            Q_zpf_2 = sub2.h_params[node2]['Q_zpf']
-                            g[idx1, idx2] = c_i * Q_zpf_1 * Q_zpf_2 * \
-                                            ONE_OVER_FEMTO / hbar / MHzRad
-                            g[idx2, idx1] = g[idx1, idx2]
-
-            return LabeledNdarray(g, nodes)
+            k_mat, zpf_name, unit = cg.C_inv_k, 'Q_zpf', ONE_OVER_FEMTO
+        elif coupling_type == CouplingType.INDUCTIVE:
+            k_mat, zpf_name, unit = cg.L_inv_k, 'Phi_zpf', 1 / NANO
         else:
             raise NotImplementedError
 
+        sub_nodes = [(sub, n) for sub in self._subsystems for n in sub.nodes]
+        idx = self.node_indices([n for _, n in sub_nodes])
+
+        # couplings between the different subsystem nodes
+        k_sub = np.array(k_mat[np.ix_(idx, idx)], dtype=np.float64)
+        np.fill_diagonal(k_sub, 0)
+        coupled = k_sub != 0
+
+        zpf = np.zeros(len(sub_nodes))
+        for ii in np.where(coupled.any(axis=0))[0]:
+            sub, node = sub_nodes[ii]
+            if zpf_name not in sub.h_params[node]:
+                raise ValueError(
+                    f'{zpf_name} of node {node} is needed for the coupling '
+                    'but has not been calculated.')
+            zpf[ii] = sub.h_params[node][zpf_name]
+
+        g = np.zeros(k_mat.shape)
+        g[np.ix_(idx, idx)] = k_sub * np.outer(zpf, zpf) * \
+                              unit / hbar / MHzRad
+
+        return LabeledNdarray(g, nodes)
+
     def add_interaction(self,
                         gs: np.ndarray = None,
                         gscale: float = 1.) -> scq.HilbertSpace:
@@ -1451,6 +1548,9 @@ class CompositeSystem:
                 'The dimension of g matrix doesn\'t match that of the reduced capacitance matrix.'
             )
 
+        sub_nodes = [n for sub in self._subsystems for n in sub.nodes]
+        node_idx = dict(zip(sub_nodes, self.node_indices(sub_nodes)))
+
         for ii in range(self.num_subsystems):
             sub1 = self._subsystems[ii]
             sub1_nodes = sub1.nodes
@@ -1462,8 +1562,8 @@ class CompositeSystem:
                         if node1 == node2:
                             continue
 
-                        idx1 = self.node_index(node1)
-                        idx2 = self.node_index(node2)
+                        idx1 = node_idx[node1]
+                        idx2 = node_idx[node2]
 
                         g = gs[idx1, idx2]
                         if g == 0:
@@ -1488,18 +1588,34 @@ class CompositeSystem:
                                               add_hc=add_hc1 or add_hc2)
         return h
 
-    def hamiltonian_results(self,
-                            hilbertspace: scq.HilbertSpace,
-                            evals_count=None,
-                            print_info=True) -> pd.DataFrame:
+    def hamiltonian_results(
+            self,
+            hilbertspace: scq.HilbertSpace,
+            evals_count=None,
+            print_info=True,
+            sparse: bool = False,
+            shift_invert: bool = False,
+            warm_start: Tuple[np.ndarray, np.ndarray] = None) -> pd.DataFrame:
         """Print and return results
 
         Args:
             hilbertspace (scq.HilbertSpace): Hilbertspace object for the Hamiltonian
                 of the composite system
             evals_count (int, optional): Number of eigenenergy levels to keep
-                after diagonalizing the Hamiltonian. Defaults to 10.
+                after diagonalizing the Hamiltonian. Defaults to all of them, or
+                when sparse is True, to as many as needed for the frequencies
+                and the chi matrix.
             print_info (bool, optional): If true, print results as well. Defaults to True.
+            sparse (bool, optional): If true, only compute the low-lying eigenstates
+                with the sparse Lanczos solver, instead of the full spectrum of the
+                dense Hamiltonian. Defaults to False.
+            shift_invert (bool, optional): If true and sparse is True, use the
+                shift-invert mode of the sparse solver. Defaults to False.
+            warm_start (Tuple[np.ndarray, np.ndarray], optional): eigenvalues and
+                eigenvectors to start the sparse solver from, usually the
+                `eigensystem` of the CompositeSystem of the previous point of a
+                sweep. Defaults to None, for the eigensystem previously computed by
+                this object, if any.
 
         Returns:
             pd.DataFrame: dataframe containing the results
@@ -1508,11 +1624,20 @@ class CompositeSystem:
 
         names = self.names
 
-        if evals_count is None:
-            evals_count = hilbertspace.dimension
-
         hamiltonian_mat = hilbertspace.hamiltonian()
-        evals, evecs = hamiltonian_mat.eigenstates(eigvals=evals_count)
+        if sparse:
+            if warm_start is None:
+                warm_start = self.eigensystem
+            evals, evecs = low_lying_eigensystem(hamiltonian_mat,
+                                                 hamiltonian_mat.dims[0],
+                                                 evals_count=evals_count,
+                                                 warm_start=warm_start,
+                                                 shift_invert=shift_invert)
+            self.eigensystem = (evals.copy(), evecs)
+        else:
+            if evals_count is None:
+                evals_count = hilbertspace.dimension
+            evals, evecs = hamiltonian_mat.eigenstates(eigvals=evals_count)
 
         # evals, evecs = hilbertspace.eigensys(evals_count=evals_count)
         esys_array = np.empty(shape=(2,), dtype=object)
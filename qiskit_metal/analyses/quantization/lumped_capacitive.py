@@ -29,18 +29,20 @@ import matplotlib.pyplot as plt
 import numpy as np
 import pandas as pd
 import scipy.optimize as opt
-from pint import UnitRegistry
 
 from pyEPR.calcs.convert import Convert
+from qiskit_metal.toolbox_metal.parsing import UREG
+from ..hamiltonian.charge_dispersion import tridiagonal_lowest_eigvals
 from .constants import (e, h, hbar, phinot, phi0)
 
 __all__ = [
     'Ic_from_Lj', 'Ic_from_Ej', 'Cs_from_Ec', 'transmon_props', 'chi',
-    'extract_transmon_coupled_Noscillator', 'levels_vs_ng_real_units',
-    'get_C_and_Ic', 'cos_to_mega_and_delta', 'chargeline_T1',
-    'readin_q3d_matrix', 'readin_q3d_matrix_m', 'load_q3d_capacitance_matrix',
-    'df_cmat_style_print', 'move_index_to', 'df_reorder_matrix_basis',
-    'lumped_oscillator_from_path'
+    'extract_transmon_coupled_Noscillator',
+    'extract_transmon_coupled_Noscillator_batch', 'levels_vs_ng_real_units',
+    'levels_vs_ng_real_units_batch', 'get_C_and_Ic', 'cos_to_mega_and_delta',
+    'chargeline_T1', 'readin_q3d_matrix', 'readin_q3d_matrix_m',
+    'load_q3d_capacitance_matrix', 'df_cmat_style_print', 'move_index_to',
+    'df_reorder_matrix_basis', 'lumped_oscillator_from_path'
 ]
 
 
@@ -145,6 +147,128 @@ def chi(g: float, wr: float, w01: float, w12: float):
     return (chibus_1 - chibus_0) / 2  # Koch Eq. (3.9)
 
 
+def _coupled_resonators(N: int, fb: Union[List[float], float], fr: float,
+                        res_L4_corr: list):
+    """Angular frequency, capacitance and inductance of the N resonators
+    coupled to the qubit, ordered as [readout, bus1, ...]."""
+    # make list of angular frequencies of resonators
+    wr = np.zeros(N)  # angular freq of resonators (GHz-rad)
+    for ii in range(N):
+        if ii == 0:  # readout resonator
+            wr[ii] = 2 * np.pi * fr * 1e9
+        else:
+            if isinstance(fb, (int, float)):  # just a single one
+                wr[ii] = 2 * np.pi * fb * 1e9
+            else:
+                wr[ii] = 2 * np.pi * fb[ii - 1] * 1e9  # offset index by
+
+    ########################################################
+    #### Transmission line properties
+
+    # Initial values
+    Zbus = 50
+    Cr = 0.5 * np.pi / (wr * Zbus)
+    Lr = 1 / wr**2 / Cr
+
+    # L/4 resonators have an effective capacitance that is
+    # half the L/2 case (and likewise the Lr is twice) at the
+    # same resonance frequency
+    # DCM (I think from numerics)
+    if not res_L4_corr is None:
+        for i in range(len(res_L4_corr)):
+            if res_L4_corr[i]:
+                Cr[i] /= 2.0
+                Lr[i] *= 2.0
+
+    return wr, Cr, Lr
+
+
+def _capacitance_matrix_indices(N: int, size: int):
+    """Index of the ground, the two qubit pads and the N coupling pads in a
+    capacitance matrix ordered as bus1...busN-1, ground, Qubit_pad1,
+    Qubit_pad2, readout."""
+    ground_index = max([0, N - 1])
+    qubit_index = [ground_index + 1, ground_index + 2]
+    bus_index = np.zeros(N, dtype=int)
+    for ii in range(N):
+        if ii == 0:
+            bus_index[ii] = size - 1
+        else:
+            bus_index[ii] = ii - 1
+    return ground_index, qubit_index, bus_index
+
+
+def _print_transmon_coupled_Noscillator(ham_dict: dict, qubit_index: list,
+                                        bus_index: np.ndarray, EJ: float,
+                                        Cq: float, wr: np.ndarray, wq: float,
+                                        gqbus: np.ndarray, tCqbus: np.ndarray,
+                                        tCqbusbus: np.ndarray,
+                                        tCSbus: np.ndarray):
+    """Print the transmon and coupling properties of one capacitance matrix,
+    for extract_transmon_coupled_Noscillator and its batch version."""
+    N = len(wr)
+
+    # g's between pads
+    gbusbus = np.zeros([N, N])
+    for ii in range(N):
+        for jj in range(N):
+            gbusbus[ii,
+                    jj] = (0.01) * tCqbusbus[ii, jj] / (tCSbus[ii] * tCSbus[jj])
+
+    ########################################################
+    ##### Purcell, Qs, dissipative
+
+    # guesses for the Q's
+    Qreadout = 1e4
+    Qcouplingbus = 1e5
+    Qbus = np.zeros(N)
+    for ii in range(N):
+        if ii == 0:
+            Qbus[ii] = Qreadout
+        else:
+            Qbus[ii] = Qcouplingbus
+
+    # loss tangent
+    kbus = wr / Qbus
+
+    # purcell due to each coupling bus
+    T1bus = (wr**2 - wq**2)**2 / (4 * kbus * gqbus**2 * wq**2)
+
+    # total T1
+    if N > 0:
+        T1 = 1 / (np.sum(1 / T1bus))
+    else:
+        T1 = 100
+
+    print(qubit_index, bus_index)
+    print('Predicted Values')
+    print('')
+    print('Transmon Properties')
+    print('f_Q %f [GHz]' % ham_dict['fQ'])
+    print('EC %f [MHz]' % ham_dict['EC'])
+    print('EJ %f [GHz]' % ham_dict['EJ'])
+    print('alpha %f [MHz]' % ham_dict['alpha'])
+    print('dispersion %f [KHz]' % ham_dict['dispersion'])
+    print('Lq %f [nH]' % (phi0**2 / (hbar * EJ) / 1e-9))
+    print('Cq %f [fF]' % (Cq / 1e-15))
+    print('T1 %f [us]' % (T1 / (1e-6)))
+    print('')
+
+    print('**Coupling Properties**')
+    for ii in range(N):
+        print('\ntCqbus%d %f [fF]' % (ii + 1, tCqbus[ii] / (1e-15)))
+        print('gbus%d_in_MHz %f [MHz]' % (ii + 1, ham_dict['gbus'][ii]))
+        print('χ_bus%d %f [MHz]' % (ii + 1, ham_dict['chi_in_MHz'][ii]))
+        print('1/T1bus%d %f [Hz]' % (ii + 1, 1 / T1bus[ii] / (2 * np.pi)))
+        print('T1bus%d %f [us]' % (ii + 1, T1bus[ii] / (1e-6)))
+
+    print('Bus-Bus Couplings')
+    for ii in range(N):
+        for jj in range(ii + 1, N):
+            print('gbus%d_%d %f [MHz]' % (ii + 1, jj + 1, gbusbus[ii, jj] /
+                                          (2 * np.pi * 1e6)))
+
+
 def extract_transmon_coupled_Noscillator(capMatrix,
                                          Ic: float,
                                          CJ: float,
@@ -197,46 +321,13 @@ def extract_transmon_coupled_Noscillator(capMatrix,
     if len(capMatrix) != (N + 3):
         raise ValueError('Capacitance matrix is not the right size')
 
-    # make list of angular frequencies of resonators
-    wr = np.zeros(N)  # angular freq of resonators (GHz-rad)
-    for ii in range(N):
-        if ii == 0:  # readout resonator
-            wr[ii] = 2 * np.pi * fr * 1e9
-        else:
-            if isinstance(fb, (int, float)):  # just a single one
-                wr[ii] = 2 * np.pi * fb * 1e9
-            else:
-                wr[ii] = 2 * np.pi * fb[ii - 1] * 1e9  # offset index by
-
-    ########################################################
-    #### Transmission line properties
-
-    # Initial values
-    Zbus = 50
-    Cr = 0.5 * np.pi / (wr * Zbus)
-    Lr = 1 / wr**2 / Cr
-
-    # L/4 resonators have an effective capacitance that is
-    # half the L/2 case (and likewise the Lr is twice) at the
-    # same resonance frequency
-    # DCM (I think from numerics)
-    if not res_L4_corr is None:
-        for i in range(len(res_L4_corr)):
-            if res_L4_corr[i]:
-                Cr[i] /= 2.0
-                Lr[i] *= 2.0
+    wr, Cr, Lr = _coupled_resonators(N, fb, fr, res_L4_corr)
 
     ########################################################
     # Capacitance matrix parsing
 
-    ground_index = max([0, N - 1])
-    qubit_index = [ground_index + 1, ground_index + 2]
-    bus_index = np.zeros(N, dtype=int)
-    for ii in range(N):
-        if ii == 0:
-            bus_index[ii] = len(capMatrix) - 1
-        else:
-            bus_index[ii] = ii - 1
+    ground_index, qubit_index, bus_index = _capacitance_matrix_indices(
+        N, len(capMatrix))
 
     # Cg list of qubit pads to ground
     Cg = [
@@ -337,38 +428,6 @@ def extract_transmon_coupled_Noscillator(capMatrix,
     #gbus = bbus*wr*np.sqrt(Zbus)*e*(EJ/8/EC)**(1/4)/np.sqrt(hbar)
     gbus_in_MHz = gqbus / 1e6 / 2 / np.pi
 
-    # g's between pads
-    gbusbus = np.zeros([N, N])
-    for ii in range(N):
-        for jj in range(N):
-            gbusbus[ii,
-                    jj] = (0.01) * tCqbusbus[ii, jj] / (tCSbus[ii] * tCSbus[jj])
-
-    ########################################################
-    ##### Purcell, Qs, dissipative
-
-    # guesses for the Q's
-    Qreadout = 1e4
-    Qcouplingbus = 1e5
-    Qbus = np.zeros(N)
-    for ii in range(N):
-        if ii == 0:
-            Qbus[ii] = Qreadout
-        else:
-            Qbus[ii] = Qcouplingbus
-
-    # loss tangent
-    kbus = wr / Qbus
-
-    # purcell due to each coupling bus
-    T1bus = (wr**2 - wq**2)**2 / (4 * kbus * gqbus**2 * wq**2)
-
-    # total T1
-    if N > 0:
-        T1 = 1 / (np.sum(1 / T1bus))
-    else:
-        T1 = 100
-
     ########################################################
     ##### Transmon properties and final summary
 
@@ -390,37 +449,138 @@ def extract_transmon_coupled_Noscillator(capMatrix,
     ham_dict['chi_in_MHz'] = Chi_in_MHz
 
     if print_info:
-        print(qubit_index, bus_index)
-        print('Predicted Values')
-        print('')
-        print('Transmon Properties')
-        print('f_Q %f [GHz]' % ham_dict['fQ'])
-        print('EC %f [MHz]' % ham_dict['EC'])
-        print('EJ %f [GHz]' % ham_dict['EJ'])
-        print('alpha %f [MHz]' % ham_dict['alpha'])
-        print('dispersion %f [KHz]' % ham_dict['dispersion'])
-        print('Lq %f [nH]' % (phi0**2 / (hbar * EJ) / 1e-9))
-        print('Cq %f [fF]' % (Cq / 1e-15))
-        print('T1 %f [us]' % (T1 / (1e-6)))
-        print('')
-
-        print('**Coupling Properties**')
-        for ii in range(N):
-            print('\ntCqbus%d %f [fF]' % (ii + 1, tCqbus[ii] / (1e-15)))
-            print('gbus%d_in_MHz %f [MHz]' % (ii + 1, ham_dict['gbus'][ii]))
-            print('χ_bus%d %f [MHz]' % (ii + 1, Chi_in_MHz[ii]))
-            print('1/T1bus%d %f [Hz]' % (ii + 1, 1 / T1bus[ii] / (2 * np.pi)))
-            print('T1bus%d %f [us]' % (ii + 1, T1bus[ii] / (1e-6)))
-
-        print('Bus-Bus Couplings')
-        for ii in range(N):
-            for jj in range(ii + 1, N):
-                print('gbus%d_%d %f [MHz]' % (ii + 1, jj + 1, gbusbus[ii, jj] /
-                                              (2 * np.pi * 1e6)))
+        _print_transmon_coupled_Noscillator(ham_dict, qubit_index, bus_index,
+                                            EJ, Cq, wr, wq, gqbus, tCqbus,
+                                            tCqbusbus, tCSbus)
 
     return ham_dict
 
 
+def extract_transmon_coupled_Noscillator_batch(
+        capMatrices,
+        Ic: float,
+        CJ: float,
+        N: int,
+        fb: List[float],
+        fr: float,
+        res_L4_corr: float = None,
+        g_scale: float = 1.0,
+        index: list = None,
+        ng_points: int = 51,
+        print_info: bool = False) -> pd.DataFrame:
+    """Vectorized extract_transmon_coupled_Noscillator for a stack of
+    capacitance matrices, e.g. every convergence pass of a simulation or the
+    final matrix of every point of a sweep.
+
+    All the matrices are handled at once with numpy array operations, and the
+    transmon levels of all of them are found with a single call to
+    levels_vs_ng_real_units_batch.
+
+    Args:
+        capMatrices (Union[np.ndarray, dict, list]): Array of shape
+          (num_matrices, N + 3, N + 3), or a dict or list of such matrices.
+          Order and units as in extract_transmon_coupled_Noscillator. (in F)
+        Ic (float): Junction Ic (in A)
+        CJ (float): Junction capacitance (in F)
+        N (int): Coupling pads (1 readout, N-1 bus)
+        fb (float): Coupling bus frequencies (in GHz).
+        fr (float): Coupling readout frequency (in GHz).
+        res_L4_corr (list): Correction factor is the resonators are L/4.
+          Defaults to None.
+        g_scale (float): Scale factor. Defaults to 1.
+        index (list): Label of each matrix, used as index of the result.
+          Defaults to None, which uses the keys of a dict or 0, 1, ...
+        ng_points (int): Number of charge offsets in the numerical transmon
+          levels. Defaults to 51, as extract_transmon_coupled_Noscillator.
+        print_info (bool): Print the transmon and coupling properties of the
+          last matrix, as extract_transmon_coupled_Noscillator does.
+          Defaults to False.
+
+    Returns:
+        pd.DataFrame: One row per matrix, with the keys of the `ham_dict` of
+        extract_transmon_coupled_Noscillator as columns.
+
+    Raises:
+        ValueError: If N is not positive
+        ValueError: If the capacitance matrices are the wrong size
+    """
+    if isinstance(capMatrices, dict):
+        if index is None:
+            index = list(capMatrices.keys())
+        capMatrices = list(capMatrices.values())
+    C = np.asarray(capMatrices, dtype=float)
+    if C.ndim == 2:
+        C = C[np.newaxis]
+
+    # Error checks
+    if N < 0:
+        raise ValueError('N must positive')
+    if C.shape[1:] != (N + 3, N + 3):
+        raise ValueError('Capacitance matrix is not the right size')
+
+    wr, Cr, Lr = _coupled_resonators(N, fb, fr, res_L4_corr)
+    ground_index, qubit_index, bus_index = _capacitance_matrix_indices(
+        N, C.shape[1])
+    qubit_index = np.array(qubit_index)
+
+    # Shapes: (matrices,), (matrices, 2), (matrices, 2, N), (matrices, N, N)
+    Cg = -C[:, qubit_index, ground_index]
+    Cs = -C[:, qubit_index[0], qubit_index[1]]
+    Cbus = -C[:, qubit_index[:, None], bus_index[None, :]]
+    Cbusbus = -C[:, bus_index[:, None], bus_index[None, :]]
+    Cbusbus[:, np.arange(N), np.arange(N)] = 0
+
+    C1S = Cg[:, 0] + np.sum(Cbus[:, 0], axis=-1)
+    C2S = Cg[:, 1] + np.sum(Cbus[:, 1], axis=-1)
+    C12S = (C1S + C2S)[:, None]
+
+    tCSq = Cs + C1S * C2S / (C1S + C2S)
+    tCSbus = Cr - (Cbus[:, 0] + Cbus[:, 1])**2 / C12S + np.sum(
+        Cbus, axis=1) + np.sum(Cbusbus, axis=-1)
+    bbus = (C2S[:, None] * Cbus[:, 0] - Cbus[:, 1] * C1S[:, None]) / (
+        (C1S + C2S) * Cs + C1S * C2S)[:, None]
+
+    Cq = tCSq + CJ
+    _, EJ, Zqp, EC, _, _, _ = transmon_props(Ic, Cq)
+
+    fq, alpha, disp, _ = levels_vs_ng_real_units_batch(Cq / 1e-15,
+                                                       Ic / 1e-9,
+                                                       N=ng_points)
+    wq = 2 * np.pi * fq * 1e9
+
+    Zbus = np.sqrt(Lr / tCSbus)
+    gqbus = 0.5 * wr * bbus * np.sqrt(Zbus / Zqp[:, None]) * g_scale
+    d = alpha * 2 * np.pi * 1e6
+    Chi_in_MHz = 2 * chi(gqbus, wr, wq[:, None],
+                         (d + wq)[:, None]) / 2 / np.pi / 1e6
+
+    ham = pd.DataFrame(
+        {
+            'fQ': wq / 2 / np.pi / 1E9,
+            'EC': EC / 2 / np.pi / 1E6,
+            'EJ': EJ / 2 / np.pi / 1E9,
+            'alpha': alpha,
+            'dispersion': disp / 1e3,
+            'gbus': list(gqbus / 1e6 / 2 / np.pi),
+            'chi_in_MHz': list(Chi_in_MHz)
+        },
+        index=index)
+
+    if print_info:
+        C1S_last, C2S_last, Cbus_last = C1S[-1], C2S[-1], Cbus[-1]
+        tCqbus = (C2S_last * Cbus_last[0] -
+                  Cbus_last[1] * C1S_last) / (C1S_last + C2S_last)
+        Cbus_sum = Cbus_last[0] + Cbus_last[1]
+        tCqbusbus = Cbusbus[-1] + np.outer(Cbus_sum,
+                                           Cbus_sum) / (C1S_last + C2S_last)
+        _print_transmon_coupled_Noscillator(ham.iloc[-1].to_dict(),
+                                            qubit_index.tolist(), bus_index,
+                                            EJ[-1], Cq[-1], wr, wq[-1],
+                                            gqbus[-1], tCqbus, tCqbusbus,
+                                            tCSbus[-1])
+    return ham
+
+
 def levels_vs_ng_real_units(Cq, IC, N=301, do_disp=0, do_plots=0):
     """This numerically computes the exact transmon levels given C and IC as a
     function of the ng ration -- it subtracts the vacuum flucations so that
@@ -437,44 +597,24 @@ def levels_vs_ng_real_units(Cq, IC, N=301, do_disp=0, do_plots=0):
         tuple: fqubitGHz, anharMHz, disp, tphi_ms
 
     Raises:
-        ValueError: If the matrix is not Hermitian
+        ValueError: If N is negative
     """
     C = Cq * 1e-15
     IC = IC * 1e-9
     Ec = e**2 / 2 / C
 
     nmax = 40
-    dim = 2 * nmax + 1
-    nmat = np.zeros([dim, dim])
-    V = nmat
     charge = np.linspace(-1., 1., N)
-
-    # KE
-    for ii in range(dim):
-        nmat[ii, ii] = ii - nmax
-
-    # PE
-    V = np.diag(-0.5 * np.ones([dim - 1]), 1)
-    V = (V + np.transpose(np.conj(V)))
+    n = np.arange(-nmax, nmax + 1)
 
     varphi = hbar / 2 / e
     EJ = IC * varphi
 
-    elvls = np.zeros([dim, N])
-
-    for iindex in range(N):
-        ng = charge[iindex]
-
-        H = 4 * Ec * (nmat - ng * np.eye(dim))**2 + EJ * V
-
-        if (not np.array_equal(H, np.transpose(np.conj(H)))):
-            raise ValueError('Matrix is not Hermitian')
-
-        [d, v] = np.linalg.eig(H)
-        sortIX = np.argsort(d)
-        sorted_d = d[sortIX]
-
-        elvls[:, iindex] = (sorted_d - sorted_d[0])
+    # The Hamiltonians of all the charges are tridiagonal, so solve them
+    # together, and only for the 4 levels which are used
+    diag = 4 * Ec * (n[None, :] - charge[:, None])**2
+    levels = tridiagonal_lowest_eigvals(diag, -0.5 * EJ * np.ones(2 * nmax), 4)
+    elvls = (levels - levels[:, :1]).T
 
     if do_plots:
 
@@ -563,6 +703,51 @@ def levels_vs_ng_real_units(Cq, IC, N=301, do_disp=0, do_plots=0):
     return fqubitGHz, anharMHz, disp, tphi_ms
 
 
+def levels_vs_ng_real_units_batch(Cq, IC, N=301):
+    """Vectorized levels_vs_ng_real_units, without the prints and plots, for
+    arrays of capacitances and critical currents.
+
+    Args:
+        Cq (np.ndarray): In fF
+        IC (np.ndarray): In nA. Broadcast against Cq.
+        N (int): Number of charge values to use (needs to be odd)
+
+    Returns:
+        tuple: fqubitGHz, anharMHz, disp, tphi_ms; each an array with the
+        broadcast shape of Cq and IC.
+
+    Raises:
+        ValueError: If N is not positive
+    """
+    if N < 1:
+        raise ValueError('N must be positive')
+    C, IC = np.broadcast_arrays(
+        np.asarray(Cq, dtype=float) * 1e-15,
+        np.asarray(IC, dtype=float) * 1e-9)
+    shape = C.shape
+    Ec = (e**2 / 2 / C).ravel()
+    EJ = (IC * hbar / 2 / e).ravel()
+
+    nmax = 40
+    charge = np.linspace(-1., 1., N)
+    n = np.arange(-nmax, nmax + 1)
+
+    # Tridiagonal Hamiltonians of shape (designs, charges, 2 * nmax + 1)
+    diag = 4 * Ec[:, None, None] * (n[None, None, :] - charge[None, :, None])**2
+    off = -0.5 * EJ[:, None, None] * np.ones(2 * nmax)
+    levels = tridiagonal_lowest_eigvals(diag, off, 3)
+    elvls = levels - levels[..., :1]
+
+    fqubitGHz = np.mean(elvls[..., 1] / h / 1e9, axis=-1)
+    anharMHz = np.mean(1000 * (elvls[..., 2] - 2 * elvls[..., 1]) / h / 1e9,
+                       axis=-1)
+    disp = np.max(-elvls[..., 1] / h + elvls[..., :1, 1] / h, axis=-1)
+    tphi_ms = 2 / (2 * np.pi * disp * np.pi * 1e-4 * 1e-3)
+
+    return (fqubitGHz.reshape(shape), anharMHz.reshape(shape),
+            disp.reshape(shape), tphi_ms.reshape(shape))
+
+
 def get_C_and_Ic(Cin_est, Icin_est, f01, f02on2):
     """Get the capacitance and critical current for a transmon of a certain
     frequency and anharmonicity.
@@ -754,8 +939,7 @@ def load_q3d_capacitance_matrix(path, user_units='fF', _disp=True):
     df_cmat, Cunits, design_variation, df_cond = readin_q3d_matrix(path)
 
     # Unit convert
-    ureg = UnitRegistry()
-    q = ureg.parse_expression(Cunits).to(user_units)
+    q = UREG.parse_expression(Cunits).to(user_units)
     df_cmat = df_cmat * q.magnitude  # scale to user units
 
     # Report
@@ -789,14 +973,13 @@ def lumped_oscillator_from_path(path: str, Lj_nH: float, Cj_fF: float, N: int,
     Returns:
         dict: A single dataframe corresponding to a single capacitance matrix
     """
-    ureg = UnitRegistry()
     IC_Amps = Convert.Ic_from_Lj(Lj_nH, 'nH', 'A')
-    CJ = ureg(f'{Cj_fF} fF').to('farad').magnitude
-    fr = ureg(f'{fr} GHz').to('GHz').magnitude
-    fb = [ureg(f'{freq} GHz').to('GHz').magnitude for freq in fb]
+    CJ = UREG(f'{Cj_fF} fF').to('farad').magnitude
+    fr = UREG(f'{fr} GHz').to('GHz').magnitude
+    fb = [UREG(f'{freq} GHz').to('GHz').magnitude for freq in fb]
 
     df_cmat, user_units, _, _, = load_q3d_capacitance_matrix(path)
-    c_units = ureg(user_units).to('farads').magnitude
+    c_units = UREG(user_units).to('farads').magnitude
 
     RES = extract_transmon_coupled_Noscillator(df_cmat.values * c_units,
                                                IC_Amps,
@@ -12,18 +12,19 @@
 # copyright notice, and modified files need to carry a notice indicating
 # that they have been altered from the originals.
 
+import numpy as np
 import pandas as pd
-from pint import UnitRegistry
 
 from pyEPR.calcs.convert import Convert
 
 from qiskit_metal.designs import QDesign  # pylint: disable=unused-import
 from qiskit_metal.analyses.core import QAnalysis
 from qiskit_metal.analyses.simulation import LumpedElementsSim
+from qiskit_metal.toolbox_metal.parsing import UREG
 from qiskit_metal import Dict, config
 
 if not config.is_building_docs():
-    from .lumped_capacitive import extract_transmon_coupled_Noscillator
+    from .lumped_capacitive import extract_transmon_coupled_Noscillator_batch
 
 
 # TODO: eliminate every reference to "renderer" in this file
@@ -140,8 +141,6 @@ class LOManalysis(QAnalysis):
         # wipe data from the previous run (if any)
         self.clear_data()
 
-        s = self.setup
-
         if not isinstance(self.sim.capacitance_matrix, pd.DataFrame):
             if self.sim.capacitance_matrix == {}:
                 self.logger.warning(
@@ -152,11 +151,37 @@ class LOManalysis(QAnalysis):
                 self.sim.capacitance_all_passes[
                     1] = self.sim.capacitance_matrix.values
 
-        ureg = UnitRegistry()
+        ic_amps, cj, num_cpads, fbus, fread = self._lom_inputs()
+
+        # get the LOM for every pass, all at once, and print the details of
+        # the last pass only
+        all_res = extract_transmon_coupled_Noscillator_batch(
+            self.sim.capacitance_all_passes,
+            ic_amps,
+            cj,
+            num_cpads,
+            fbus,
+            fread,
+            g_scale=1,
+            print_info=True)
+        self.lumped_oscillator = all_res.iloc[-1].to_dict()
+        all_res['χr MHz'] = abs(all_res['chi_in_MHz'].apply(lambda x: x[0]))
+        all_res['gr MHz'] = abs(all_res['gbus'].apply(lambda x: x[0]))
+        self.lumped_oscillator_all = all_res
+        return self.lumped_oscillator_all
+
+    def _lom_inputs(self):
+        """Junction and resonator parameters from the setup, in the units
+        expected by extract_transmon_coupled_Noscillator.
+
+        Returns:
+            tuple: ic_amps, cj, num_cpads, fbus, fread
+        """
+        s = self.setup
         ic_amps = Convert.Ic_from_Lj(s.junctions.Lj, 'nH', 'A')
-        cj = ureg(f'{s.junctions.Cj} fF').to('farad').magnitude
-        fread = ureg(f'{s.freq_readout} GHz').to('GHz').magnitude
-        fbus = [ureg(f'{freq} GHz').to('GHz').magnitude for freq in s.freq_bus]
+        cj = UREG(f'{s.junctions.Cj} fF').to('farad').magnitude
+        fread = UREG(f'{s.freq_readout} GHz').to('GHz').magnitude
+        fbus = [UREG(f'{freq} GHz').to('GHz').magnitude for freq in s.freq_bus]
 
         # derive number of coupling pads
         num_cpads = 2
@@ -165,26 +190,46 @@ class LOManalysis(QAnalysis):
         if isinstance(fbus, list):
             num_cpads += len(fbus) - 1
 
-        # get the LOM for every pass
-        all_res = {}
-        for idx_cmat, df_cmat in self.sim.capacitance_all_passes.items():
-            res = extract_transmon_coupled_Noscillator(
-                df_cmat,
-                ic_amps,
-                cj,
-                num_cpads,
-                fbus,
-                fread,
-                g_scale=1,
-                print_info=bool(
-                    idx_cmat == len(self.sim.capacitance_all_passes)))
-            all_res[idx_cmat] = res
-        self.lumped_oscillator = all_res[len(self.sim.capacitance_all_passes)]
-        all_res = pd.DataFrame(all_res).transpose()
+        return ic_amps, cj, num_cpads, fbus, fread
+
+    def run_lom_on_sweep(self, all_sweep: dict) -> pd.DataFrame:
+        """Executes the lumped oscillator extraction, with the current setup,
+        for the last pass of every point of a sweep, in one vectorized call.
+
+        Args:
+            all_sweep (dict): Result of run_sweep, run_sweep_parallel or
+                run_multi_sweep of this analysis. Each point needs the
+                'cap_all_passes' of the simulation in its 'sim_variables'.
+
+        Returns:
+            pd.DataFrame: Each line corresponds to a point of the sweep
+                and the remainder of the data is the respective lump
+                oscillator information.
+        """
+        ic_amps, cj, num_cpads, fbus, fread = self._lom_inputs()
+
+        index = list()
+        cap_matrices = list()
+        for item, sweep_values in all_sweep.items():
+            all_passes = sweep_values.sim_variables.cap_all_passes
+            if not all_passes:
+                self.logger.warning(
+                    f'Sweep point {item} has no capacitance matrix, skipped.')
+                continue
+            index.append(item)
+            cap_matrices.append(np.asarray(all_passes[max(all_passes)]))
+
+        all_res = extract_transmon_coupled_Noscillator_batch(cap_matrices,
+                                                             ic_amps,
+                                                             cj,
+                                                             num_cpads,
+                                                             fbus,
+                                                             fread,
+                                                             g_scale=1,
+                                                             index=index)
         all_res['χr MHz'] = abs(all_res['chi_in_MHz'].apply(lambda x: x[0]))
         all_res['gr MHz'] = abs(all_res['gbus'].apply(lambda x: x[0]))
-        self.lumped_oscillator_all = all_res
-        return self.lumped_oscillator_all
+        return all_res
 
     def plot_convergence(self, *args, **kwargs):
         """Plots alpha and frequency versus pass number, as well as convergence of delta (in %).
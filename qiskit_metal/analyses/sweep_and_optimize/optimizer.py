@@ -0,0 +1,385 @@
+# -*- coding: utf-8 -*-
+
+# This code is part of Qiskit.
+#
+# (C) Copyright IBM 2017, 2021.
+#
+# This code is licensed under the Apache License, Version 2.0. You may
+# obtain a copy of this license in the LICENSE.txt file in the root directory
+# of this source tree or at http://www.apache.org/licenses/LICENSE-2.0.
+#
+# Any modifications or derivative works of this code must retain this
+# copyright notice, and modified files need to carry a notice indicating
+# that they have been altered from the originals.
+"""Multi-dimensional sampling of component options, and a surrogate-model
+optimizer which picks the next design points from the previous results.
+
+The points are evaluated with Sweeper.run_multi_sweep, so every point is an
+ordinary QAnalysis.run on its own copy of the design, and batches of points
+run concurrently.
+"""
+
+import itertools
+from pathlib import Path
+from typing import Callable, Tuple, Union
+
+import numpy as np
+import pandas as pd
+from scipy.stats import norm, qmc
+
+from qiskit_metal import Dict, logger
+
+__all__ = [
+    'grid_points', 'latin_hypercube_points', 'GaussianProcessSurrogate',
+    'SurrogateOptimizer'
+]
+
+
+def grid_points(dimensions: dict) -> Tuple[list, list]:
+    """All the combinations of the values of each dimension.
+
+    Args:
+        dimensions (dict): Key is (qcomp_name, option_name), value is the
+            list of values of that option.
+
+    Returns:
+        Tuple[list, list]: The option keys, and the list of points, each a
+        tuple with one value per option key.
+    """
+    option_keys = list(dimensions.keys())
+    points = list(itertools.product(*dimensions.values()))
+    return option_keys, points
+
+
+def latin_hypercube_points(bounds: dict,
+                           num_points: int,
+                           seed: int = None) -> Tuple[list, list]:
+    """Space filling random points within the bounds.
+
+    Args:
+        bounds (dict): Key is (qcomp_name, option_name), value is the
+            tuple (low, high), as numbers in the units of the design.
+        num_points (int): Number of points.
+        seed (int): Seed of the random generator. Defaults to None.
+
+    Returns:
+        Tuple[list, list]: The option keys, and the list of points, each a
+        tuple with one value per option key.
+    """
+    option_keys = list(bounds.keys())
+    low, high = np.array(list(bounds.values()), dtype=float).T
+    sampler = qmc.LatinHypercube(d=len(option_keys), seed=seed)
+    samples = qmc.scale(sampler.random(num_points), low, high)
+    points = [tuple(float(value) for value in sample) for sample in samples]
+    return option_keys, points
+
+
+class GaussianProcessSurrogate():
+    """Gaussian process regression with a squared exponential kernel.
+
+    The inputs are expected to be scaled to the unit cube.  The length scale
+    is picked from a short list by maximizing the marginal likelihood, which
+    is enough for the few tens of points of a design optimization.
+    """
+
+    length_scales = (0.05, 0.1, 0.2, 0.4, 0.8)
+    """Candidate length scales, in units of the unit cube."""
+
+    def __init__(self, noise: float = 1e-6):
+        """
+        Args:
+            noise (float): Added to the diagonal of the kernel, relative to the
+                variance of the observations. Defaults to 1e-6.
+        """
+        self.noise = noise
+        self.x = None
+        self.y_mean = 0.
+        self.y_std = 1.
+        self.length_scale = None
+        self._chol = None
+        self._alpha = None
+
+    def _kernel(self, x_a: np.ndarray, x_b: np.ndarray,
+                length_scale: float) -> np.ndarray:
+        sq_dist = np.sum((x_a[:, None, :] - x_b[None, :, :])**2, axis=-1)
+        return np.exp(-0.5 * sq_dist / length_scale**2)
+
+    def fit(self, x: np.ndarray, y: np.ndarray, length_scale: float = None):
+        """Condition the surrogate on the observations.
+
+        Args:
+            x (np.ndarray): Inputs, shape (num_points, num_dimensions).
+            y (np.ndarray): Observed values, shape (num_points,).
+            length_scale (float): Skip the search and use this length scale.
+                Defaults to None.
+
+        Raises:
+            ValueError: The kernel can't be factorized for any length scale,
+                even with more noise on its diagonal.
+        """
+        self.x = np.atleast_2d(np.asarray(x, dtype=float))
+        y = np.asarray(y, dtype=float)
+        self.y_mean = y.mean()
+        self.y_std = y.std() if y.std() > 0 else 1.
+        y_scaled = (y - self.y_mean) / self.y_std
+
+        candidates = self.length_scales if length_scale is None else (
+            length_scale,)
+        noise = self.noise
+        best = self._best_length_scale(y_scaled, candidates, noise)
+        while best is None and noise < 1.:
+            # Duplicate or very close points make the kernel singular:
+            # retry with more noise on its diagonal
+            noise = max(noise * 100., 1e-8)
+            best = self._best_length_scale(y_scaled, candidates, noise)
+        if best is None:
+            raise ValueError(
+                'The kernel of the surrogate is not positive definite for '
+                'any length scale, even with more noise on its diagonal.')
+
+        _, self.length_scale, self._chol, self._alpha = best
+
+    def _best_length_scale(self, y_scaled: np.ndarray, candidates: tuple,
+                           noise: float) -> Union[tuple, None]:
+        """The candidate length scale of largest likelihood.
+
+        Returns:
+            Union[tuple, None]: (log likelihood, length scale, Cholesky factor
+            of the kernel, weights of the observations), or None if the
+            kernel can't be factorized for any of the candidates.
+        """
+        best = None
+        for scale in candidates:
+            kernel = self._kernel(self.x, self.x, scale)
+            kernel[np.diag_indices_from(kernel)] += noise
+            try:
+                chol = np.linalg.cholesky(kernel)
+            except np.linalg.LinAlgError:
+                continue
+            alpha = np.linalg.solve(chol.T, np.linalg.solve(chol, y_scaled))
+            log_likelihood = (-0.5 * y_scaled @ alpha -
+                              np.sum(np.log(np.diag(chol))))
+            if best is None or log_likelihood > best[0]:
+                best = (log_likelihood, scale, chol, alpha)
+        return best
+
+    def predict(self, x: np.ndarray) -> Tuple[np.ndarray, np.ndarray]:
+        """Mean and standard deviation of the surrogate.
+
+        Args:
+            x (np.ndarray): Inputs, shape (num_points, num_dimensions).
+
+        Returns:
+            Tuple[np.ndarray, np.ndarray]: Mean and standard deviation,
+            each of shape (num_points,).
+        """
+        x = np.atleast_2d(np.asarray(x, dtype=float))
+        k_star = self._kernel(x, self.x, self.length_scale)
+        mean = k_star @ self._alpha
+        v = np.linalg.solve(self._chol, k_star.T)
+        var = np.clip(1. - np.sum(v**2, axis=0), 1e-12, None)
+        return mean * self.y_std + self.y_mean, np.sqrt(var) * self.y_std
+
+
+class SurrogateOptimizer():
+    """Minimize an objective of the analysis results over component options.
+
+    Each iteration fits a GaussianProcessSurrogate to all the results so far,
+    proposes a batch of new points and evaluates the batch concurrently
+    through Sweeper.run_multi_sweep.
+
+    Two acquisition functions are available:
+
+    * 'ei': expected improvement, to find the minimum of the objective.
+    * 'std': largest uncertainty of the surrogate, an adaptive sweep which
+      places new points where the results are least known.
+
+    Example:
+
+        ::
+
+            def f01_error(sweep_values):
+                return abs(sweep_values.variables.lumped_oscillator.fQ - 5.1)
+
+            opt = SurrogateOptimizer(
+                lom_analysis,
+                bounds={('Q1', 'pad_gap'): (0.02, 0.05),
+                        ('Q1', 'pad_width'): (0.3, 0.6)},
+                objective=f01_error, batch_size=4)
+            best = opt.run(num_iterations=5)
+    """
+
+    def __init__(self,
+                 analysis: 'QAnalysis',
+                 bounds: dict,
+                 objective: Callable,
+                 batch_size: int = 4,
+                 num_initial: int = None,
+                 acquisition: str = 'ei',
+                 store_path: Union[str, Path] = None,
+                 max_workers: int = None,
+                 analysis_factory: Callable = None,
+                 seed: int = None,
+                 **run_kwargs):
+        """
+        Args:
+            analysis (QAnalysis): Used to reach the design and its Sweeper.
+            bounds (dict): Key is (qcomp_name, option_name), value is the
+                tuple (low, high), as numbers in the units of the design.
+            objective (Callable): Receives the result of one point, in the
+                format of Sweeper.populate_all_sweep, and returns the float to
+                minimize. Runs in this process, so it need not be picklable.
+            batch_size (int): Points evaluated concurrently per iteration.
+                Defaults to 4.
+            num_initial (int): Latin hypercube points evaluated before the
+                first fit. Defaults to None, which is 2 * batch_size.
+            acquisition (str): 'ei' or 'std'. Defaults to 'ei'.
+            store_path (Union[str, Path]): Folder of the SweepStore, to resume
+                an interrupted optimization. Defaults to None.
+            max_workers (int): Number of processes. Defaults to None.
+            analysis_factory (Callable): See Sweeper.run_multi_sweep.
+                Defaults to None.
+            seed (int): Seed of the random generator. Defaults to None.
+            run_kwargs: Passed to run() of the analysis for every point.
+        """
+        if acquisition not in ('ei', 'std'):
+            raise ValueError(f'acquisition={acquisition} is not "ei" or "std".')
+
+        self.analysis = analysis
+        self.option_keys = list(bounds.keys())
+        self.low, self.high = np.array(list(bounds.values()), dtype=float).T
+        self.objective = objective
+        self.batch_size = batch_size
+        self.num_initial = 2 * batch_size if num_initial is None else num_initial
+        self.acquisition = acquisition
+        self.store_path = store_path
+        self.max_workers = max_workers
+        self.analysis_factory = analysis_factory
+        self.run_kwargs = run_kwargs
+        self.rng = np.random.default_rng(seed)
+        self.seed = seed
+
+        self.surrogate = GaussianProcessSurrogate()
+        self.all_sweep = Dict()
+        self.history = list()
+
+    def _to_unit(self, points: np.ndarray) -> np.ndarray:
+        return (np.asarray(points, dtype=float) - self.low) / (self.high -
+                                                               self.low)
+
+    def _from_unit(self, unit_points: np.ndarray) -> list:
+        points = self.low + unit_points * (self.high - self.low)
+        return [tuple(float(value) for value in point) for point in points]
+
+    def evaluate(self, points: list) -> int:
+        """Run the analysis for the points, and record their objective.
+
+        Args:
+            points (list): Each entry is a tuple with one value per option.
+
+        Returns:
+            int: The return code of Sweeper.run_multi_sweep.
+        """
+        all_sweep, return_code = self.analysis.run_multi_sweep(
+            self.option_keys,
+            points,
+            store_path=self.store_path,
+            max_workers=self.max_workers,
+            analysis_factory=self.analysis_factory,
+            **self.run_kwargs)
+        for point, sweep_values in all_sweep.items():
+            if point in self.all_sweep:
+                continue
+            self.all_sweep[point] = sweep_values
+            self.history.append((point, float(self.objective(sweep_values))))
+        return return_code
+
+    def propose(self, num_points: int, num_candidates: int = 2048) -> list:
+        """Pick the next points from the surrogate of all results so far.
+
+        A batch is built one point at a time: after picking a point, it is
+        added to the surrogate with its predicted mean as the observation,
+        so the next pick goes somewhere else.
+
+        Args:
+            num_points (int): Number of points to propose.
+            num_candidates (int): Random candidates scored by the acquisition
+                function. Defaults to 2048.
+
+        Returns:
+            list: Each entry is a tuple with one value per option.
+        """
+        x = self._to_unit([point for point, _ in self.history])
+        y = np.array([value for _, value in self.history])
+        self.surrogate.fit(x, y)
+        length_scale = self.surrogate.length_scale
+
+        candidates = self.rng.random((num_candidates, len(self.option_keys)))
+        chosen = list()
+        for _ in range(num_points):
+            mean, std = self.surrogate.predict(candidates)
+            if self.acquisition == 'std':
+                score = std
+            else:
+                improvement = y.min() - mean
+                z_score = improvement / std
+                score = improvement * norm.cdf(z_score) + std * norm.pdf(
+                    z_score)
+            best = int(np.argmax(score))
+            chosen.append(candidates[best])
+
+            x = np.vstack([x, candidates[best]])
+            y = np.append(y, mean[best])
+            self.surrogate.fit(x, y, length_scale=length_scale)
+            candidates = np.delete(candidates, best, axis=0)
+
+        return self._from_unit(np.array(chosen))
+
+    def run(self, num_iterations: int) -> Dict:
+        """Evaluate the initial points, then iterate fit, propose, evaluate.
+
+        Args:
+            num_iterations (int): Number of batches proposed by the surrogate.
+
+        Returns:
+            Dict: best_point (Dict of 'qcomp_name.option_name' to value),
+            best_value (float), and history (pd.DataFrame of every point and
+            its objective, in the order of evaluation).
+        """
+        if len(self.history) < self.num_initial:
+            _, points = latin_hypercube_points(dict(
+                zip(self.option_keys, zip(self.low, self.high))),
+                                               self.num_initial,
+                                               seed=self.seed)
+            self.evaluate(points)
+
+        for iteration in range(num_iterations):
+            if len(self.history) < 2:
+                logger.warning('SurrogateOptimizer needs at least two '
+                               'successful points to fit the surrogate.')
+                break
+            self.evaluate(self.propose(self.batch_size))
+            logger.info(f'SurrogateOptimizer iteration {iteration}: '
+                        f'best objective={self.best()[1]}')
+
+        return self.result()
+
+    def best(self) -> Tuple[tuple, float]:
+        """The point with the smallest objective so far.
+
+        Returns:
+            Tuple[tuple, float]: The point and its objective.
+        """
+        return min(self.history, key=lambda entry: entry[1])
+
+    def result(self) -> Dict:
+        """Summary of the optimization so far, see run()."""
+        names = [f'{qcomp}.{option}' for qcomp, option in self.option_keys]
+        history = pd.DataFrame(
+            [list(point) + [value] for point, value in self.history],
+            columns=names + ['objective'])
+        best_point, best_value = self.best() if self.history else (None, None)
+        return Dict(best_point=None if best_point is None else Dict(
+            zip(names, best_point)),
+                    best_value=best_value,
+                    history=history)
@@ -0,0 +1,183 @@
+# -*- coding: utf-8 -*-
+
+# This code is part of Qiskit.
+#
+# (C) Copyright IBM 2017, 2021.
+#
+# This code is licensed under the Apache License, Version 2.0. You may
+# obtain a copy of this license in the LICENSE.txt file in the root directory
+# of this source tree or at http://www.apache.org/licenses/LICENSE-2.0.
+#
+# Any modifications or derivative works of this code must retain this
+# copyright notice, and modified files need to carry a notice indicating
+# that they have been altered from the originals.
+"""On-disk store of the results of a sweep, one file per swept value."""
+
+import hashlib
+import os
+import pickle
+from pathlib import Path
+from collections.abc import Mapping
+from typing import Any, Union
+
+from qiskit_metal import Dict
+
+__all__ = ['SweepStore']
+
+
+class SweepStore():
+    """Persist the result of every point of a sweep as soon as it is known.
+
+    Each swept value is written to its own pickle file within `path`, so an
+    interrupted sweep keeps all the points which completed.  When the same
+    sweep is started again with the same `path`, the completed points are
+    read back instead of being simulated again.
+
+    The folder also holds a small header with the name of the component and
+    option being swept, and a hash of the setup and run arguments of the
+    analysis, which is used to refuse mixing results from two different
+    sweeps.
+    """
+
+    header_name = 'sweep_info.pkl'
+    """Name of the file with the description of the sweep."""
+
+    point_prefix = 'point_'
+    """Prefix of the files which hold the result of each point."""
+
+    def __init__(self, path: Union[str, Path]):
+        """Use (and create if needed) the folder `path` to hold the results.
+
+        Args:
+            path (Union[str, Path]): Folder which holds the sweep results.
+        """
+        self.path = Path(path)
+        self.path.mkdir(parents=True, exist_ok=True)
+
+    @classmethod
+    def key(cls, item: Any) -> str:
+        """Unique, file system safe, name for a swept value.
+
+        Args:
+            item (Any): The value of the swept option.
+
+        Returns:
+            str: Hash of the representation of item.
+        """
+        return hashlib.sha1(repr(item).encode('utf-8')).hexdigest()
+
+    @classmethod
+    def settings_key(cls, settings: Any) -> str:
+        """Hash of the setup and run arguments of a sweep, which does not
+        depend on the order of the keys of the dicts.
+
+        Args:
+            settings (Any): Usually a dict of dicts.
+
+        Returns:
+            str: Hash of settings.
+        """
+
+        def _canonical(value: Any) -> Any:
+            if isinstance(value, Mapping):
+                return tuple(
+                    sorted((repr(key), _canonical(val))
+                           for key, val in value.items()))
+            if isinstance(value, (list, tuple)):
+                return tuple(_canonical(val) for val in value)
+            return value
+
+        return cls.key(_canonical(settings))
+
+    def _point_file(self, item: Any) -> Path:
+        return self.path / f'{self.point_prefix}{self.key(item)}.pkl'
+
+    def _write(self, filename: Path, data: Any):
+        """Write atomically, so a killed process never leaves half a file."""
+        tmp_name = filename.with_suffix('.tmp')
+        with open(tmp_name, 'wb') as file:
+            pickle.dump(data, file)
+        os.replace(tmp_name, filename)
+
+    @staticmethod
+    def _read(filename: Path) -> Any:
+        with open(filename, 'rb') as file:
+            return pickle.load(file)
+
+    def check_header(self,
+                     qcomp_name: str,
+                     option_name: str,
+                     settings: dict = None) -> bool:
+        """Write the header of a new store, or verify that an existing store
+        holds results for the same component, option and settings.
+
+        Args:
+            qcomp_name (str): A component that contains the option to be swept.
+            option_name (str): The option within qcomp_name to sweep.
+            settings (dict): Setup and run arguments of the analysis, which
+                must not change while resuming.  Defaults to None.
+
+        Returns:
+            bool: True if the store can be used for this sweep.
+        """
+        header = Dict(qcomp_name=qcomp_name,
+                      option_name=option_name,
+                      settings=self.settings_key(settings))
+        filename = self.path / self.header_name
+        if filename.exists():
+            return self._read(filename) == header
+        self._write(filename, header)
+        return True
+
+    def has(self, item: Any) -> bool:
+        """Is the result for item already in the store?
+
+        Args:
+            item (Any): The value of the swept option.
+
+        Returns:
+            bool: True if the point completed in an earlier run.
+        """
+        return self._point_file(item).exists()
+
+    def save(self, item: Any, sweep_values: Dict):
+        """Write the result of one point.
+
+        Args:
+            item (Any): The value of the swept option.
+            sweep_values (Dict): Result in the format of
+                Sweeper.populate_all_sweep.
+        """
+        self._write(self._point_file(item), Dict(item=item,
+                                                 result=sweep_values))
+
+    def load(self, item: Any) -> Union[Dict, None]:
+        """Read the result of one point.
+
+        Args:
+            item (Any): The value of the swept option.
+
+        Returns:
+            Union[Dict, None]: The result, None if the point is not stored.
+        """
+        if not self.has(item):
+            return None
+        return self._read(self._point_file(item)).result
+
+    def completed(self) -> Dict:
+        """All the points in the store.
+
+        Returns:
+            Dict: The key is the value of the swept option, the value is the
+            result of the point.
+        """
+        all_sweep = Dict()
+        for filename in sorted(self.path.glob(f'{self.point_prefix}*.pkl')):
+            point = self._read(filename)
+            all_sweep[point.item] = point.result
+        return all_sweep
+
+    def clear(self):
+        """Delete all the results and the header."""
+        for filename in self.path.glob('*.pkl'):
+            filename.unlink()
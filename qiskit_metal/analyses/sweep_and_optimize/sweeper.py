@@ -1,5 +1,12 @@
+from concurrent.futures import ProcessPoolExecutor, as_completed
+from copy import deepcopy
+from functools import partial
+from pathlib import Path
+from typing import Callable, Tuple, Union
+
 from qiskit_metal import Dict
-from typing import Tuple, Union
+from qiskit_metal.analyses.sweep_and_optimize.sweep_store import SweepStore
+from qiskit_metal.toolbox_metal.import_export import design_from_bytes, design_to_bytes
 
 
 class Sweeper():
@@ -56,6 +63,10 @@ class Sweeper():
             design_name(str): Name of design (workspace) to use in project.
             box_plus_buffer(bool): Render the entire chip or create a
                         box_plus_buffer around the components which are rendered.
+            store_path (str): Folder used to save the result of each point as
+                        soon as it completes.  Points already in the folder
+                        are not run again, so an interrupted sweep resumes.
+                        Defaults to None, which keeps results only in memory.
 
         Returns:
             Tuple[Dict, int]: The dict key is each value of option_sweep, the
@@ -70,6 +81,7 @@ class Sweeper():
             * 4 option_sweep is empty, need at least one entry.
             * 5 last key in option_name is not in Dict. 
             * 6 need to have at least three arguments
+            * 7 store_path holds the results of a different sweep.
         """
         #Dict of all swept information.
         all_sweep = Dict()
@@ -77,6 +89,12 @@ class Sweeper():
         clean_kwargs = Dict()
         use_previous_run = False
 
+        store = None
+        if 'store_path' in kwarg:
+            if kwarg['store_path'] is not None:
+                store = SweepStore(kwarg['store_path'])
+            del kwarg['store_path']
+
         # Decide if we use the previous run based on inputs given.
         if len(args) == 3 and len(kwarg) == 0:
             use_previous_run = True
@@ -116,18 +134,27 @@ class Sweeper():
 
         all_dicts = {**previous_run, **clean_kwargs, **kwarg}
 
+        if store is not None and not store.check_header(
+                args[0], args[1], self.sweep_settings(all_dicts)):
+            return all_sweep, 7
+
         all_sweep, check_result = self.iterate_option_sweep(
             args,
             all_dicts=all_dicts,
             option_path=option_path,
             a_value=a_value,
-            all_sweep=all_sweep)
+            all_sweep=all_sweep,
+            store=store)
 
         return all_sweep, check_result
 
-    def iterate_option_sweep(self, args: list, all_dicts: Dict,
-                             option_path: list, a_value: Dict,
-                             all_sweep: Dict) -> Tuple[Dict, int]:
+    def iterate_option_sweep(self,
+                             args: list,
+                             all_dicts: Dict,
+                             option_path: list,
+                             a_value: Dict,
+                             all_sweep: Dict,
+                             store: SweepStore = None) -> Tuple[Dict, int]:
         """Iterate through the values that user gave in option_sweep.  
 
         Args:
@@ -136,6 +163,8 @@ class Sweeper():
             option_path (list):  The list has traversed the option Dict.
             a_value (Dict): Has the value from the dictionary of the searched key.
             all_sweep (Dict): Will be populated during the iteration. 
+            store (SweepStore): Completed points are read from, and new points
+                        are written to, the store.  Defaults to None.
 
         Returns:
             Tuple[Dict, int]: The dict key is each value of option_sweep, the
@@ -148,6 +177,10 @@ class Sweeper():
         """
 
         for _, item in enumerate(args[2]):
+            if store is not None and store.has(item):
+                all_sweep[item] = store.load(item)
+                continue
+
             # Last item in list.
             if option_path[-1] in a_value.keys():
                 a_value[option_path[-1]] = item
@@ -169,9 +202,265 @@ class Sweeper():
                     f'run() did not execute as expected: {message}')
 
             self.populate_all_sweep(all_sweep, item, args[1])
+            if store is not None:
+                store.save(item, all_sweep[item])
+
+        return all_sweep, 0
+
+    def run_sweep_parallel(self,
+                           qcomp_name: str,
+                           option_name: str,
+                           option_sweep: list,
+                           store_path: Union[str, Path] = None,
+                           max_workers: int = None,
+                           analysis_factory: Callable = None,
+                           **run_kwargs) -> Tuple[Dict, int]:
+        """Run each point of the sweep on its own copy of the design, in a
+        pool of processes.
+
+        The design is serialized once.  Every worker process recreates it,
+        changes option_name of qcomp_name, rebuilds only its own copy, and
+        calls run() of a new analysis built by analysis_factory.  The
+        original design is never modified.
+
+        Use renderers which can run several instances at once on the local
+        machine, such as gmsh and elmer.  For renderers that drive a single
+        application, such as Ansys, use max_workers=1, which runs the points
+        one after another in this process, still on copies of the design.
+
+        Args:
+            qcomp_name (str): A component that contains the option to be swept.
+            option_name (str): The option within qcomp_name to sweep.
+            option_sweep (list): Each entry in the list is a value for
+                        option_name.
+            store_path (Union[str, Path]): Folder used to save the result of
+                        each point as soon as it completes.  Points already in
+                        the folder are not run again, so an interrupted sweep
+                        resumes.  Defaults to None.
+            max_workers (int): Number of processes. Defaults to None, which
+                        uses the number of processors on the machine.
+            analysis_factory (Callable): Picklable callable which receives the
+                        copy of the design and returns the QAnalysis to run.
+                        Defaults to None, which creates a new instance of the
+                        class of the parent, with the same renderer and setup.
+            run_kwargs: Passed to run() of the analysis for every point.
+
+        Returns:
+            Tuple[Dict, int]: The dict key is each value of option_sweep, the
+            value is the solution-data for each sweep, in the format of
+            populate_all_sweep.  Points whose run() failed are not included.
+            The int is the return code, as described in run_sweep.
+        """
+        all_sweep = Dict()
+
+        option_path, a_value, check_result = self.error_check_sweep_input(
+            qcomp_name, option_name, option_sweep)
+        if check_result != 0:
+            return all_sweep, check_result
+        if option_path[-1] not in a_value.keys():
+            self.design.logger.warning(
+                f'Key="{option_path[-1]}" is not in dict.')
+            return all_sweep, 5
+
+        store = None
+        if store_path is not None:
+            store = SweepStore(store_path)
+            if not store.check_header(qcomp_name, option_name,
+                                      self.sweep_settings(run_kwargs)):
+                return all_sweep, 7
+
+        changes = [[(qcomp_name, option_path, item)] for item in option_sweep]
+        results = self.run_changes(option_sweep, changes, store, max_workers,
+                                   analysis_factory, run_kwargs)
+        for item, sweep_values in results.items():
+            sweep_values['option_name'] = option_name
+            all_sweep[item] = sweep_values
+
+        return all_sweep, 0
+
+    def run_multi_sweep(self,
+                        option_keys: list,
+                        points: list,
+                        store_path: Union[str, Path] = None,
+                        max_workers: int = None,
+                        analysis_factory: Callable = None,
+                        **run_kwargs) -> Tuple[Dict, int]:
+        """Sweep several options, of one or more components, at once.
+
+        Each point sets a value for every option in option_keys.  The points
+        may come from grid_points, latin_hypercube_points or from a
+        SurrogateOptimizer.  They are run like run_sweep_parallel: each on its
+        own copy of the design, concurrently, and saved in the store.
+
+        Args:
+            option_keys (list): The options to sweep, as tuples of
+                        (qcomp_name, option_name).
+            points (list): Each entry is a tuple with one value per entry
+                        of option_keys.
+            store_path (Union[str, Path]): Folder used to save the result of
+                        each point as soon as it completes.  Defaults to None.
+            max_workers (int): Number of processes. Defaults to None, which
+                        uses the number of processors on the machine.
+            analysis_factory (Callable): Picklable callable which receives the
+                        copy of the design and returns the QAnalysis to run.
+                        Defaults to None, see default_analysis_factory.
+            run_kwargs: Passed to run() of the analysis for every point.
+
+        Returns:
+            Tuple[Dict, int]: The dict key is the tuple of values of each
+            point, the value is the solution-data in the format of
+            populate_all_sweep, with an additional key `options` which maps
+            'qcomp_name.option_name' to the value of the point.
+            Points whose run() failed are not included.
+            The int is the return code, as described in run_sweep.
+        """
+        all_sweep = Dict()
+        points = [tuple(point) for point in points]
+
+        option_paths = list()
+        for index, (qcomp_name, option_name) in enumerate(option_keys):
+            option_path, a_value, check_result = self.error_check_sweep_input(
+                qcomp_name, option_name, [point[index] for point in points])
+            if check_result != 0:
+                return all_sweep, check_result
+            if option_path[-1] not in a_value.keys():
+                self.design.logger.warning(
+                    f'Key="{option_path[-1]}" is not in dict.')
+                return all_sweep, 5
+            option_paths.append(option_path)
+
+        full_names = [
+            f'{qcomp_name}.{option_name}'
+            for qcomp_name, option_name in option_keys
+        ]
+
+        store = None
+        if store_path is not None:
+            store = SweepStore(store_path)
+            if not store.check_header([key[0] for key in option_keys],
+                                      [key[1] for key in option_keys],
+                                      self.sweep_settings(run_kwargs)):
+                return all_sweep, 7
+
+        changes = [[
+            (key[0], path, value)
+            for key, path, value in zip(option_keys, option_paths, point)
+        ]
+                   for point in points]
+        results = self.run_changes(points, changes, store, max_workers,
+                                   analysis_factory, run_kwargs)
+        for point, sweep_values in results.items():
+            sweep_values['option_name'] = full_names
+            sweep_values['options'] = Dict(zip(full_names, point))
+            all_sweep[point] = sweep_values
 
         return all_sweep, 0
 
+    def run_changes(self, items: list, changes: list, store: SweepStore,
+                    max_workers: int, analysis_factory: Callable,
+                    run_kwargs: dict) -> Dict:
+        """Engine shared by run_sweep_parallel and run_multi_sweep.
+
+        Args:
+            items (list): The key of each point, in the store and the result.
+            changes (list): For each point, a list of
+                        (qcomp_name, option_path, value) to apply to the copy
+                        of the design.
+            store (SweepStore): Completed points are read from, and new points
+                        are written to, the store.  Can be None.
+            max_workers (int): Number of processes. 1 runs the points in this
+                        process.  None uses the number of processors.
+            analysis_factory (Callable): Takes the design, returns the
+                        QAnalysis.  None uses default_analysis_factory.
+            run_kwargs (dict): Passed to run() of the analysis.
+
+        Returns:
+            Dict: The result of each item which completed, in the order of
+            items, not the order of completion.
+        """
+        if analysis_factory is None:
+            analysis_factory = self.default_analysis_factory()
+
+        results = Dict()
+        pending = list()
+        for item, item_changes in zip(items, changes):
+            if store is not None and store.has(item):
+                results[SweepStore.key(item)] = store.load(item)
+            else:
+                pending.append((item, item_changes))
+
+        def _keep(item, sweep_values):
+            if sweep_values is None:
+                return
+            results[SweepStore.key(item)] = sweep_values
+            if store is not None:
+                store.save(item, sweep_values)
+
+        if pending:
+            design_data = design_to_bytes(self.design)
+
+            if max_workers == 1:
+                for item, item_changes in pending:
+                    _keep(
+                        item,
+                        run_sweep_point(design_data, analysis_factory,
+                                        item_changes, run_kwargs))
+            else:
+                with ProcessPoolExecutor(max_workers=max_workers) as executor:
+                    futures = {
+                        executor.submit(run_sweep_point, design_data,
+                                        analysis_factory, item_changes,
+                                        run_kwargs): item
+                        for item, item_changes in pending
+                    }
+                    for future in as_completed(futures):
+                        _keep(futures[future], future.result())
+
+        ordered = Dict()
+        for item in items:
+            if SweepStore.key(item) in results:
+                ordered[item] = results[SweepStore.key(item)]
+        return ordered
+
+    def sweep_settings(self, run_kwargs: dict) -> Dict:
+        """The setup of the parent and the run arguments, which change the
+        result of every point.  A SweepStore refuses to resume a sweep when
+        they differ.
+
+        Args:
+            run_kwargs (dict): Passed to run() of the analysis.
+
+        Returns:
+            Dict: The setup and the run arguments.
+        """
+        def _without_run(setup):
+            # setup.run only records the arguments of the last run()
+            if not isinstance(setup, dict):
+                return setup
+            return {key: val for key, val in setup.items() if key != 'run'}
+
+        settings = Dict(setup=_without_run(self.parent.setup), run=run_kwargs)
+        if hasattr(self.parent, 'sim'):
+            settings.sim_setup = _without_run(
+                getattr(self.parent.sim, 'setup', None))
+        return settings
+
+    def default_analysis_factory(self) -> Callable:
+        """Callable which recreates the parent analysis for a copy of the
+        design, keeping the renderer name and the setup of the parent.
+
+        Returns:
+            Callable: Takes a QDesign and returns a QAnalysis.
+        """
+        if hasattr(self.parent, 'sim'):
+            renderer_name = getattr(self.parent.sim, 'renderer_name', None)
+            sim_setup = deepcopy(getattr(self.parent.sim, 'setup', None))
+        else:
+            renderer_name = getattr(self.parent, 'renderer_name', None)
+            sim_setup = None
+        return partial(_make_analysis, self.parent.__class__, renderer_name,
+                       deepcopy(self.parent.setup), sim_setup)
+
     # #######  Populate all_sweep
     def populate_all_sweep(self, all_sweep: Dict, item: str, option_name: str):
         """Populate the Dict passed in all_sweep from QAnalysis.  
@@ -185,10 +474,11 @@ class Sweeper():
         """
         sweep_values = Dict()
         sweep_values['option_name'] = option_name
-        sweep_values['variables'] = self.parent._variables
+        # Copy, since the next run of the parent would modify the same Dict.
+        sweep_values['variables'] = deepcopy(self.parent._variables)
 
         if hasattr(self.parent, 'sim'):
-            sweep_values['sim_variables'] = self.parent.sim._variables
+            sweep_values['sim_variables'] = deepcopy(self.parent.sim._variables)
 
         all_sweep[item] = sweep_values
 
@@ -257,4 +547,63 @@ class Sweeper():
             str: Value from the dictionary of the searched term.
         """
         value = a_dict[search]
-        return value
\ No newline at end of file
+        return value
+
+
+def _make_analysis(analysis_class: type, renderer_name: str, setup: Dict,
+                   sim_setup: Dict, design: 'QDesign') -> 'QAnalysis':
+    """Module level, so it can be pickled and sent to worker processes."""
+    analysis = analysis_class(design, renderer_name)
+    analysis._setup = deepcopy(setup)
+    if sim_setup is not None and hasattr(analysis, 'sim'):
+        analysis.sim._setup = deepcopy(sim_setup)
+    return analysis
+
+
+def run_sweep_point(design_data: bytes, analysis_factory: Callable,
+                    changes: list, run_kwargs: dict) -> Union[Dict, None]:
+    """Run one point of a sweep on an independent copy of the design.
+
+    Used by Sweeper.run_changes, in the worker processes.
+
+    Args:
+        design_data (bytes): Design serialized by design_to_bytes.
+        analysis_factory (Callable): Takes the design, returns the QAnalysis.
+        changes (list): Tuples of (qcomp_name, option_path, value), where
+            option_path is the option within qcomp_name, split at the dots.
+        run_kwargs (dict): Passed to run() of the analysis.
+
+    Returns:
+        Union[Dict, None]: Result with the keys `variables` and
+        `sim_variables` of Sweeper.populate_all_sweep.
+        None if run() raised an exception.
+    """
+    design = design_from_bytes(design_data)
+
+    for qcomp_name, option_path, value in changes:
+        a_value = design.components[qcomp_name].options
+        for name in option_path[:-1]:
+            a_value = a_value[name]
+        a_value[option_path[-1]] = value
+
+    design.rebuild()
+    analysis = analysis_factory(design)
+
+    try:
+        analysis.run(**run_kwargs)
+    except Exception as ex:  # pylint: disable=broad-except
+        template = "An exception of type {0} occurred. Arguments:\n{1!r}"
+        message = template.format(type(ex).__name__, ex.args)
+        point = ', '.join(f'{qcomp_name}.{".".join(option_path)}={value}'
+                          for qcomp_name, option_path, value in changes)
+        design.logger.warning(
+            f'For class {analysis.__class__.__name__}, {point}, '
+            f'run() did not execute as expected: {message}')
+        return None
+
+    sweep_values = Dict()
+    sweep_values['variables'] = analysis._variables
+    if hasattr(analysis, 'sim'):
+        sweep_values['sim_variables'] = analysis.sim._variables
+
+    return sweep_values
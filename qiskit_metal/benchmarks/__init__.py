@@ -0,0 +1,55 @@
+# -*- coding: utf-8 -*-
+
+# This code is part of Qiskit.
+#
+# (C) Copyright IBM 2017, 2021.
+#
+# This code is licensed under the Apache License, Version 2.0. You may
+# obtain a copy of this license in the LICENSE.txt file in the root directory
+# of this source tree or at http://www.apache.org/licenses/LICENSE-2.0.
+#
+# Any modifications or derivative works of this code must retain this
+# copyright notice, and modified files need to carry a notice indicating
+# that they have been altered from the originals.
+"""
+=============================================
+Benchmarks (:mod:`qiskit_metal.benchmarks`)
+=============================================
+
+.. currentmodule:: qiskit_metal.benchmarks
+
+Timing of the build, routing, export, rendering, analysis and save of
+synthetic designs of increasing size, to catch performance regressions.
+
+From the command line, which writes the results as JSON:
+
+.. code-block:: bash
+
+    python -m qiskit_metal.benchmarks --rows 4 --cols 4 --repeat 3 \\
+        --output benchmarks.jsonl --append
+
+Functions
+---------------
+
+.. autosummary::
+    :toctree: ../stubs/
+
+    run_benchmarks
+    save_results
+    make_qubit_grid
+    add_bus_routes
+    grid_circuit
+
+Submodules
+---------------
+
+.. autosummary::
+    :toctree: ../stubs/
+
+    suite
+    synthetic
+
+"""
+
+from .suite import STAGES, OPTIONAL_STAGES, run_benchmarks, save_results
+from .synthetic import make_qubit_grid, add_bus_routes, grid_circuit
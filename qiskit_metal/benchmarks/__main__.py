@@ -0,0 +1,76 @@
+# -*- coding: utf-8 -*-
+
+# This code is part of Qiskit.
+#
+# (C) Copyright IBM 2017, 2021.
+#
+# This code is licensed under the Apache License, Version 2.0. You may
+# obtain a copy of this license in the LICENSE.txt file in the root directory
+# of this source tree or at http://www.apache.org/licenses/LICENSE-2.0.
+#
+# Any modifications or derivative works of this code must retain this
+# copyright notice, and modified files need to carry a notice indicating
+# that they have been altered from the originals.
+"""Run the benchmarks from the command line.
+
+.. code-block:: bash
+
+    python -m qiskit_metal.benchmarks --help
+"""
+
+import argparse
+import json
+import sys
+
+from qiskit_metal import logger
+
+from .suite import OPTIONAL_STAGES, STAGES, run_benchmarks, save_results
+
+
+def main(argv=None) -> int:
+    """Run the benchmarks, and print or save the results.
+
+    Args:
+        argv (list): Command line arguments. Defaults to None, for sys.argv.
+
+    Returns:
+        int: 0 if all the stages ran, 1 if any failed.
+    """
+    parser = argparse.ArgumentParser(
+        prog='python -m qiskit_metal.benchmarks',
+        description='Time the pipeline on a synthetic qubit grid.')
+    parser.add_argument('--rows', type=int, default=3)
+    parser.add_argument('--cols', type=int, default=3)
+    parser.add_argument('--pitch', default='3mm')
+    parser.add_argument('--stages',
+                        nargs='+',
+                        default=list(STAGES),
+                        choices=STAGES + OPTIONAL_STAGES)
+    parser.add_argument('--repeat', type=int, default=1)
+    parser.add_argument('--profile',
+                        action='store_true',
+                        help='add the summary of the profiler')
+    parser.add_argument('--output', help='JSON file to write the results to')
+    parser.add_argument('--append',
+                        action='store_true',
+                        help='add the results as a line of the output file')
+    args = parser.parse_args(argv)
+
+    results = run_benchmarks(rows=args.rows,
+                             cols=args.cols,
+                             pitch=args.pitch,
+                             stages=args.stages,
+                             repeat=args.repeat,
+                             profile=args.profile,
+                             logger=logger)
+    if args.output:
+        save_results(results, args.output, append=args.append)
+    else:
+        json.dump(results.to_dict(), sys.stdout, indent=2)
+        print()
+    failed = any(result.status != 'ok' for result in results.stages.values())
+    return 1 if failed else 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
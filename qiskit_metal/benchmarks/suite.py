@@ -0,0 +1,274 @@
+# -*- coding: utf-8 -*-
+
+# This code is part of Qiskit.
+#
+# (C) Copyright IBM 2017, 2021.
+#
+# This code is licensed under the Apache License, Version 2.0. You may
+# obtain a copy of this license in the LICENSE.txt file in the root directory
+# of this source tree or at http://www.apache.org/licenses/LICENSE-2.0.
+#
+# Any modifications or derivative works of this code must retain this
+# copyright notice, and modified files need to carry a notice indicating
+# that they have been altered from the originals.
+"""Timing of the stages of the pipeline on a synthetic design.
+
+Each repeat builds a new qubit grid, see `synthetic`, and runs the stages in
+order on it.  The time of each stage is kept, with its error if it failed, so
+that a failing stage does not stop the others.
+"""
+
+import datetime
+import json
+import logging
+import os
+import platform
+import sys
+import tempfile
+import time
+from typing import Callable, Dict as Dict_, Sequence
+
+import matplotlib
+from matplotlib.figure import Figure
+import numpy as np
+import pandas as pd
+import shapely
+
+from qiskit_metal import Dict, __version__
+from qiskit_metal.analyses.quantization.lom_core_analysis import CircuitGraph
+from qiskit_metal.designs.design_base import QDesign
+from qiskit_metal.designs.design_multiplanar import MultiPlanar
+from qiskit_metal.designs.design_planar import DesignPlanar
+from qiskit_metal.renderers.renderer_gds.gds_renderer import QGDSRenderer
+from qiskit_metal.renderers.renderer_mpl.mpl_renderer import QMplRenderer
+from qiskit_metal.toolbox_python.profiler import profiler
+
+from .synthetic import add_bus_routes, grid_circuit, make_qubit_grid
+
+__all__ = ['STAGES', 'OPTIONAL_STAGES', 'run_benchmarks', 'save_results']
+
+STAGES = ('build', 'route', 'rebuild', 'gds_export', 'mpl_render', 'lom',
+          'save_load')
+"""Stages run by default, in order."""
+
+OPTIONAL_STAGES = ('gmsh_mesh',)
+"""Stages run only when asked for, as they need a full Gmsh install."""
+
+
+def _build(state: Dict):
+    """Add the qubit grid to a new design."""
+    design_class = MultiPlanar if 'gmsh_mesh' in state.stages else DesignPlanar
+    state.design = make_qubit_grid(state.rows,
+                                   state.cols,
+                                   pitch=state.pitch,
+                                   design=design_class())
+
+
+def _route(state: Dict):
+    """Connect the qubits of the grid with buses."""
+    add_bus_routes(state.design, state.rows, state.cols)
+
+
+def _rebuild(state: Dict):
+    """Rebuild all the components of the design."""
+    state.design.rebuild()
+
+
+def _gds_export(state: Dict):
+    """Export the design to GDS, with the cheesing of the main chip."""
+    gds = QGDSRenderer(state.design)
+    gds.options.cheese.view_in_file = Dict(main={1: True})
+    gds.options.no_cheese.view_in_file = Dict(main={1: True})
+    path = os.path.join(state.folder, 'benchmark.gds')
+    if not gds.export_to_gds(path):
+        raise RuntimeError('export_to_gds did not write the file.')
+
+
+def _mpl_render(state: Dict):
+    """Draw the qgeometry tables on a matplotlib axis."""
+    figure = Figure()
+    ax = figure.add_subplot(1, 1, 1)
+    QMplRenderer(None, state.design, state.design.logger).render(ax)
+
+
+def _lom(state: Dict):
+    """Reduce the lumped circuit of the grid, for the lumped oscillator
+    model."""
+    nodes, cmat, inductances, junctions = grid_circuit(state.rows, state.cols)
+    # Time the reduction itself, not a lookup of the previous repeat
+    CircuitGraph._topology_cache.clear()
+    circuit = CircuitGraph(nodes, 'ground', [cmat], [inductances], junctions)
+    _ = circuit.C_k, circuit.L_inv_k
+
+
+def _save_load(state: Dict):
+    """Save the design to a file and load it back."""
+    path = os.path.join(state.folder, 'benchmark.metal.pickle')
+    if not state.design.save_design(path):
+        raise RuntimeError('save_design did not write the file.')
+    if not isinstance(QDesign.load_design(path), QDesign):
+        raise RuntimeError('load_design did not give a design.')
+
+
+def _gmsh_mesh(state: Dict):
+    """Render the design in Gmsh and mesh it."""
+    # Imported here, so that the other stages run without gmsh
+    from qiskit_metal.renderers.renderer_gmsh.gmsh_renderer import \
+        QGmshRenderer
+
+    gmsh = QGmshRenderer(state.design)
+    try:
+        gmsh.render_design(mesh_geoms=True)
+        gmsh.add_mesh()
+    finally:
+        gmsh.close()
+
+
+_STAGE_FUNCTIONS = dict(build=_build,
+                        route=_route,
+                        rebuild=_rebuild,
+                        gds_export=_gds_export,
+                        mpl_render=_mpl_render,
+                        lom=_lom,
+                        save_load=_save_load,
+                        gmsh_mesh=_gmsh_mesh)  # type: Dict_[str, Callable]
+
+
+def _metadata() -> dict:
+    """Versions and machine the benchmarks ran on."""
+    return dict(qiskit_metal=__version__,
+                python=sys.version.split()[0],
+                numpy=np.__version__,
+                pandas=pd.__version__,
+                shapely=shapely.__version__,
+                matplotlib=matplotlib.__version__,
+                platform=platform.platform(),
+                processor=platform.processor(),
+                cpu_count=os.cpu_count(),
+                timestamp=datetime.datetime.now().astimezone().isoformat())
+
+
+def run_benchmarks(rows: int = 3,
+                   cols: int = 3,
+                   pitch: str = '3mm',
+                   stages: Sequence[str] = STAGES,
+                   repeat: int = 1,
+                   profile: bool = False,
+                   logger: logging.Logger = None) -> Dict:
+    """Time the stages of the pipeline on a rows x cols qubit grid.
+
+    Args:
+        rows (int): Number of rows of qubits. Defaults to 3.
+        cols (int): Number of columns of qubits. Defaults to 3.
+        pitch (str): Distance between neighboring qubits. Defaults to '3mm'.
+        stages (Sequence[str]): Stages to run, from STAGES and
+            OPTIONAL_STAGES.  They always run in the order of STAGES, then
+            OPTIONAL_STAGES.  'build' is always run.  Defaults to STAGES.
+        repeat (int): Number of times to run the stages, each on a new
+            design. Defaults to 1.
+        profile (bool): Add the summary of the module profiler, see
+            `qiskit_metal.toolbox_python.profiler`. Defaults to False.
+        logger (logging.Logger): Logger of the progress. Defaults to None,
+            for none.
+
+    Returns:
+        Dict: The results, which JSON can hold.  `metadata` has the versions
+        and the machine, `parameters` the arguments and the size of the
+        design, and `stages` has for each stage its `status` ('ok' or
+        'error'), the `times` of each repeat in seconds, their `min` and
+        `mean`, and the last `error`.  With profile, `profile` has one row
+        per span name of the profiler.
+
+    Raises:
+        ValueError: If a stage is unknown, or repeat is less than 1.
+    """
+    unknown = set(stages) - set(_STAGE_FUNCTIONS)
+    if unknown:
+        raise ValueError(f'Unknown benchmark stages {sorted(unknown)}. The '
+                         f'stages are {list(_STAGE_FUNCTIONS)}.')
+    if repeat < 1:
+        raise ValueError(f'repeat={repeat} must be at least 1.')
+    stages = [
+        stage for stage in _STAGE_FUNCTIONS
+        if stage in stages or stage == 'build'
+    ]
+
+    results = Dict(
+        metadata=_metadata(),
+        parameters=dict(rows=rows,
+                        cols=cols,
+                        pitch=pitch,
+                        repeat=repeat,
+                        stages=stages),
+        stages={
+            stage: dict(status='ok', times=[], error=None) for stage in stages
+        })
+
+    was_enabled = profiler.enabled
+    if profile:
+        profiler.reset()
+        profiler.enable()
+    try:
+        with tempfile.TemporaryDirectory() as folder:
+            for index in range(repeat):
+                state = Dict(rows=rows,
+                             cols=cols,
+                             pitch=pitch,
+                             stages=stages,
+                             folder=folder,
+                             design=None)
+                for stage in stages:
+                    result = results.stages[stage]
+                    start = time.perf_counter()
+                    try:
+                        with profiler.span(f'benchmark.{stage}'):
+                            _STAGE_FUNCTIONS[stage](state)
+                    except Exception as error:  # pylint: disable=broad-except
+                        result.status = 'error'
+                        result.error = f'{type(error).__name__}: {error}'
+                        if logger:
+                            logger.warning(
+                                f'Benchmark stage {stage} failed: {error}')
+                        if state.design is None:
+                            break
+                        continue
+                    result.times.append(time.perf_counter() - start)
+                    if logger:
+                        logger.info(f'Benchmark {index + 1}/{repeat}: {stage} '
+                                    f'in {result.times[-1]:.3f} s')
+                if state.design is not None:
+                    results.parameters.update(
+                        num_components=len(state.design.components),
+                        num_qgeometry_rows={
+                            name: len(table) for name, table in
+                            state.design.qgeometry.tables.items()
+                        })
+    finally:
+        profiler.enabled = was_enabled
+
+    for result in results.stages.values():
+        result.min = min(result.times) if result.times else None
+        result.mean = float(np.mean(result.times)) if result.times else None
+
+    if profile:
+        summary = profiler.summary().reset_index()
+        results.profile = json.loads(summary.to_json(orient='records'))
+    return results
+
+
+def save_results(results: Dict, path: str, append: bool = False):
+    """Write the results of run_benchmarks() to a JSON file.
+
+    Args:
+        results (Dict): The results of run_benchmarks().
+        path (str): Path of the file to write.
+        append (bool): Add the results as a line of a JSON lines file, to
+            track them over time. Defaults to False, to overwrite the file
+            with them.
+    """
+    if append:
+        with open(path, 'a') as file:
+            file.write(json.dumps(results.to_dict()) + '\n')
+    else:
+        with open(path, 'w') as file:
+            json.dump(results.to_dict(), file, indent=2)
@@ -0,0 +1,208 @@
+# -*- coding: utf-8 -*-
+
+# This code is part of Qiskit.
+#
+# (C) Copyright IBM 2017, 2021.
+#
+# This code is licensed under the Apache License, Version 2.0. You may
+# obtain a copy of this license in the LICENSE.txt file in the root directory
+# of this source tree or at http://www.apache.org/licenses/LICENSE-2.0.
+#
+# Any modifications or derivative works of this code must retain this
+# copyright notice, and modified files need to carry a notice indicating
+# that they have been altered from the originals.
+"""Parameterized synthetic designs for the benchmarks.
+
+A grid of TransmonPocket qubits, each with a connection pad in every corner.
+Neighbors in a row are connected by RouteMeander buses, and neighbors in a
+column by RoutePathfinder buses.
+"""
+
+from typing import Dict as Dict_, List, Tuple
+
+import numpy as np
+import pandas as pd
+
+from qiskit_metal import Dict
+from qiskit_metal.designs.design_base import QDesign
+from qiskit_metal.designs.design_planar import DesignPlanar
+from qiskit_metal.qlibrary.qubits.transmon_pocket import TransmonPocket
+from qiskit_metal.qlibrary.tlines.meandered import RouteMeander
+from qiskit_metal.qlibrary.tlines.pathfinder import RoutePathfinder
+
+__all__ = ['qubit_name', 'make_qubit_grid', 'add_bus_routes', 'grid_circuit']
+
+# Connection pads of each qubit: name -> (loc_W, loc_H)
+PADS = Dict(ne=('+1', '+1'), nw=('-1', '+1'), se=('+1', '-1'), sw=('-1', '-1'))
+
+
+def qubit_name(row: int, col: int) -> str:
+    """Name of the qubit at row and col of the grid."""
+    return f'Q_{row}_{col}'
+
+
+def make_qubit_grid(rows: int,
+                    cols: int,
+                    pitch: str = '3mm',
+                    design: QDesign = None) -> QDesign:
+    """Add a rows x cols grid of TransmonPocket qubits to a design.
+
+    The chip is sized to hold the grid, with a margin of one pitch.
+
+    Args:
+        rows (int): Number of rows of qubits.
+        cols (int): Number of columns of qubits.
+        pitch (str): Distance between neighboring qubits. Defaults to '3mm'.
+        design (QDesign): Design to add the qubits to. Defaults to None,
+            for a new DesignPlanar.
+
+    Returns:
+        QDesign: The design.
+    """
+    if design is None:
+        design = DesignPlanar()
+    design.overwrite_enabled = True
+    spacing = design.parse_value(pitch)
+    units = design.get_units()
+    design.chips.main.size.size_x = f'{(cols + 1) * spacing}{units}'
+    design.chips.main.size.size_y = f'{(rows + 1) * spacing}{units}'
+    design.chips.main.size.center_x = f'{(cols - 1) * spacing / 2}{units}'
+    design.chips.main.size.center_y = f'{-(rows - 1) * spacing / 2}{units}'
+
+    connection_pads = Dict({
+        name: Dict(loc_W=loc_w, loc_H=loc_h)
+        for name, (loc_w, loc_h) in PADS.items()
+    })
+    for row in range(rows):
+        for col in range(cols):
+            TransmonPocket(design,
+                           qubit_name(row, col),
+                           options=dict(pos_x=f'{col * spacing}{units}',
+                                        pos_y=f'{-row * spacing}{units}',
+                                        connection_pads=connection_pads))
+    return design
+
+
+def add_bus_routes(design: QDesign,
+                   rows: int,
+                   cols: int,
+                   total_length: str = '5mm') -> List[str]:
+    """Connect the neighbors of a qubit grid made by make_qubit_grid().
+
+    Neighbors in a row are connected by a RouteMeander of total_length, from
+    the north-east pad to the south-west pad.  Neighbors in a column are
+    connected by a RoutePathfinder, from the south-east pad to the
+    north-west pad, so that each pad holds a single route.
+
+    Args:
+        design (QDesign): Design with the qubit grid.
+        rows (int): Number of rows of qubits.
+        cols (int): Number of columns of qubits.
+        total_length (str): Length of the meandered buses.
+            Defaults to '5mm'.
+
+    Returns:
+        List[str]: Names of the routes.
+    """
+    names = []
+
+    def pins(start: str, start_pin: str, end: str, end_pin: str) -> Dict:
+        return Dict(start_pin=Dict(component=start, pin=start_pin),
+                    end_pin=Dict(component=end, pin=end_pin))
+
+    for row in range(rows):
+        for col in range(cols):
+            if col + 1 < cols:
+                name = f'bus_h_{row}_{col}'
+                RouteMeander(design,
+                             name,
+                             options=Dict(pin_inputs=pins(
+                                 qubit_name(row, col), 'ne',
+                                 qubit_name(row, col + 1), 'sw'),
+                                          total_length=total_length,
+                                          fillet='50um',
+                                          meander=Dict(spacing='200um'),
+                                          lead=Dict(start_straight='100um',
+                                                    end_straight='100um')))
+                names.append(name)
+            if row + 1 < rows:
+                name = f'bus_v_{row}_{col}'
+                RoutePathfinder(design,
+                                name,
+                                options=Dict(pin_inputs=pins(
+                                    qubit_name(row, col), 'se',
+                                    qubit_name(row + 1, col), 'nw'),
+                                             fillet='90um',
+                                             lead=Dict(start_straight='100um',
+                                                       end_straight='100um'),
+                                             step_size='0.25mm'))
+                names.append(name)
+    return names
+
+
+def grid_circuit(
+    rows: int,
+    cols: int,
+    c_pad: float = 100.,
+    c_junction: float = 30.,
+    c_coupling: float = 2.,
+    l_junction: float = 10.
+) -> Tuple[List[str], pd.DataFrame, Dict_[Tuple[str, str], float], Dict_[Tuple[
+        str, str], str]]:
+    """Synthetic lumped circuit of a qubit grid, in the form taken by
+    CircuitGraph.
+
+    Each qubit has two pads joined by a junction.  The pads of neighboring
+    qubits are coupled by the buses.
+
+    Args:
+        rows (int): Number of rows of qubits.
+        cols (int): Number of columns of qubits.
+        c_pad (float): Capacitance of each pad to ground, in fF.
+            Defaults to 100.
+        c_junction (float): Capacitance between the two pads of a qubit, in
+            fF. Defaults to 30.
+        c_coupling (float): Capacitance between pads of neighbors, in fF.
+            Defaults to 2.
+        l_junction (float): Inductance of each junction, in nH.
+            Defaults to 10.
+
+    Returns:
+        Tuple: The node names, starting with 'ground', the Maxwell
+        capacitance matrix, the inductances as {(pad, pad): value}, and the
+        junctions as {(pad, pad): name}.
+    """
+    nodes = ['ground']
+    inductances = dict()
+    junctions = dict()
+    for row in range(rows):
+        for col in range(cols):
+            name = qubit_name(row, col)
+            nodes += [f'{name}_pad1', f'{name}_pad2']
+            inductances[(f'{name}_pad1', f'{name}_pad2')] = l_junction
+            junctions[(f'{name}_pad1', f'{name}_pad2')] = f'j_{name}'
+
+    index = {node: i for i, node in enumerate(nodes)}
+    branches = np.zeros((len(nodes), len(nodes)))
+
+    def couple(node1: str, node2: str, value: float):
+        branches[index[node1], index[node2]] = value
+        branches[index[node2], index[node1]] = value
+
+    for row in range(rows):
+        for col in range(cols):
+            name = qubit_name(row, col)
+            couple(f'{name}_pad1', 'ground', c_pad)
+            couple(f'{name}_pad2', 'ground', c_pad)
+            couple(f'{name}_pad1', f'{name}_pad2', c_junction)
+            if col + 1 < cols:
+                couple(f'{name}_pad2', f'{qubit_name(row, col + 1)}_pad1',
+                       c_coupling)
+            if row + 1 < rows:
+                couple(f'{name}_pad2', f'{qubit_name(row + 1, col)}_pad1',
+                       c_coupling)
+
+    # Maxwell matrix: the diagonal holds the sum of the branches of a node
+    maxwell = np.diag(branches.sum(axis=1)) - branches
+    cmat = pd.DataFrame(maxwell, index=nodes, columns=nodes)
+    return nodes, cmat, inductances, junctions
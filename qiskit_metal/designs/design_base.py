@@ -17,7 +17,8 @@ import importlib
 #import inspect
 #import os
 from datetime import datetime
-from typing import Any, Dict as Dict_, Iterable, List, TYPE_CHECKING, Union
+from typing import (Any, Callable, Dict as Dict_, Iterable, List, TYPE_CHECKING,
+                    Union)
 
 import pandas as pd
 
@@ -28,6 +29,7 @@ from qiskit_metal.designs.net_info import QNet
 from qiskit_metal import Dict, config, logger
 from qiskit_metal.config import DefaultMetalOptions, DefaultOptionsRenderer
 from qiskit_metal.toolbox_metal.exceptions import QiskitMetalDesignError
+from qiskit_metal.toolbox_python.profiler import profiled
 
 if not config.is_building_docs():
     from qiskit_metal.toolbox_metal.import_export import load_metal_design, save_metal
@@ -112,6 +114,10 @@ class QDesign():
         # Cache for component ids.  Hold the reverse of _components dict,
         self.name_to_id = Dict()
 
+        # Called with (event, component_id) when components are added,
+        # deleted, renamed or built, see add_component_listener
+        self._component_listeners = []
+
         self._variables = Dict()
         self._chips = Dict()
 
@@ -145,6 +151,9 @@ class QDesign():
         # Dict used to populate the columns of QGeometry table i.e. path,
         # junction, poly etc.
         self.renderer_defaults_by_table = Dict()
+        # Renderer columns for each set of tables, see
+        # get_renderer_defaults_for_tables. Cleared when a renderer adds data.
+        self._renderer_defaults_cache = dict()
 
         # Instantiate and register renderers to Qdesign.renderers
         self._renderers = Dict()
@@ -159,6 +168,17 @@ class QDesign():
         # Assign unique name to this design
         self.name = self._assign_name_design()
 
+    def __getstate__(self) -> dict:
+        """The component listeners, often GUI objects, are not saved."""
+        state = self.__dict__.copy()
+        state['_component_listeners'] = []
+        return state
+
+    def __setstate__(self, state: dict):
+        """Designs saved before the component listeners get none."""
+        state.setdefault('_component_listeners', [])
+        self.__dict__.update(state)
+
     def _assign_name_design(self, name: str = "Design") -> str:
         # TODO: make this name unique, for when we will have multiple designs
         return name
@@ -298,6 +318,47 @@ class QDesign():
 
 #########General methods###################################################
 
+    def add_component_listener(self, listener: Callable[[str, int], None]):
+        """Call the listener on each change of the components of the design,
+        such as to update a view of them without polling the design.
+
+        The listener is called with the event and the id of the component.
+        The events are:
+
+            * 'added': The component was added to the design
+            * 'deleted': The component was deleted from the design
+            * 'renamed': The component has a new name
+            * 'status': The component was built, its status may have changed
+            * 'cleared': All the components were deleted, the id is None
+
+        The 'status' events come from the thread which rebuilds the
+        component, which is not always the main one.
+
+        Args:
+            listener (Callable[[str, int], None]): The listener
+        """
+        if listener not in self._component_listeners:
+            self._component_listeners.append(listener)
+
+    def remove_component_listener(self, listener: Callable[[str, int], None]):
+        """Stop calling a listener added by add_component_listener.
+
+        Args:
+            listener (Callable[[str, int], None]): The listener
+        """
+        if listener in self._component_listeners:
+            self._component_listeners.remove(listener)
+
+    def _notify_component_listeners(self, event: str, component_id: int):
+        """Call the component listeners, see add_component_listener.
+
+        Args:
+            event (str): The event, such as 'added'
+            component_id (int): Id of the component, or None for 'cleared'
+        """
+        for listener in list(self._component_listeners):
+            listener(event, component_id)
+
     def rename_variable(self, old_key: str, new_key: str):
         """Renames a variable in the variables dictionary. Preserves order.
 
@@ -312,6 +373,53 @@ class QDesign():
         keys[keys.index(old_key)] = new_key
         self._variables = Dict(zip(keys, values))
 
+    def variable_dependents(self, variable_names: Iterable[str]) -> List[str]:
+        """Names of the components to remake after a change of the given
+        variables: the components whose options resolved through them in
+        their latest build, those which did not build successfully, and, in
+        turn, the components attached to any of these through their
+        pin_inputs, such as routes.
+
+        Example:
+            .. code-block:: python
+
+                design.variables['cpw_width'] = '12 um'
+                design.rebuild(design.variable_dependents(['cpw_width']))
+
+        Args:
+            variable_names (Iterable[str]): Names of the changed, added,
+                renamed or deleted variables.
+
+        Returns:
+            List[str]: Names of the components, in the order of the design.
+        """
+        variable_names = set(variable_names)
+        dependents = set(
+            comp_id for comp_id, comp in self._components.items()
+            if comp.status != 'good' or variable_names & comp.variables_used)
+
+        # Follow the pin_inputs, until no component is added
+        added = bool(dependents)
+        while added:
+            added = False
+            for comp_id, comp in self._components.items():
+                if comp_id in dependents:
+                    continue
+                for pin_input in (comp.options.get('pin_inputs') or
+                                  {}).values():
+                    attached = pin_input.get('component')
+                    attached = self.name_to_id.get(attached, attached)
+                    if attached in dependents:
+                        dependents.add(comp_id)
+                        added = True
+                        break
+
+        return [
+            comp.name
+            for comp_id, comp in self._components.items()
+            if comp_id in dependents
+        ]
+
     def delete_all_pins(self) -> 'QNet':
         """Clear all pins in the net_Info and update the pins in components.
 
@@ -439,6 +547,10 @@ class QDesign():
         self._components.clear()
 
         self._qgeometry.clear_all_tables()
+        # Pick up the edits of the default options of the component classes
+        from qiskit_metal.qlibrary.core.base import QComponent  # pylint: disable=import-outside-toplevel
+        QComponent.clear_children_cache()
+        self._notify_component_listeners('cleared', None)
 
     def _get_new_qcomponent_id(self):
         """Give new id that QComponent can use.
@@ -463,10 +575,43 @@ class QDesign():
 
         return self._qcomponent_latest_name_id[prefix]
 
-    def rebuild(self):  # remake_all_components
-        """Remakes all components with their current parameters."""
-        for _, obj in self._components.items():  # pylint: disable=unused-variable
+    @profiled('QDesign.rebuild')
+    def rebuild(self,
+                component_names: List[str] = None,
+                stop: Callable[[], bool] = None,
+                progress: Callable[[int, int, str], None] = None) -> bool:
+        """Remakes components with their current parameters.
+
+        Args:
+            component_names (List[str]): Names of the components to remake,
+                in order.  Names of components which no longer exist are
+                skipped. Defaults to None, for all the components.
+            stop (Callable[[], bool]): Called before each make; the rebuild
+                stops when it returns True, such as when a background rebuild
+                is cancelled. Defaults to None.
+            progress (Callable[[int, int, str], None]): Called after each make,
+                with the number of components made, their total and the name
+                of the last one. Defaults to None.
+
+        Returns:
+            bool: True if all the components were remade, False if stop ended
+            the rebuild early.
+        """
+        if component_names is None:
+            components = list(self._components.values())
+        else:
+            components = [
+                self._components[self.name_to_id[name]]
+                for name in component_names
+                if name in self.name_to_id
+            ]
+        for index, obj in enumerate(components):
+            if stop is not None and stop():
+                return False
             obj.rebuild()
+            if progress is not None:
+                progress(index + 1, len(components), obj.name)
+        return True
 
     def rename_component(self, component_id: int, new_component_name: str):
         """Rename component.  The component_id is expected.  However, if user
@@ -525,6 +670,7 @@ class QDesign():
             # do rename
             # pylint: disable=protected-access
             self._components[component_id]._name = new_component_name
+            self._notify_component_listeners('renamed', a_component.id)
 
             return True
         logger.warning(
@@ -623,6 +769,7 @@ class QDesign():
 
             # remove from design dict of components
             self._components.pop(component_id, None)
+            self._notify_component_listeners('deleted', component_id)
         else:
             # if not in components dict
             logger.warning(
@@ -1028,8 +1175,37 @@ class QDesign():
             status.add(4)
             status.add(5)
 
+        self._renderer_defaults_cache = dict()
         return status
 
+    def get_renderer_defaults_for_tables(self, tables: Iterable[str]) -> dict:
+        """Default values of the columns that the renderers add to some of the
+        QGeometry tables, as populated by add_default_data_for_qgeometry_tables.
+
+        The result is computed once per set of tables, and cached until a
+        renderer adds data.  It is shared, so do not modify it.
+
+        Args:
+            tables (Iterable[str]): Table names, i.e. path, poly, junction.
+
+        Returns:
+            dict: The key is the column name f'{renderer_name}_{column_name}'
+            and the value is the default value of the column.
+        """
+        key = tuple(tables)
+        cache = self.__dict__.setdefault('_renderer_defaults_cache', dict())
+        if key not in cache:
+            all_renderers_key_value = dict()
+            for table in key:
+                if table in self.renderer_defaults_by_table:
+                    for name_renderer, renderer_data in self.renderer_defaults_by_table[
+                            table].items():
+                        for col_name, col_value in renderer_data.items():
+                            render_col_name = f'{name_renderer}_{col_name}'
+                            all_renderers_key_value[render_col_name] = col_value
+            cache[key] = all_renderers_key_value
+        return cache[key]
+
     def get_list_of_tables_in_metadata(self, a_metadata: dict) -> list:
         """Look at the metadata dict to get list of tables the component uses.
 
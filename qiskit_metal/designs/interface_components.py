@@ -207,6 +207,10 @@ class Components:
             QComponent: Class which describes the component. None if
                         name not found in design._components.
         """
+        if name.startswith('__'):
+            # Dunder lookups, e.g. __setstate__ while unpickling, happen
+            # before self.components exists.
+            raise AttributeError(name)
         quiet = True
         return self.__getitem__(name, quiet)
 
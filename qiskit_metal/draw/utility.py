@@ -184,6 +184,25 @@ def round_coordinate_sequence(geom_ref, precision):
     return new_geom_ref
 
 
+def snap_to_grid(geom_ref, dbu: float):
+    """Snaps the vertices of geometries to the integer multiples of a
+    database unit, as in the GDS format.
+
+    The snapped coordinates are exactly `n * dbu` for an integer `n`, so that
+    equal vertices compare equal, unlike decimal rounding through WKT.
+
+    Args:
+        geom_ref (shapely.geometry or np.ndarray) : A shapely geometry, or an
+            array of them
+        dbu (float) : The database unit, in the design units (eg. 1e-6 for
+            1 nm in mm)
+    Returns:
+        shapely.geometry or np.ndarray : The snapped geometry, or array of them
+    """
+    return shapely.transform(geom_ref,
+                             lambda coords: np.rint(coords / dbu) * dbu)
+
+
 #########################################################################
 # POINT LIST FUNCTIONS
 
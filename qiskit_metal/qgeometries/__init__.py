@@ -27,6 +27,8 @@ QGeometryTables
     :toctree: ../stubs/
 
     QGeometryTables
+    ComponentTables
 
 """
 from .qgeometries_handler import is_qgeometry_table, QGeometryTables  # , QGeometry Types
+from .component_tables import ComponentTables
@@ -0,0 +1,646 @@
+# -*- coding: utf-8 -*-
+
+# This code is part of Qiskit.
+#
+# (C) Copyright IBM 2017, 2021.
+#
+# This code is licensed under the Apache License, Version 2.0. You may
+# obtain a copy of this license in the LICENSE.txt file in the root directory
+# of this source tree or at http://www.apache.org/licenses/LICENSE-2.0.
+#
+# Any modifications or derivative works of this code must retain this
+# copyright notice, and modified files need to carry a notice indicating
+# that they have been altered from the originals.
+"""Storage of the qgeometry tables, partitioned by component.
+
+See the docstring of `ComponentTables`
+"""
+
+import hashlib
+from collections.abc import MutableMapping
+from typing import Any, Dict as Dict_, Iterable, Iterator, List, Tuple, Union
+
+import numpy as np
+import pandas as pd
+import shapely
+from geopandas import GeoDataFrame
+
+from ..draw.utility import snap_to_grid
+
+__all__ = ['ComponentTables', 'FixedPointFrame']
+
+# Geometry types which shapely.to_ragged_array encodes
+_RAGGED_TYPES = (shapely.GeometryType.POINT, shapely.GeometryType.LINESTRING,
+                 shapely.GeometryType.POLYGON, shapely.GeometryType.MULTIPOINT,
+                 shapely.GeometryType.MULTILINESTRING,
+                 shapely.GeometryType.MULTIPOLYGON)
+
+
+class FixedPointFrame():
+    """Rows of a component, whose geometry is stored as int64 multiples of a
+    database unit instead of shapely objects.
+
+    The geometry column is kept in the ragged array form of
+    `shapely.to_ragged_array`: the coordinates of all the rows in one
+    array, and the offsets of the rings, parts and rows into it.  The other
+    columns are kept in a DataFrame.  `to_frame()` builds the GeoDataFrame,
+    with the shapely geometry, again.
+    """
+
+    def __init__(self, values: pd.DataFrame, columns: List[str], dbu: float,
+                 geom_type: shapely.GeometryType, coords: np.ndarray,
+                 offsets: Tuple[np.ndarray, ...]):
+        """
+        Args:
+            values (pd.DataFrame): The columns other than geometry.
+            columns (List[str]): All the columns, in their order.
+            dbu (float): Database unit.
+            geom_type (shapely.GeometryType): Type of the geometry of all rows.
+            coords (np.ndarray): The (n, 2) int64 coordinates.
+            offsets (Tuple[np.ndarray, ...]): Offsets, as in
+                `shapely.from_ragged_array`.
+        """
+        self.values = values
+        self.columns = columns
+        self.dbu = dbu
+        self.geom_type = geom_type
+        self.coords = coords
+        self.offsets = offsets
+
+    @classmethod
+    def encode(cls, frame: GeoDataFrame,
+               dbu: float) -> Union['FixedPointFrame', GeoDataFrame]:
+        """Store the geometry of frame as int64 multiples of dbu, which also
+        snaps it to dbu.
+
+        Args:
+            frame (GeoDataFrame): Rows of a component.
+            dbu (float): Database unit.
+
+        Returns:
+            Union[FixedPointFrame, GeoDataFrame]: frame itself, if its
+            geometry has no ragged array form: rows of several types,
+            missing, empty or 3D geometries, or no rows.
+        """
+        geometry = np.asarray(frame['geometry'], dtype=object)
+        if len(geometry) == 0:
+            return frame
+        type_ids = shapely.get_type_id(geometry)
+        if (np.any(type_ids != type_ids[0]) or
+                type_ids[0] not in _RAGGED_TYPES or
+                np.any(shapely.is_empty(geometry)) or
+                np.any(shapely.has_z(geometry))):
+            return frame
+        geom_type, coords, offsets = shapely.to_ragged_array(geometry)
+        coords = np.rint(coords / dbu).astype(np.int64)
+        # Shared with the merged frames and the cached arrays
+        coords.flags.writeable = False
+        return cls(pd.DataFrame(frame.drop(columns='geometry')),
+                   list(frame.columns), dbu, geom_type, coords,
+                   tuple(np.asarray(level, dtype=np.int64)
+                         for level in offsets))
+
+    @classmethod
+    def concat(cls, parts: List[Any]) -> Union['FixedPointFrame', None]:
+        """The rows of all the parts, in one FixedPointFrame.
+
+        Args:
+            parts (List[Any]): FixedPointFrames or GeoDataFrames.
+
+        Returns:
+            Union[FixedPointFrame, None]: None if a part is not a
+            FixedPointFrame, or they differ in geometry type or unit.
+        """
+        if not parts or not all(
+                isinstance(part, cls) and part.geom_type == parts[0].geom_type
+                and part.dbu == parts[0].dbu for part in parts):
+            return None
+        if len(parts) == 1:
+            return parts[0]
+        offsets = []
+        for level in range(len(parts[0].offsets)):
+            # Each level indexes into the one below, which grows part by part
+            merged, shift = [np.zeros(1, dtype=np.int64)], 0
+            for part in parts:
+                merged.append(part.offsets[level][1:] + shift)
+                shift += part.offsets[level][-1]
+            offsets.append(np.concatenate(merged))
+        values = pd.concat([part.values for part in parts],
+                           axis=0,
+                           join='outer',
+                           ignore_index=True,
+                           sort=False,
+                           copy=False)
+        columns = list(values.columns)
+        columns.insert(parts[0].columns.index('geometry'), 'geometry')
+        return cls(values, columns, parts[0].dbu, parts[0].geom_type,
+                   np.concatenate([part.coords for part in parts]),
+                   tuple(offsets))
+
+    def __len__(self) -> int:
+        return len(self.values)
+
+    def to_frame(self) -> GeoDataFrame:
+        """The rows, with their shapely geometry.
+
+        Returns:
+            GeoDataFrame: A new frame.
+        """
+        geometry = shapely.from_ragged_array(self.geom_type,
+                                             self.coords * self.dbu,
+                                             self.offsets)
+        return GeoDataFrame(self.values.assign(geometry=geometry)[self.columns])
+
+    def assign(self, **columns) -> 'FixedPointFrame':
+        """Change columns other than the geometry, like DataFrame.assign.
+
+        Returns:
+            FixedPointFrame: A new frame, which shares the geometry.
+        """
+        return FixedPointFrame(self.values.assign(**columns), self.columns,
+                               self.dbu, self.geom_type, self.coords,
+                               self.offsets)
+
+    def row_starts(self) -> np.ndarray:
+        """Offsets of the coordinates of each row into `coords`.
+
+        Returns:
+            np.ndarray: Row i is `coords[starts[i]:starts[i + 1]]`.
+        """
+        if not self.offsets:
+            # Points, one coordinate per row
+            return np.arange(len(self.coords) + 1, dtype=np.int64)
+        starts = self.offsets[-1]
+        for level in reversed(self.offsets[:-1]):
+            starts = level[starts]
+        return starts
+
+    def row_bounds(self) -> np.ndarray:
+        """Bounds of each row, from the integer coordinates.
+
+        Returns:
+            np.ndarray: The (rows, 4) array of [minx, miny, maxx, maxy].
+        """
+        starts = self.row_starts()[:-1]
+        return np.concatenate(
+            (np.minimum.reduceat(self.coords, starts, axis=0),
+             np.maximum.reduceat(self.coords, starts, axis=0)),
+            axis=1) * self.dbu
+
+    def geometry_bytes(self) -> bytes:
+        """The geometry of all rows, for a digest.  The same rows give the
+        same bytes, however they are split between frames.
+
+        Returns:
+            bytes: Type, offsets and coordinates.
+        """
+        return b''.join([np.int64(self.geom_type).tobytes()] +
+                        [level.tobytes() for level in self.offsets] +
+                        [self.coords.tobytes()])
+
+
+class ComponentTables(MutableMapping):
+    """Dict of the qgeometry tables, keyed by table name ('poly', 'path',
+    etc.), which stores the rows of each component separately.
+
+    The rows added by a component are kept in their own frames, keyed by the
+    value of their `component` column.  Deleting, replacing or fetching the
+    rows of one component only touches that component's frames.
+
+    `tables[table_name]` is still a single GeoDataFrame with the rows of all
+    components, for the renderers.  It is assembled when first read, and then
+    cached until a component of that table changes.  It should be treated as
+    read-only: edit the geometry through QGeometryTables instead.
+
+    The bounds of each component, per table and chip, are also computed once
+    after each change of the component, and kept until the next change.  The
+    bounds of a selection of components, or of the whole design, are then
+    aggregated from these boxes without reading the geometry again.
+
+    Likewise, a fingerprint of the rows of each component is computed once
+    after each change, so that renderers can tell which components changed
+    since they last drew them.
+
+    With a database unit, `dbu`, the frames of each component are stored as
+    FixedPointFrames: their geometry is kept as int64 multiples of the unit,
+    which snaps it, and the shapely geometry is built when the rows are read,
+    through `tables[table_name]` or `get_component`.  The bounds and the
+    fingerprints are computed from the integer coordinates, without building
+    the geometry.  Rows whose geometry has no ragged array form, such as a
+    mix of polygons and lines in one frame, keep their shapely geometry.
+    """
+
+    def __init__(self):
+        # Empty, typed, table for each table name
+        self._empty = dict()  # type: Dict_[str, GeoDataFrame]
+        # Frames of each component: table name -> component -> list of frames
+        self._parts = dict()  # type: Dict_[str, Dict_[Any, List[GeoDataFrame]]]
+        # Assembled tables, for the table names which did not change
+        self._assembled = dict()  # type: Dict_[str, GeoDataFrame]
+        # Bounds of each component: component -> (table name, chip) -> box
+        self._bounds = dict()  # type: Dict_[Any, Dict_[Tuple, np.ndarray]]
+        # Bounds of all the components, per (chip, table names) query
+        self._total_bounds = dict()  # type: Dict_[Tuple, np.ndarray]
+        # Fingerprint of the rows of each component, in all tables
+        self._fingerprints = dict()  # type: Dict_[Any, str]
+        # Database unit, see set_dbu
+        self.dbu = None  # type: float
+        # Integer coordinates of each component, merged from its frames:
+        # component -> table name -> (coordinates, number of coordinates of
+        # each row)
+        self._fixed_point = dict(
+        )  # type: Dict_[Any, Dict_[str, Tuple[np.ndarray, np.ndarray]]]
+
+    def __setstate__(self, state: dict):
+        """Add the caches of attributes newer than the pickled tables."""
+        self.__dict__.update(state)
+        self.__dict__.setdefault('_fingerprints', dict())
+        self.__dict__.setdefault('dbu', None)
+        self.__dict__.setdefault('_fixed_point', dict())
+
+    def __getitem__(self, table_name: str) -> GeoDataFrame:
+        if table_name not in self._assembled:
+            frames = [
+                frame for comp_frames in self._parts[table_name].values()
+                for frame in comp_frames
+            ]
+            # Build the geometry of all the rows at once, when possible
+            merged = FixedPointFrame.concat(frames)
+            frames = [merged] if merged is not None else frames
+            self._assembled[table_name] = self._concat(
+                table_name, [self._load(frame) for frame in frames])
+        return self._assembled[table_name]
+
+    def _store(self, frame: GeoDataFrame) -> Union[FixedPointFrame,
+                                                   GeoDataFrame]:
+        """The form in which the rows of frame are kept."""
+        return FixedPointFrame.encode(frame, self.dbu) if self.dbu else frame
+
+    @staticmethod
+    def _load(frame: Union[FixedPointFrame, GeoDataFrame]) -> GeoDataFrame:
+        """The rows of a stored frame, with their shapely geometry."""
+        return frame.to_frame() if isinstance(frame,
+                                              FixedPointFrame) else frame
+
+    def __setitem__(self, table_name: str, table: GeoDataFrame):
+        """Replace a whole table, such as a new empty table."""
+        for component in self._parts.get(table_name, {}):
+            self._bounds.pop(component, None)
+            self._fingerprints.pop(component, None)
+            self._fixed_point.pop(component, None)
+        self._total_bounds.clear()
+        self._empty[table_name] = table.iloc[0:0]
+        self._parts[table_name] = {
+            component: [self._store(frame)]
+            for component, frame in table.groupby('component', sort=False)
+        } if len(table) else dict()
+        self._assembled[table_name] = table
+
+    def __delitem__(self, table_name: str):
+        for component in self._parts[table_name]:
+            self._bounds.pop(component, None)
+            self._fingerprints.pop(component, None)
+            self._fixed_point.pop(component, None)
+        self._total_bounds.clear()
+        del self._empty[table_name]
+        del self._parts[table_name]
+        self._assembled.pop(table_name, None)
+
+    def __iter__(self) -> Iterator[str]:
+        return iter(self._empty)
+
+    def __len__(self) -> int:
+        return len(self._empty)
+
+    def clear(self):
+        """Remove all the tables."""
+        self._empty.clear()
+        self._parts.clear()
+        self._assembled.clear()
+        self._bounds.clear()
+        self._total_bounds.clear()
+        self._fingerprints.clear()
+        self._fixed_point.clear()
+
+    def set_dbu(self, dbu: Union[float, None]):
+        """Change the database unit of the integer coordinates, and snap the
+        geometry of all the rows to it.  Without a unit, the rows are stored
+        with their shapely geometry again.
+
+        Args:
+            dbu (Union[float, None]): Database unit, or None for none.
+        """
+        self.dbu = dbu
+        for parts in self._parts.values():
+            for component, frames in parts.items():
+                frames = [self._load(frame) for frame in frames]
+                if dbu:
+                    # Also snaps the rows which keep their shapely geometry
+                    frames = [
+                        self._store(
+                            frame.assign(geometry=snap_to_grid(
+                                np.asarray(frame['geometry'], dtype=object),
+                                dbu))) for frame in frames
+                    ]
+                parts[component] = frames
+        self._assembled.clear()
+        self._bounds.clear()
+        self._total_bounds.clear()
+        self._fingerprints.clear()
+        self._fixed_point.clear()
+
+    def _changed(self, table_name: str, component: Any):
+        """Forget what was derived from the rows of component."""
+        self._assembled.pop(table_name, None)
+        self._bounds.pop(component, None)
+        self._fingerprints.pop(component, None)
+        self._fixed_point.pop(component, None)
+        self._total_bounds.clear()
+
+    def _concat(self, table_name: str,
+                frames: List[GeoDataFrame]) -> GeoDataFrame:
+        """Rows of frames, with the columns and types of the table."""
+        return pd.concat([self._empty[table_name]] + frames,
+                         axis=0,
+                         join='outer',
+                         ignore_index=True,
+                         sort=False,
+                         verify_integrity=False,
+                         copy=False)
+
+    def components(self, table_name: str) -> List[Any]:
+        """The components which have rows in a table.
+
+        Args:
+            table_name (str): Name of the table, such as 'poly'.
+
+        Returns:
+            list: Values of the `component` column.
+        """
+        return list(self._parts[table_name])
+
+    def append(self, table_name: str, component: Any, frame: GeoDataFrame):
+        """Add the rows of frame, which all belong to component.
+
+        Args:
+            table_name (str): Name of the table, such as 'poly'.
+            component (Any): Value of the `component` column of frame.
+            frame (GeoDataFrame): The new rows.
+        """
+        self._parts[table_name].setdefault(component, []).append(
+            self._store(frame))
+        self._changed(table_name, component)
+
+    def get_component(self, table_name: str, component: Any) -> GeoDataFrame:
+        """The rows of one component, in a table with all the columns.
+
+        Args:
+            table_name (str): Name of the table, such as 'poly'.
+            component (Any): Value of the `component` column.
+
+        Returns:
+            GeoDataFrame: The rows, indexed from 0.
+        """
+        frames = self._parts[table_name].get(component, [])
+        if len(frames) == 1 and list(frames[0].columns) == list(
+                self._empty[table_name].columns):
+            frame = self._load(frames[0])
+            return frame.copy() if frame is frames[0] else frame
+        table = self._concat(table_name,
+                             [self._load(frame) for frame in frames])
+        if frames:
+            # Keep the merged frame, so the next fetch is cheaper
+            stored = self._store(table)
+            self._parts[table_name][component] = [stored]
+            if stored is table:
+                table = table.copy()
+        return table
+
+    def delete_component(self, component: Any):
+        """Remove the rows of one component from all tables.
+
+        Args:
+            component (Any): Value of the `component` column.
+        """
+        for table_name, parts in self._parts.items():
+            if parts.pop(component, None) is not None:
+                self._changed(table_name, component)
+
+    def rename_component(self, component: Any, new_component: Any):
+        """Change the value of the `component` column of the rows of one
+        component.
+
+        Args:
+            component (Any): Current value of the `component` column.
+            new_component (Any): New value.
+        """
+        for table_name, parts in self._parts.items():
+            frames = parts.pop(component, None)
+            if frames is not None:
+                parts[new_component] = [
+                    frame.assign(component=new_component) for frame in frames
+                ]
+                self._changed(table_name, component)
+                self._bounds.pop(new_component, None)
+                self._fingerprints.pop(new_component, None)
+                self._fixed_point.pop(new_component, None)
+
+    def component_bounds(self, component: Any) -> Dict_[Tuple, np.ndarray]:
+        """Bounds of the rows of one component, computed once per change of
+        the component.
+
+        Args:
+            component (Any): Value of the `component` column.
+
+        Returns:
+            dict: The key is (table name, chip), the value is the array
+            [minx, miny, maxx, maxy] of the geometry of the component in
+            that table and chip.
+        """
+        if component not in self._bounds:
+            bounds = dict()
+            for table_name, parts in self._parts.items():
+                for frame in parts.get(component, []):
+                    if len(frame) == 0:
+                        continue
+                    if isinstance(frame, FixedPointFrame):
+                        boxes = frame.row_bounds()
+                        chips = frame.values['chip'].to_numpy()
+                    else:
+                        boxes = shapely.bounds(
+                            np.asarray(frame['geometry'], dtype=object))
+                        chips = frame['chip'].to_numpy()
+                    for chip in pd.unique(chips):
+                        rows = boxes[chips == chip]
+                        box = np.concatenate(
+                            (np.nanmin(rows[:, :2],
+                                       axis=0), np.nanmax(rows[:, 2:], axis=0)))
+                        bounds[table_name, chip] = self._union(
+                            [box, bounds.get((table_name, chip))])
+            self._bounds[component] = bounds
+        return self._bounds[component]
+
+    def fingerprint(self, component: Any) -> str:
+        """Digest of the rows of one component in all tables, computed once
+        per change of the component.
+
+        Two components, or one component before and after a rebuild, have the
+        same fingerprint when their rows hold the same geometry and values.
+
+        Args:
+            component (Any): Value of the `component` column.
+
+        Returns:
+            str: Hex digest, the same for the same rows.
+        """
+        if component not in self._fingerprints:
+            digest = hashlib.blake2b(digest_size=16)
+            for table_name, parts in self._parts.items():
+                frames = parts.get(component)
+                if not frames:
+                    continue
+                table = self._concat(table_name, [
+                    frame.values
+                    if isinstance(frame, FixedPointFrame) else frame
+                    for frame in frames
+                ])
+                digest.update(table_name.encode())
+                digest.update(repr(list(table.columns)).encode())
+                digest.update(
+                    self._hash_values(table.drop(columns='geometry')).tobytes())
+                merged = FixedPointFrame.concat(frames)
+                if merged is not None:
+                    # The integer coordinates, without building the geometry
+                    digest.update(merged.geometry_bytes())
+                    continue
+                geometry = np.concatenate([
+                    np.asarray(self._load(frame)['geometry'], dtype=object)
+                    for frame in frames
+                ])
+                for wkb in shapely.to_wkb(geometry):
+                    digest.update(wkb if wkb is not None else b'')
+            self._fingerprints[component] = digest.hexdigest()
+        return self._fingerprints[component]
+
+    def fixed_point(self,
+                    component: Any) -> Dict_[str, Tuple[np.ndarray, np.ndarray]]:
+        """Coordinates of the rows of one component, as int64 multiples of the
+        database unit, merged from its frames once per change of the
+        component.
+
+        Args:
+            component (Any): Value of the `component` column.
+
+        Returns:
+            dict: The key is the table name, the value is the (n, 2) int64
+            array of the coordinates of the rows of the component in that
+            table, and the number of coordinates of each row.
+        """
+        if component not in self._fixed_point:
+            fixed_point = dict()
+            for table_name, parts in self._parts.items():
+                frames = parts.get(component)
+                if not frames:
+                    continue
+                merged = FixedPointFrame.concat(frames)
+                if merged is not None:
+                    fixed_point[table_name] = (merged.coords,
+                                               np.diff(merged.row_starts()))
+                    continue
+                geometry = np.concatenate([
+                    np.asarray(self._load(frame)['geometry'], dtype=object)
+                    for frame in frames
+                ])
+                coords = shapely.get_coordinates(geometry)
+                fixed_point[table_name] = (np.rint(coords / self.dbu).astype(
+                    np.int64), shapely.get_num_coordinates(geometry))
+            self._fixed_point[component] = fixed_point
+        return self._fixed_point[component]
+
+    def table_fixed_point(self,
+                          table_name: str) -> Tuple[np.ndarray, np.ndarray]:
+        """Coordinates of all the rows of a table, as int64 multiples of the
+        database unit, in the order of the rows of `self[table_name]`.
+
+        Args:
+            table_name (str): Name of the table, such as 'poly'.
+
+        Returns:
+            Tuple[np.ndarray, np.ndarray]: The (n, 2) int64 coordinates, and
+            the offsets of the coordinates of each row.
+        """
+        arrays = [
+            self.fixed_point(component)[table_name]
+            for component, frames in self._parts[table_name].items()
+            if frames and table_name in self.fixed_point(component)
+        ]
+        if not arrays:
+            return np.zeros((0, 2), dtype=np.int64), np.zeros(1,
+                                                               dtype=np.int64)
+        coords = np.concatenate([coords for coords, _ in arrays])
+        counts = np.concatenate([counts for _, counts in arrays])
+        offsets = np.concatenate(([0], np.cumsum(counts))).astype(np.int64)
+        return coords, offsets
+
+    @staticmethod
+    def _hash_values(table: pd.DataFrame) -> np.ndarray:
+        """Hash of each row of the non-geometry columns of a table."""
+        try:
+            return pd.util.hash_pandas_object(table, index=False).to_numpy()
+        except TypeError:
+            # Unhashable cells, such as lists, are hashed by their repr
+            return pd.util.hash_pandas_object(table.astype(str),
+                                              index=False).to_numpy()
+
+    @staticmethod
+    def _union(
+            boxes: Iterable[Union[np.ndarray,
+                                  None]]) -> Union[np.ndarray, None]:
+        """Smallest box which contains all the boxes, None if there are
+        none."""
+        boxes = [box for box in boxes if box is not None]
+        if not boxes:
+            return None
+        boxes = np.array(boxes)
+        return np.concatenate((boxes[:, :2].min(axis=0), boxes[:,
+                                                               2:].max(axis=0)))
+
+    def bounds(self,
+               components: Iterable[Any] = None,
+               chip: str = None,
+               table_names: Iterable[str] = None) -> Union[np.ndarray, None]:
+        """Bounds of a selection of components, from the cached bounds of each
+        component.  The bounds of all the components are also cached.
+
+        Args:
+            components (Iterable[Any]): Values of the `component` column.
+                Defaults to None, for all the components.
+            chip (str): Only the geometry on this chip. Defaults to None, for
+                all the chips.
+            table_names (Iterable[str]): Only the geometry in these tables.
+                Defaults to None, for all the tables.
+
+        Returns:
+            Union[np.ndarray, None]: [minx, miny, maxx, maxy], or None if
+            there is no geometry in the selection.
+        """
+        table_names = None if table_names is None else tuple(table_names)
+        if components is None:
+            key = (chip, table_names)
+            if key not in self._total_bounds:
+                all_components = dict.fromkeys(
+                    component for parts in self._parts.values()
+                    for component in parts)
+                self._total_bounds[key] = self.bounds(all_components, chip,
+                                                      table_names)
+            return self._total_bounds[key]
+
+        boxes = []
+        for component in components:
+            for (table_name,
+                 box_chip), box in self.component_bounds(component).items():
+                if (chip is None or
+                        box_chip == chip) and (table_names is None or
+                                               table_name in table_names):
+                    boxes.append(box)
+        return self._union(boxes)
@@ -18,6 +18,7 @@ See the docstring of `QGeometryTables`
 
 import inspect
 import logging
+import numpy as np
 import pandas as pd
 import shapely
 
@@ -28,7 +29,9 @@ from geopandas import GeoDataFrame, GeoSeries
 
 from .. import Dict
 from ..draw import BaseGeometry
-from qiskit_metal.draw.utility import round_coordinate_sequence
+from .component_tables import ComponentTables
+from ..toolbox_python.profiler import profiled, profiler
+from qiskit_metal.draw.utility import round_coordinate_sequence, snap_to_grid
 
 from shapely.geometry.multipolygon import MultiPolygon  #to avoid MultiPolygons
 from .. import config
@@ -252,7 +255,7 @@ class QGeometryTables(object):
         """
         self._design = design
 
-        self._tables = Dict()
+        self._tables = ComponentTables()
 
         # Need to call after columns are added by add_renderer_extension is run by all the renderers.
         # self.create_tables()
@@ -267,10 +270,47 @@ class QGeometryTables(object):
         """Return the logger."""
         return self._design.logger
 
+    def __setstate__(self, state: dict):
+        """Convert the tables of designs saved before they were partitioned
+        by component."""
+        self.__dict__.update(state)
+        if not isinstance(self._tables, ComponentTables):
+            tables = ComponentTables()
+            for table_name, table in self._tables.items():
+                tables[table_name] = table
+            self._tables = tables
+
+    @property
+    def dbu(self) -> Union[float, None]:
+        """The database unit of the coordinates, set by `set_dbu`, or None
+        for float coordinates.
+
+        Returns:
+            Union[float, None]: Database unit, in the design units
+        """
+        return self._tables.dbu
+
+    def set_dbu(self, dbu: Union[str, float, None]):
+        """Set the database unit of the coordinates, and the `DBU` template
+        option of the design.
+
+        The qgeometry already in the tables is snapped to the new unit, and
+        the fingerprints of all the components change.
+
+        Args:
+            dbu (Union[str, float, None]): Database unit, such as '1 nm', or
+                None for float coordinates.
+        """
+        self.design.template_options.DBU = dbu
+        self._tables.set_dbu(float(self.parse_value(dbu)) if dbu else None)
+
     @property
     def tables(self) -> Dict_[str, GeoDataFrame]:
         """The dictionary of tables containing qgeometry.
 
+        The rows are stored per component, see ComponentTables. Each table
+        is assembled when read, so treat it as read-only.
+
         Returns:
             Dict_[str, GeoDataFrame]: The keys of this dictionary are
             also obtained from `self.get_element_types()`
@@ -377,6 +417,8 @@ class QGeometryTables(object):
             # Assign
             self.tables[table_name] = table
 
+        self.set_dbu(self.design.template_options.get('DBU'))
+
     def _validate_column_dictionary(self, table_name: str, column_dict: dict):
         """Validate A possible error here is if the user did not pass a valid
         data type.
@@ -436,6 +478,7 @@ class QGeometryTables(object):
             for k, v in rdict.get(renderer_key, {}).items()
         }
 
+    @profiled('QGeometryTables.add_qgeometry')
     def add_qgeometry(
             self,
             kind: str,
@@ -477,19 +520,28 @@ class QGeometryTables(object):
         #Checks if (any) of the geometry are MultiPolygons, and breaks them up into
         #individual polygons. Rounds the coordinate sequences of those values to avoid
         #numerical errors.
+        #With a database unit, the coordinates are snapped to its integer multiples
+        #instead, all at once.
         rounding_val = self.design.template_options['PRECISION']
+        dbu = self.dbu
         new_dict = Dict()
         for key, item in geometry.items():
             if isinstance(geometry[key], MultiPolygon):
                 temp_multi = geometry[key]
                 shape_count = 0
                 for shape_temp in temp_multi.geoms:
-                    new_dict[key + '_' +
-                             str(shape_count)] = round_coordinate_sequence(
-                                 shape_temp, rounding_val)
+                    new_dict[key + '_' + str(shape_count)] = (
+                        shape_temp if dbu else round_coordinate_sequence(
+                            shape_temp, rounding_val))
                     shape_count += 1
             else:
-                new_dict[key] = round_coordinate_sequence(item, rounding_val)
+                new_dict[key] = item if dbu else round_coordinate_sequence(
+                    item, rounding_val)
+
+        if dbu:
+            snapped = snap_to_grid(
+                np.asarray(list(new_dict.values()), dtype=object), dbu)
+            new_dict = Dict(zip(new_dict.keys(), snapped))
 
         geometry = new_dict
 
@@ -511,9 +563,6 @@ class QGeometryTables(object):
         #        options[keyC] = ???[keyC] -> alternative manner to pass options to the add_qgeometry function?
         #                                       instead have the add_qeometry in baseComponent generate the dict?
 
-        #Could we just append rather than make a new table each time? This seems slow
-        table = self.tables[kind]
-
         # assert that all names in options are in table columns! TODO: New approach will not be wanting
         #to do this (maybe check that all columns are in options?)
         df = GeoDataFrame.from_dict(geometry,
@@ -524,14 +573,9 @@ class QGeometryTables(object):
 
         df = df.assign(**options)
 
-        # Set new table. Unfortunately, this creates a new instance. Can just direct append
-        self.tables[kind] = pd.concat([table, df],
-                                      axis=0,
-                                      join='outer',
-                                      ignore_index=True,
-                                      sort=False,
-                                      verify_integrity=False,
-                                      copy=False)
+        # Only the rows of this component are touched
+        self._tables.append(kind, component_name, df)
+        profiler.count('qgeometry_rows', len(df))
 
     def check_lengths(self, geometry: shapely.geometry.base.BaseGeometry,
                       kind: str, component_name: str, **other_options):
@@ -589,12 +633,9 @@ class QGeometryTables(object):
             name (str): Name of component (case sensitive)
         """
         # TODO: Add unit test
-        # TODO: is this the best way to do this, or is there a faster way?
         a_comp = self.design.components[name]
         if a_comp is not None:
-            for table_name in self.tables:
-                df = self.tables[table_name]
-                self.tables[table_name] = df[df['component'] != a_comp.id]
+            self._tables.delete_component(a_comp.id)
 
     def delete_component_id(self, component_id: int):
         """Drop the components within the qgeometry.tables.
@@ -602,11 +643,7 @@ class QGeometryTables(object):
         Args:
             component_id (int): Unique number to describe the component.
         """
-        for table_name in self.tables:
-            df_table_name = self.tables[table_name]
-            # self.tables[table_name] = df_table_name.drop(df_table_name[df_table_name['component'] == component_id].index)
-            self.tables[table_name] = df_table_name[df_table_name['component']
-                                                    != component_id]
+        self._tables.delete_component(component_id)
 
     def get_component(
         self,
@@ -633,13 +670,12 @@ class QGeometryTables(object):
                 tables[table_name] = self.get_component(name, table_name)
             return tables
         else:
-            df = self.tables[table_name]
             a_comp = self.design.components[name]
             if a_comp is None:
                 # Component not found.
                 return None
             else:
-                return df[df.component == a_comp.id]
+                return self._tables.get_component(table_name, a_comp.id)
 
             # comp_id = self.design.components[name].id
             # return df[df.component == comp_id]
@@ -649,17 +685,104 @@ class QGeometryTables(object):
         """Returns a tuple containing minx, miny, maxx, maxy values for the
         bounds of the component as a whole.
 
+        The bounds are computed once after each build of the component, and
+        then read from the cache.
+
         Args:
             name (str): Component name
 
         Returns:
             Geometry: Bare element geometry
         """
-        gs = self.get_component_geometry(name)  # Pandas GeoSeries
-        if len(gs) == 0:
+        comp_id = self.design.components[name].id
+        bounds = self._tables.bounds([comp_id])
+        if bounds is None:
             return (0, 0, 0, 0)
         else:
-            return gs.total_bounds
+            return bounds.copy()
+
+    def get_bounds(
+        self,
+        component_ids: Iterable[int] = None,
+        chip: str = None,
+        table_names: Iterable[str] = None
+    ) -> Union[Tuple[float, float, float, float], None]:
+        """Returns minx, miny, maxx, maxy of the bounding box of a selection
+        of components, or of the whole design.
+
+        Aggregated from the cached bounds of each component, so the geometry
+        is not read again unless a component changed.
+
+        Args:
+            component_ids (Iterable[int]): Ids of the components. Defaults
+                to None, for all the components in the tables.
+            chip (str): Only the geometry on this chip. Defaults to None, for
+                all the chips.
+            table_names (Iterable[str]): Only the geometry in these tables,
+                such as ['path', 'poly']. Defaults to None, for all tables.
+
+        Returns:
+            Union[Tuple[float, float, float, float], None]: The bounds, or None
+            if there is no geometry in the selection.
+        """
+        bounds = self._tables.bounds(component_ids, chip, table_names)
+        if bounds is None:
+            return None
+        return tuple(bounds)
+
+    def get_fixed_point_coordinates(
+            self, table_name: str) -> Tuple[np.ndarray, np.ndarray]:
+        """Returns the coordinates of a table as integer multiples of the
+        database unit, see `set_dbu`.
+
+        The coordinates of all rows are in one contiguous int64 array, in the
+        order of the rows of `tables[table_name]`.  They are exact: compare
+        or hash them instead of the shapely geometry.  With a database unit,
+        they are the form in which the tables store the geometry, see
+        `ComponentTables`, so no geometry is built to get them.
+
+        Args:
+            table_name (str): Name of the table, such as 'poly'.
+
+        Returns:
+            Tuple[np.ndarray, np.ndarray]: The (n, 2) int64 coordinates, and
+            the offsets of the rows: the coordinates of row i are
+            `coords[offsets[i]:offsets[i + 1]]`.
+
+        Raises:
+            ValueError: The design has no database unit.
+        """
+        if self.dbu is None:
+            raise ValueError('Set a database unit with set_dbu to get '
+                             'fixed-point coordinates.')
+        return self._tables.table_fixed_point(table_name)
+
+    def get_component_fingerprints(self,
+                                   component_ids: Iterable[int] = None
+                                  ) -> Dict_[int, str]:
+        """Returns a digest of the qgeometry rows of each component.
+
+        The digest of a component is computed once after each build of the
+        component, and then read from the cache.  Renderers compare them with
+        the digests of their last render, to redraw only the components which
+        changed.
+
+        Args:
+            component_ids (Iterable[int]): Ids of the components. Defaults
+                to None, for all the components in the tables.
+
+        Returns:
+            Dict_[int, str]: The key is the component id, the value is the
+            digest of its rows in all the tables.
+        """
+        if component_ids is None:
+            component_ids = dict.fromkeys(
+                component for table_name in self._tables
+                for component in self._tables.components(table_name))
+        return {
+            comp_id: self._tables.fingerprint(comp_id)
+            for comp_id in component_ids
+        }
 
     def rename_component(self, component_id: int, new_name: str):
         """Rename component by ID (integer) cast to string format.
@@ -675,10 +798,7 @@ class QGeometryTables(object):
         if a_comp is None:
             return None
         else:
-            # TODO: is this the best way to do this, or is there a faster way?
-            for table_name in self.tables:
-                table = self.tables[table_name]
-                table.component[table.component == a_comp.id] = new_name
+            self._tables.rename_component(a_comp.id, new_name)
 
     def get_component_geometry_list(self,
                                     name: str,
@@ -701,9 +821,9 @@ class QGeometryTables(object):
                 qgeometry += self.get_component_geometry_list(name, table)
 
         else:
-            table = self.tables[table_name]
             comp_id = self.design.components[name].id
-            qgeometry = table.geometry[table.component == comp_id].to_list()
+            qgeometry = self._tables.get_component(table_name,
+                                                   comp_id).geometry.to_list()
 
         return qgeometry
 
@@ -719,8 +839,8 @@ class QGeometryTables(object):
         comp_id = self.design.components[name].id
         qgeometry = {}
         for table_name in self.get_element_types():
-            table = self.tables[table_name]
-            qgeometry[table_name] = table.geometry[table.component == comp_id]
+            qgeometry[table_name] = self._tables.get_component(
+                table_name, comp_id).geometry
         qgeometry = pd.concat(qgeometry)
 
         # when concatenating empty GeoSeries, returns Series (ugly fix)
@@ -751,12 +871,10 @@ class QGeometryTables(object):
             return qgeometry  # return pd.concat(qgeometry, axis=0)
 
         else:
-            table = self.tables[table_name]
-
-            # mask the rows nad get only 2 columns
+            # get only 2 columns
             comp_id = self.design.components[name].id
-            df_comp_id = table.loc[table.component == comp_id,
-                                   ['name', 'geometry']]
+            df_comp_id = self._tables.get_component(
+                table_name, comp_id)[['name', 'geometry']]
             df_geometry = df_comp_id.geometry
             df_geometry.index = df_comp_id.name
             return df_geometry.to_dict()
@@ -806,10 +924,9 @@ class QGeometryTables(object):
         else:
             # Use just the component ID's in qcomp_ids.
             for table_key in self.tables:
-                temp_df = self.tables[table_key]
-                mask_temp = temp_df['component'].isin(qcomp_ids)
-                subset_temp_df = temp_df[mask_temp]
-                frames.append(subset_temp_df)
+                for qcomp_id in qcomp_ids:
+                    frames.append(
+                        self._tables.get_component(table_key, qcomp_id))
 
         #Concat the frames and then determine the unique layer numbers.
         unique_layers = list(
@@ -21,8 +21,9 @@ To see the docstring of QComponent in Jupyter notebook, use:
 import logging
 import inspect
 import random
+import time
 from copy import deepcopy
-from typing import TYPE_CHECKING, Any, Iterable, List, Union, Tuple, Dict as Dict_
+from typing import TYPE_CHECKING, Any, Callable, Iterable, List, Union, Tuple, Dict as Dict_
 from datetime import datetime
 import pandas as pd
 import numpy as np
@@ -37,6 +38,9 @@ from qiskit_metal import config
 from qiskit_metal.draw import BaseGeometry
 from qiskit_metal.toolbox_python.attr_dict import Dict
 from qiskit_metal.toolbox_python.display import format_dict_ala_z
+from qiskit_metal.toolbox_python.utility_functions import copy_options
+from qiskit_metal.toolbox_python.profiler import profiler
+from qiskit_metal.toolbox_metal.parsing import record_variables
 from qiskit_metal.qlibrary.core._parsed_dynamic_attrs import ParsedDynamicAttributes_Component
 
 if not config.is_building_docs():
@@ -44,6 +48,13 @@ if not config.is_building_docs():
 
 __all__ = ['QComponent']
 
+# Options and metadata gathered from the class hierarchy, per class.  Each
+# entry keeps the `default_options` or `component_metadata` dicts it was
+# gathered from, and is gathered again when one of them is replaced.
+# Edits within these dicts are picked up after QComponent.clear_children_cache
+_CHILDREN_OPTIONS = dict()
+_CHILDREN_METADATA = dict()
+
 if TYPE_CHECKING:
     # For linting typechecking, import modules that can't be loaded here under normal conditions.
     # For example, I can't import QDesign, because it requires QComponent first. We have the
@@ -184,6 +195,8 @@ class QComponent():
         # Make the id be None, which means it hasn't been added to design yet.
         self._id = None
         self._made = False
+        # Names looked up as design variables by the latest make
+        self._variables_used = set()
 
         self._component_template = component_template
 
@@ -274,12 +287,58 @@ class QComponent():
         Note: if keys are the same for child and grandchild,
         grandchild will overwrite child
 
-        Init method.
+        Init method.  The result is gathered once per class, see
+        `_cached_from_hierarchy`.  Only a shallow copy is returned: the nested
+        option dicts are shared with the cache, so callers must copy them
+        before changing them, as `get_template_options` does.
 
         Returns:
             dict: options from all children
         """
+        return cls._cached_from_hierarchy(_CHILDREN_OPTIONS, 'default_options',
+                                          cls._collect_children_options)
+
+    @classmethod
+    def _cached_from_hierarchy(cls, cache: dict, attribute: str,
+                               collect: Callable[[], dict]) -> dict:
+        """Shallow copy of the result of collect(), kept in cache until one of
+        the classes of the hierarchy gets a new `attribute` dict.
+
+        Args:
+            cache (dict): _CHILDREN_OPTIONS or _CHILDREN_METADATA.
+            attribute (str): 'default_options' or 'component_metadata'.
+            collect (Callable[[], dict]): Gathers the dicts of the hierarchy.
+
+        Returns:
+            dict: The gathered dict.
+        """
+        # The dicts themselves are kept, so that their ids are not reused
+        sources = tuple(
+            klass.__dict__[attribute]
+            for klass in inspect.getmro(cls)
+            if attribute in klass.__dict__)
+        cached = cache.get(cls)
+        if cached is None or len(cached[0]) != len(sources) or any(
+                old is not new for old, new in zip(cached[0], sources)):
+            cached = cache[cls] = (sources, collect())
+        return dict(cached[1])
+
+    @staticmethod
+    def clear_children_cache():
+        """Forget the options and metadata gathered from the class
+        hierarchies, so that edits within the `default_options` and
+        `component_metadata` dicts of the classes are used by the next
+        components.  Called by `QDesign.delete_all_components`."""
+        _CHILDREN_OPTIONS.clear()
+        _CHILDREN_METADATA.clear()
 
+    @classmethod
+    def _collect_children_options(cls) -> dict:
+        """Traverse the child classes to gather their `default_options`.
+
+        Returns:
+            dict: options from all children
+        """
         options_from_children = {}
         parents = inspect.getmro(cls)
 
@@ -305,24 +364,28 @@ class QComponent():
         gather the component_metadata for each child class.
 
         Note: if keys are the same for child and grandchild, grandchild will overwrite child
-        Init method.
+        Init method.  The result is gathered once per class, see
+        `_cached_from_hierarchy`, and a shallow copy is returned.
 
         Returns:
             dict: Metadata from all children.
         """
 
-        metadata_from_children = {}
-        parents = inspect.getmro(cls)
-        # Base.py is not expected to have component_metadata dict to add to design class.
-        for child in parents[len(parents) - 2::-1]:
-            # There is a developer agreement so the defaults will be in dict named component_metadata.
-            if hasattr(child, 'component_metadata'):
-                metadata_from_children = {
-                    **metadata_from_children,
-                    **child.component_metadata
-                }
-
-        return metadata_from_children
+        def collect() -> dict:
+            metadata_from_children = {}
+            parents = inspect.getmro(cls)
+            # Base.py is not expected to have component_metadata dict to add to design class.
+            for child in parents[len(parents) - 2::-1]:
+                # There is a developer agreement so the defaults will be in dict named component_metadata.
+                if hasattr(child, 'component_metadata'):
+                    metadata_from_children = {
+                        **metadata_from_children,
+                        **child.component_metadata
+                    }
+            return metadata_from_children
+
+        return cls._cached_from_hierarchy(_CHILDREN_METADATA,
+                                          'component_metadata', collect)
 
     @classmethod
     def _get_unique_class_name(cls) -> str:
@@ -405,6 +468,17 @@ class QComponent():
         """
         return self._design.logger
 
+    @property
+    def variables_used(self) -> set:
+        """The names of the design variables the options resolved through in
+        the latest build, see `QDesign.variable_dependents`.
+
+        Returns:
+            set: Names of the variables
+        """
+        # Components unpickled from designs saved before this was recorded
+        return getattr(self, '_variables_used', set())
+
     @property
     def pin_names(self) -> set:
         """The names of the pins.
@@ -433,6 +507,7 @@ class QComponent():
         # pylint: disable=protected-access
         self.design._components[self.id] = self
         self.design.name_to_id[self.name] = self._id
+        self.design._notify_component_listeners('added', self._id)
 
     @classmethod
     def get_template_options(cls,
@@ -482,8 +557,10 @@ class QComponent():
                     f'options for the component class {cls.__name__} are missing'
                 )
 
-        # Specific object template options
-        template_options = deepcopy(Dict(design.template_options[template_key]))
+        # Specific object template options.  The values are strings and numbers
+        # for the most part, so only the containers are copied.
+        template_options = copy_options(design.template_options[template_key],
+                                        dict_type=Dict)
 
         return template_options
 
@@ -700,20 +777,33 @@ name='{strname}'{other_args}
             Exception: Component build failure
         """
         self.status = 'failed'
+        start = time.perf_counter()
         try:
-            if self._made:  # already made, just remaking
-                self.design.qgeometry.delete_component_id(self.id)
-
-                # pylint: disable=protected-access
-                self.design._delete_all_pins_for_component(self.id)
-
-            self.make()
+            with profiler.span('QComponent.make',
+                               component=self.name,
+                               qclass=self.__class__.__name__) as span:
+                if self._made:  # already made, just remaking
+                    self.design.qgeometry.delete_component_id(self.id)
+
+                    # pylint: disable=protected-access
+                    self.design._delete_all_pins_for_component(self.id)
+
+                # Record the variables even when the make fails, so that
+                # defining or fixing them rebuilds this component
+                with record_variables() as used:
+                    try:
+                        self.make()
+                    finally:
+                        self._variables_used = used
             self._made = True
             self.status = 'good'
 
+            # With the profiler on, also log the counters of the make
+            counters = '' if span is None else ''.join(
+                f", {value} {key}" for key, value in span.counters.items())
             self.design.build_logs.add_success(
                 f"{str(datetime.now())} -- Component: {self.name} successfully built"
-            )
+                f" in {(time.perf_counter() - start) * 1e3:.1f} ms{counters}")
 
         except Exception as error:
             self.logger.error(
@@ -723,6 +813,10 @@ name='{strname}'{other_args}
             )
             raise error
 
+        finally:
+            # pylint: disable=protected-access
+            self.design._notify_component_listeners('status', self.id)
+
     def delete(self):
         """Delete the QComponent.
 
@@ -1122,7 +1216,7 @@ name='{strname}'{other_args}
             kind)
         for key in renderer_key_values:
             if key in self.options:
-                renderer_key_values[key] = deepcopy(self.options[key])
+                renderer_key_values[key] = copy_options(self.options[key])
 
         # # if not already in kwargs, add renderer information to it.
         renderer_and_options = {**renderer_key_values, **kwargs}
@@ -1152,18 +1246,7 @@ name='{strname}'{other_args}
         Returns:
             Dict: key is column names for tables, value is data for the column.
         """
-        all_renderers_key_value = dict()
-
-        # design.renderer_defaults_by_table[table_name][renderer_name][column_name]
-        if kind in self.design.renderer_defaults_by_table:
-            for name_renderer, renderer_data in self.design.renderer_defaults_by_table[
-                    kind].items():
-                if len(renderer_data) > 0:
-                    for col_name, col_value in renderer_data.items():
-                        render_col_name = f'{name_renderer}_{col_name}'
-                        all_renderers_key_value[render_col_name] = col_value
-
-        return all_renderers_key_value
+        return dict(self.design.get_renderer_defaults_for_tables((kind,)))
 
     @classmethod
     def _get_table_values_from_renderers(cls, design: 'QDesign') -> Dict:
@@ -1178,18 +1261,7 @@ name='{strname}'{other_args}
         """
         metadata_dict = cls._gather_all_children_metadata()
         tables_list = design.get_list_of_tables_in_metadata(metadata_dict)
-
-        all_renderers_key_value = dict()
-        # design.renderer_defaults_by_table[table_name][renderer_name][column_name]
-        for table in tables_list:
-            if table in design.renderer_defaults_by_table:
-                for name_renderer, renderer_data in design.renderer_defaults_by_table[
-                        table].items():
-                    if len(renderer_data) > 0:
-                        for col_name, col_value in renderer_data.items():
-                            render_col_name = f'{name_renderer}_{col_name}'
-                            all_renderers_key_value[render_col_name] = col_value
-        return all_renderers_key_value
+        return dict(design.get_renderer_defaults_for_tables(tables_list))
 
 ######################################
 
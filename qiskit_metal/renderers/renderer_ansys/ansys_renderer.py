@@ -36,6 +36,8 @@ from qiskit_metal.draw.basic import is_rectangle
 from qiskit_metal.renderers.renderer_base import QRendererAnalysis
 from qiskit_metal.toolbox_metal.parsing import is_true
 from qiskit_metal.designs.design_base import QDesign
+from qiskit_metal.renderers.renderer_ansys.modeler_batch import ModelerBatch
+from qiskit_metal.toolbox_python.profiler import profiled
 
 from qiskit_metal import Dict
 
@@ -114,6 +116,8 @@ class QAnsysRenderer(QRendererAnalysis):
         * wb_offset:'0um' -- offset distance for wirebond placement (along the direction
           of the cpw)
         * wb_size: 3 -- scalar which controls the width of the wirebond (wb_size * path['width'])
+        * batch_geometry: 'False' -- if True, record the modeler calls which render the poly and
+          path tables, and make them grouped by kind once each table is compiled
     """
 
     #: Default options, over-written by passing ``options` dict to render_options.
@@ -135,6 +139,7 @@ class QAnsysRenderer(QRendererAnalysis):
         wb_threshold = '400um',
         wb_offset = '0um',
         wb_size = 5,
+        batch_geometry = 'False',
         plot_ansys_fields_options = Dict(
             name="NAME:Mag_E1",
             UserSpecifyName='0',
@@ -239,6 +244,15 @@ class QAnsysRenderer(QRendererAnalysis):
         # Variables to connect to Ansys
         self._rapp = None
         self._rdesktop = None
+        # Records the modeler calls while a table is rendered in batch mode
+        self._modeler_batch = None
+        # Incremental render: names of the objects drawn for each component,
+        # their assignments and boundaries, and the components kept from the
+        # last render
+        self._component_objects = dict()
+        self._component_assignments = dict()
+        self._component_boundaries = dict()
+        self._kept_components = None
 
         # Initialize renderer
         super().__init__(design=design, initiate=initiate, options=options)
@@ -497,7 +511,11 @@ class QAnsysRenderer(QRendererAnalysis):
 
         Returns:
             pyEPR.ansys.HfssModeler: Reference to  design.HfssModeler in Ansys.
+            While a table is rendered in batch mode, the ModelerBatch which
+            records the calls instead.
         """
+        if self._modeler_batch is not None:
+            return self._modeler_batch
         if self.pinfo:
             if self.pinfo.design:
                 return self.pinfo.design.modeler
@@ -719,17 +737,22 @@ class QAnsysRenderer(QRendererAnalysis):
         solution_type: str,
         vars_to_initialize: Dict,
         force_redraw: bool = False,
+        incremental: bool = False,
         **design_selection,
     ) -> str:
         """It wraps the render_design() method to
         1. skip rendering if the "selection" of components is left empty (re-uses selected design)
         2. force design clearing and redraw if force_Redraw is set
+        3. redraw only the components which changed, if incremental is set and
+           the design was the last one rendered
 
         Args:
             design_name (str): Name to assign to the renderer design
             solution_type (str): eigenmode, capacitive or drivenmodal
             vars_to_initialize (Dict): Variables to initialize, i.e. Ljx, Cjx
             force_redraw (bool, optional): Force re-render the design. Defaults to False.
+            incremental (bool, optional): Keep the objects of the components which did not
+                change since the last incremental render of this design. Defaults to False.
 
         Returns:
             str: final design name (a suffix might have been added to the provided name,
@@ -744,6 +767,13 @@ class QAnsysRenderer(QRendererAnalysis):
                     # if no design exists, then we will proceed and render the full design instead
                     pass
 
+        if incremental and self._render_record is not None and (
+                self.get_active_design_name() == design_name):
+            # render_design() deletes the objects of the changed components
+            self.set_variables(vars_to_initialize)
+            self.render_design(incremental=True, **design_selection)
+            return self.pinfo.design.name
+
         # either create a new one, or clear the active one, depending on force_redraw.
         if force_redraw and (design_name
                              in self.pinfo.project.get_design_names()):
@@ -753,6 +783,8 @@ class QAnsysRenderer(QRendererAnalysis):
             self.new_ansys_design(design_name, solution_type)
 
         self.set_variables(vars_to_initialize)
+        if incremental:
+            design_selection["incremental"] = True
         self.render_design(**design_selection)
         return self.pinfo.design.name
 
@@ -973,11 +1005,13 @@ class QAnsysRenderer(QRendererAnalysis):
                 "Have you run connect_ansys()?  Cannot find a reference to Ansys in QRenderer."
             )
 
+    @profiled()
     def render_design(
         self,
         selection: Union[list, None] = None,
         open_pins: Union[list, None] = None,
         box_plus_buffer: bool = True,
+        incremental: bool = False,
     ):
         """Initiate rendering of components in design contained in selection,
         assuming they're valid. Components are rendered before the chips they
@@ -1018,6 +1052,8 @@ class QAnsysRenderer(QRendererAnalysis):
             open_pins (Union[list, None], optional): List of tuples of pins that are open. Defaults to None.
             box_plus_buffer (bool): Either calculate a bounding box based on the location of rendered geometries
                                      or use chip size from design class.
+            incremental (bool): Keep the objects of the components which did not change since the last
+                                     incremental render, see begin_incremental_render(). Defaults to False.
         """
         self.qcomp_ids, self.case = self.get_unique_component_ids(selection)
 
@@ -1030,6 +1066,9 @@ class QAnsysRenderer(QRendererAnalysis):
         self.assign_perfE = []
         self.assign_mesh = []
 
+        setup = dict(open_pins=open_pins, box_plus_buffer=box_plus_buffer)
+        self.begin_incremental_render(incremental, **setup)
+
         self.render_tables()
         self.add_endcaps(open_pins)
 
@@ -1037,24 +1076,170 @@ class QAnsysRenderer(QRendererAnalysis):
         self.subtract_from_ground()
         self.add_mesh()
 
+        self.end_incremental_render(incremental, **setup)
+
+    def begin_incremental_render(self, incremental: bool, **setup):
+        """Prepare the active design for the render of self.qcomp_ids.
+
+        The objects drawn for each component in an incremental render are
+        recorded.  In the next incremental render, the components whose
+        qgeometry rows did not change (see changed_since_render()) keep their
+        objects, and all the other objects are deleted: those of the changed
+        and removed components, and the chips, ground planes and endcaps.
+        The boundaries made by the changed and removed components, such as
+        the lumped RLC of their junctions, are deleted with their objects.
+
+        The shapes subtracted from the ground planes are consumed by the
+        subtraction, so those of the kept components are drawn again, and
+        the ground planes are subtracted again.  The other components are
+        drawn whole.  The assignments to the kept objects are restored into
+        self.assign_perfE, etc., so that the boundaries and mesh operations
+        are assigned as after a full render.
+
+        Args:
+            incremental (bool): False to render all components, and forget
+                the last incremental render.
+            **setup: Arguments of render_design() which change the whole
+                render, such as the open pins.
+        """
+        self._kept_components = None
+        if not incremental:
+            self.forget_render()
+            return
+
+        setup = dict(setup, design=self.get_active_design_name())
+        changed = self.changed_since_render(self.qcomp_ids, **setup)
+        if changed is None:
+            if self._render_record is not None:
+                self.clean_active_design()
+                self.delete_assignments([
+                    name for names in self._component_boundaries.values()
+                    for name in names
+                ])
+            self._component_objects.clear()
+            self._component_assignments.clear()
+            self._component_boundaries.clear()
+            self._kept_components = set()
+            return
+
+        changed, removed = changed
+        kept = set(self._render_record.fingerprints) - changed - removed
+        kept_objects = {
+            name for comp_id in kept
+            for name in self._component_objects.get(comp_id, [])
+        }
+        self.delete_objects([
+            name for name in self.pinfo.get_all_object_names()
+            if name not in kept_objects
+        ])
+        self.delete_assignments([
+            name for comp_id in changed | removed
+            for name in self._component_boundaries.get(comp_id, [])
+        ])
+        for comp_id in changed | removed:
+            self._component_objects.pop(comp_id, None)
+            self._component_assignments.pop(comp_id, None)
+            self._component_boundaries.pop(comp_id, None)
+
+        for comp_id in kept:
+            for key, names in self._component_assignments.get(comp_id,
+                                                              {}).items():
+                getattr(self, key).extend(names)
+        self._kept_components = kept
+        self.logger.info(f"Incremental render: redrawing {len(changed)} "
+                         f"components, keeping {len(kept)}.")
+
+    def end_incremental_render(self, incremental: bool, **setup):
+        """Record the render of self.qcomp_ids, if incremental.
+
+        Args:
+            incremental (bool): As given to begin_incremental_render().
+            **setup: As given to begin_incremental_render().
+        """
+        self._kept_components = None
+        if incremental:
+            setup = dict(setup, design=self.get_active_design_name())
+            self.record_render(self.qcomp_ids, **setup)
+
+    def _assignment_lists(self) -> dict:
+        """The lists of object names to assign, by attribute name."""
+        return {
+            key: getattr(self, key)
+            for key in ("assign_perfE", "assign_mesh", "assign_port_mesh")
+            if isinstance(getattr(self, key, None), list)
+        }
+
     def render_chip(self):
         pass
 
     def render_component(self):
         pass
 
+    @profiled()
     def render_tables(self, skip_junction: bool = False):
         """
         Render components in design grouped by table type (path, poly, or junction).
+
+        In an incremental render, see begin_incremental_render(), the
+        components are rendered one by one instead, to record their objects.
         """
-        for table_type in self.design.qgeometry.get_element_types():
-            if table_type != "junction" or not skip_junction:
+        table_types = [
+            table_type
+            for table_type in self.design.qgeometry.get_element_types()
+            if table_type != "junction" or not skip_junction
+        ]
+        if self._kept_components is None:
+            for table_type in table_types:
                 self.render_components(table_type)
+            return
+
+        kept = self._kept_components
+        tables = self.design.qgeometry.tables
+        for table_type in table_types:
+            table = tables[table_type]
+            table = table[table["component"].isin(kept) & table["subtract"]]
+            for _, qgeom in table.iterrows():
+                self.render_element(qgeom, bool(table_type == "junction"))
+
+        comp_ids = self.qcomp_ids if self.case == 0 else list(
+            self.design._components)
+        qcomp_ids, case = self.qcomp_ids, self.case
+        names = set(self.pinfo.get_all_object_names())
+        boundaries = self.boundary_names()
+        try:
+            for comp_id in comp_ids:
+                if comp_id in kept:
+                    continue
+                lengths = {
+                    key: len(values)
+                    for key, values in self._assignment_lists().items()
+                }
+                # Render the tables masked to this component
+                self.qcomp_ids, self.case = [comp_id], 0
+                for table_type in table_types:
+                    self.render_components(table_type)
+
+                drawn = set(self.pinfo.get_all_object_names())
+                subtracted = set().union(*self.chip_subtract_dict.values())
+                self._component_objects[comp_id] = sorted(drawn - names -
+                                                          subtracted)
+                self._component_assignments[comp_id] = {
+                    key: values[lengths.get(key, 0):]
+                    for key, values in self._assignment_lists().items()
+                }
+                made = self.boundary_names()
+                self._component_boundaries[comp_id] = sorted(made - boundaries)
+                names, boundaries = drawn, made
+        finally:
+            self.qcomp_ids, self.case = qcomp_ids, case
 
     def render_components(self, table_type: str):
         """
         Render components by breaking them down into individual elements.
 
+        With the batch_geometry option, the modeler calls for the poly and
+        path tables are recorded by a ModelerBatch, then made grouped by kind.
+
         Args:
             table_type (str): Table type (poly, path, or junction).
         """
@@ -1064,12 +1249,43 @@ class QAnsysRenderer(QRendererAnalysis):
             mask = table["component"].isin(self.qcomp_ids)
             table = table[mask]
 
-        for _, qgeom in table.iterrows():
-            self.render_element(qgeom, bool(table_type == "junction"))
+        if table_type != "junction" and is_true(
+                self._options["batch_geometry"]):
+            self._modeler_batch = ModelerBatch()
+        try:
+            for _, qgeom in table.iterrows():
+                self.render_element(qgeom, bool(table_type == "junction"))
+        finally:
+            modeler_batch, self._modeler_batch = self._modeler_batch, None
+        if modeler_batch is not None:
+            import pythoncom
+
+            try:
+                modeler_batch.run(self.modeler)
+            except pythoncom.com_error as error:  # pylint: disable=no-member
+                self._log_sweep_com_error(error)
+                raise error
 
         if table_type == "path":
             self.auto_wirebonds(table)
 
+    def _log_sweep_com_error(self, error):
+        """Explain the com_error raised when a path is swept in a design
+        which is not writable.
+
+        Args:
+            error (pythoncom.com_error): Raised by the modeler.
+        """
+        print("com_error: ", error)
+        hr, msg, exc, arg = error.args
+        if msg == "Exception occurred." and hr == -2147352567:
+            self.logger.error(
+                "We cannot find a writable design. \n  Either you are trying to use a Ansys "
+                "design that is not empty, in which case please clear it manually or with the "
+                "renderer method clean_active_design(). \n  Or you accidentally deleted "
+                "the design in Ansys, in which case please create a new one."
+            )
+
     def render_element(self, qgeom: pd.Series, is_junction: bool):
         """Render an individual shape whose properties are listed in a row of
         QGeometry table. Junction elements are handled separately from non-
@@ -1278,21 +1494,18 @@ class QAnsysRenderer(QRendererAnalysis):
             ]) + qc_width / (2 * vlen) * np.array([y1 - y0, x0 - x1, 0])
             shortline = self.modeler.draw_polyline([p0, p1],
                                                    closed=False)  # sweepline
-            import pythoncom
 
-            try:
+            if self._modeler_batch is not None:
+                # Only recorded, the call to Ansys is made by render_components
                 self.modeler._sweep_along_path(shortline, poly_ansys)
-            except pythoncom.com_error as error:
-                print("com_error: ", error)
-                hr, msg, exc, arg = error.args
-                if msg == "Exception occurred." and hr == -2147352567:
-                    self.logger.error(
-                        "We cannot find a writable design. \n  Either you are trying to use a Ansys "
-                        "design that is not empty, in which case please clear it manually or with the "
-                        "renderer method clean_active_design(). \n  Or you accidentally deleted "
-                        "the design in Ansys, in which case please create a new one."
-                    )
-                raise error
+            else:
+                import pythoncom
+
+                try:
+                    self.modeler._sweep_along_path(shortline, poly_ansys)
+                except pythoncom.com_error as error:  # pylint: disable=no-member
+                    self._log_sweep_com_error(error)
+                    raise error
 
         if qgeom.chip not in self.chip_subtract_dict:
             self.chip_subtract_dict[qgeom.chip] = set()
@@ -1416,24 +1629,16 @@ class QAnsysRenderer(QRendererAnalysis):
         max_x_main = max_y_main = float("-inf")
         if self.case == 2:  # One or more components not in QDesign.
             self.logger.warning("One or more components not found.")
-        elif self.case == 1:  # All components rendered.
-            for qcomp in self.design.components:
-                min_x, min_y, max_x, max_y = self.design.components[
-                    qcomp].qgeometry_bounds()
-                min_x_main = min(min_x, min_x_main)
-                min_y_main = min(min_y, min_y_main)
-                max_x_main = max(max_x, max_x_main)
-                max_y_main = max(max_y, max_y_main)
-        else:  # Strict subset rendered.
-            for qcomp_id in self.qcomp_ids:
-                min_x, min_y, max_x, max_y = self.design._components[
-                    qcomp_id].qgeometry_bounds()
-                min_x_main = min(min_x, min_x_main)
-                min_y_main = min(min_y, min_y_main)
-                max_x_main = max(max_x, max_x_main)
-                max_y_main = max(max_y, max_y_main)
+        else:
+            # Aggregated from the cached bounds of each component.
+            # Case 1 renders all components, else a strict subset.
+            qcomp_ids = None if self.case == 1 else self.qcomp_ids
+            bounds = self.design.qgeometry.get_bounds(qcomp_ids)
+            if bounds is not None:
+                min_x_main, min_y_main, max_x_main, max_y_main = bounds
         return min_x_main, min_y_main, max_x_main, max_y_main
 
+    @profiled()
     def render_chips(self,
                      draw_sample_holder: bool = True,
                      box_plus_buffer: bool = True):
@@ -1547,6 +1752,7 @@ class QAnsysRenderer(QRendererAnalysis):
             # TODO: Material property assignment may become layer-dependent.
             self.assign_perfE.append(f"ground_{chip_name}_plane")
 
+    @profiled()
     def subtract_from_ground(self):
         """For each chip, subtract all "negative" shapes residing on its
         surface if any such shapes exist."""
@@ -1650,21 +1856,64 @@ class QAnsysRenderer(QRendererAnalysis):
 
     def clean_active_design(self):
         """Remove all elements from Ansys Modeler."""
+        self.forget_render()
         if self.pinfo:
-            if self.pinfo.get_all_object_names():
-                project_name = self.pinfo.project_name
-                design_name = self.pinfo.design_name
-                select_all = ",".join(self.pinfo.get_all_object_names())
+            self.delete_objects(self.pinfo.get_all_object_names())
 
-                # self.pinfo.design does not work, thus the following line
-                oDesktop = self.pinfo.design.parent.parent._desktop
-                oProject = oDesktop.SetActiveProject(project_name)
-                oDesign = oProject.SetActiveDesign(design_name)
+    def delete_objects(self, names: List[str]):
+        """Remove the named elements from Ansys Modeler.
 
-                # The available editors: "Layout", "3D Modeler", "SchematicEditor"
-                oEditor = oDesign.SetActiveEditor("3D Modeler")
+        Args:
+            names (List[str]): Names of the objects in the active design.
+        """
+        if self.pinfo and names:
+            project_name = self.pinfo.project_name
+            design_name = self.pinfo.design_name
+            selection = ",".join(names)
+
+            # self.pinfo.design does not work, thus the following line
+            oDesktop = self.pinfo.design.parent.parent._desktop
+            oProject = oDesktop.SetActiveProject(project_name)
+            oDesign = oProject.SetActiveDesign(design_name)
+
+            # The available editors: "Layout", "3D Modeler", "SchematicEditor"
+            oEditor = oDesign.SetActiveEditor("3D Modeler")
 
-                oEditor.Delete(["NAME:Selections", "Selections:=", select_all])
+            oEditor.Delete(["NAME:Selections", "Selections:=", selection])
+
+    def boundary_names(self) -> set:
+        """Names of the boundaries of the active design.
+
+        Returns:
+            set: Names of the boundaries, such as PerfE and the lumped RLC of
+            the junctions.
+        """
+        return set(self.pinfo.design._boundaries.GetBoundaries())
+
+    def delete_assignments(self, boundaries: List[str] = None):
+        """Remove the boundaries and mesh operations which render_design()
+        assigns to all the listed objects, such as the PerfE boundary, so that
+        they can be assigned again.
+
+        Args:
+            boundaries (List[str], optional): Other boundaries to remove, such
+                as those made by the components which are drawn again.
+                Defaults to None.
+        """
+        design = self.pinfo.design
+        existing = self.boundary_names()
+        names = [
+            name for name in ["PerfE", "ThinCond1"] + list(boundaries or [])
+            if name in existing
+        ]
+        if names:
+            design._boundaries.DeleteBoundaries(names)
+        operations = set(design._mesh.GetOperationNames("Length"))
+        names = [
+            name for name in ("small_mesh", "port_mesh") if name in operations
+        ]
+        if names:
+            design._mesh.DeleteOp(names)
 
     def set_variables(self, variables: Dict):
         """Fixes the junction properties before setup. This is necessary becasue the eigenmode
@@ -31,6 +31,7 @@ from qiskit_metal import Dict
 from qiskit_metal.draw.utility import to_vec3D
 from qiskit_metal.renderers.renderer_ansys.ansys_renderer import (
     QAnsysRenderer, get_clean_name)
+from qiskit_metal.toolbox_python.profiler import profiled
 
 
 class QHFSSRenderer(QAnsysRenderer):
@@ -73,13 +74,15 @@ class QHFSSRenderer(QAnsysRenderer):
 
         QHFSSRenderer.load()
 
+    @profiled()
     def render_design(self,
                       selection: Union[list, None] = None,
                       open_pins: Union[list, None] = None,
                       port_list: Union[list, None] = None,
                       jj_to_port: Union[list, None] = None,
                       ignored_jjs: Union[list, None] = None,
-                      box_plus_buffer: bool = True):
+                      box_plus_buffer: bool = True,
+                      incremental: bool = False):
         """Initiate rendering of components in design contained in selection,
         assuming they're valid. Components are rendered before the chips they
         reside on, and subtraction of negative shapes is performed at the very
@@ -155,6 +158,9 @@ class QHFSSRenderer(QAnsysRenderer):
             box_plus_buffer (bool): Either calculate a bounding box based on
                                         the location of rendered geometries
                                         or use chip size from design class.
+            incremental (bool): Keep the objects of the components which did
+                                        not change since the last incremental
+                                        render. Defaults to False.
         """
         self.qcomp_ids, self.case = self.get_unique_component_ids(selection)
 
@@ -179,6 +185,13 @@ class QHFSSRenderer(QAnsysRenderer):
         if ignored_jjs:
             self.jj_to_ignore = {(qcomp, qelt) for qcomp, qelt in ignored_jjs}
 
+        setup = dict(open_pins=open_pins,
+                     port_list=port_list,
+                     jj_to_port=jj_to_port,
+                     ignored_jjs=ignored_jjs,
+                     box_plus_buffer=box_plus_buffer)
+        self.begin_incremental_render(incremental, **setup)
+
         self.render_tables()
         if port_list:
             self.add_endcaps(open_pins +
@@ -193,6 +206,8 @@ class QHFSSRenderer(QAnsysRenderer):
         self.add_mesh()
         self.metallize()
 
+        self.end_incremental_render(incremental, **setup)
+
     def create_ports(self, port_list: list):
         """Add ports and their respective impedances in Ohms to designated pins
         in port_list. Port_list is formatted as [(qcomp_0, pin_0, impedance_0),
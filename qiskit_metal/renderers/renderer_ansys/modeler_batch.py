@@ -0,0 +1,148 @@
+# -*- coding: utf-8 -*-
+
+# This code is part of Qiskit.
+#
+# (C) Copyright IBM 2017, 2021.
+#
+# This code is licensed under the Apache License, Version 2.0. You may
+# obtain a copy of this license in the LICENSE.txt file in the root directory
+# of this source tree or at http://www.apache.org/licenses/LICENSE-2.0.
+#
+# Any modifications or derivative works of this code must retain this
+# copyright notice, and modified files need to carry a notice indicating
+# that they have been altered from the originals.
+"""Batching of the modeler calls which render the qgeometry rows in Ansys.
+
+See the docstring of `ModelerBatch`.
+"""
+
+from collections import namedtuple
+from typing import Any, Dict as Dict_, List
+
+__all__ = ['ModelerBatch', 'ModelerCommand', 'BatchedObject']
+
+ModelerCommand = namedtuple('ModelerCommand', ['method', 'args', 'kwargs'])
+"""A call to a method of the pyEPR modeler, as `method(*args, **kwargs)`."""
+
+
+class BatchedObject:
+    """Handle of an object drawn through a ModelerBatch, before the batch is
+    run.  Stands for the object returned by the modeler once it is drawn."""
+
+    def __init__(self, batch: 'ModelerBatch', index: int):
+        self._batch = batch
+        self._index = index
+
+    @property
+    def name(self) -> str:
+        """Name the object will be drawn with, if any."""
+        return self._batch._draws[self._index].kwargs.get('name')
+
+    def rename(self, new_name: str) -> 'BatchedObject':
+        """Draw the object with new_name, instead of renaming it later."""
+        self._batch._draws[self._index].kwargs['name'] = new_name
+        return self
+
+    def __repr__(self):
+        return f'BatchedObject({self.name!r})'
+
+
+class ModelerBatch:
+    """Stands in for the pyEPR modeler while the qgeometry rows are rendered,
+    and records their calls instead of sending each one to Ansys.
+
+    The recorded calls are then grouped, and run by `run()` in a single pass:
+
+    1. All the objects are drawn, each under its final name.  The renames which
+       follow a draw are folded into it, so they cost no call.
+    2. The fillets are applied.
+    3. The subtractions from the same object are merged into one call, such as
+       all the interiors of a polygon.
+    4. The paths are swept.
+
+    This is the order in which the renderer makes these calls for a single
+    row, so the result in Ansys is the same.
+    """
+
+    def __init__(self):
+        self._draws = []  # type: List[ModelerCommand]
+        self._fillets = []  # type: List[ModelerCommand]
+        self._subtracts = dict()  # type: Dict_[Any, List]
+        self._sweeps = []  # type: List[ModelerCommand]
+
+    def _draw(self, method: str, args: tuple, kwargs: dict) -> BatchedObject:
+        self._draws.append(ModelerCommand(method, args, dict(kwargs)))
+        return BatchedObject(self, len(self._draws) - 1)
+
+    def draw_rect_corner(self, *args, **kwargs) -> BatchedObject:
+        """Record `modeler.draw_rect_corner`."""
+        return self._draw('draw_rect_corner', args, kwargs)
+
+    def draw_rect_center(self, *args, **kwargs) -> BatchedObject:
+        """Record `modeler.draw_rect_center`."""
+        return self._draw('draw_rect_center', args, kwargs)
+
+    def draw_polyline(self, *args, **kwargs) -> BatchedObject:
+        """Record `modeler.draw_polyline`."""
+        return self._draw('draw_polyline', args, kwargs)
+
+    def rename_obj(self, obj: BatchedObject, name: str) -> str:
+        """Fold the rename into the draw of obj."""
+        obj.rename(name)
+        return name
+
+    def _fillet(self, radius: float, vertex_index_list: list,
+                obj: BatchedObject):
+        """Record `modeler._fillet`."""
+        self._fillets.append(
+            ModelerCommand('_fillet', (radius, vertex_index_list, obj), {}))
+
+    def subtract(self, blank_name: Any, tool_names: list):
+        """Record `modeler.subtract`, merged with the previous subtractions
+        from the same blank."""
+        self._subtracts.setdefault(blank_name, []).extend(tool_names)
+
+    def _sweep_along_path(self, to_sweep: BatchedObject,
+                          path_obj: BatchedObject):
+        """Record `modeler._sweep_along_path`."""
+        self._sweeps.append(
+            ModelerCommand('_sweep_along_path', (to_sweep, path_obj), {}))
+
+    @property
+    def commands(self) -> List[ModelerCommand]:
+        """The grouped calls, in the order `run()` makes them.  Their arguments
+        may still hold BatchedObjects."""
+        subtracts = [
+            ModelerCommand('subtract', (blank, tools), {})
+            for blank, tools in self._subtracts.items()
+        ]
+        return self._draws + self._fillets + subtracts + self._sweeps
+
+    def run(self, modeler) -> List[Any]:
+        """Make the grouped calls to the modeler.
+
+        Args:
+            modeler (pyEPR.ansys.HfssModeler): The modeler of the active design.
+
+        Returns:
+            list: The objects returned by the modeler for each draw, in the
+            order they were recorded.
+        """
+        drawn = [
+            getattr(modeler, command.method)(*command.args, **command.kwargs)
+            for command in self._draws
+        ]
+
+        def resolve(arg):
+            if isinstance(arg, BatchedObject):
+                return drawn[arg._index]
+            if isinstance(arg, list):
+                return [resolve(item) for item in arg]
+            return arg
+
+        for command in self.commands[len(self._draws):]:
+            getattr(modeler,
+                    command.method)(*[resolve(arg) for arg in command.args],
+                                    **command.kwargs)
+
+        return drawn
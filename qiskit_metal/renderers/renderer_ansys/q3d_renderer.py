@@ -24,6 +24,7 @@ from pyEPR.calcs.convert import Convert
 from qiskit_metal import Dict
 from qiskit_metal.renderers.renderer_ansys.ansys_renderer import QAnsysRenderer
 from qiskit_metal.toolbox_metal.parsing import is_true
+from qiskit_metal.toolbox_python.profiler import profiled
 
 from .. import config
 if not config.is_building_docs():
@@ -74,10 +75,12 @@ class QQ3DRenderer(QAnsysRenderer):
             if self.pinfo.design:
                 return self.pinfo.design._boundaries
 
+    @profiled()
     def render_design(self,
                       selection: Union[list, None] = None,
                       open_pins: Union[list, None] = None,
-                      box_plus_buffer: bool = True):
+                      box_plus_buffer: bool = True,
+                      incremental: bool = False):
         """Initiate rendering of components in design contained in selection,
         assuming they're valid. Components are rendered before the chips they
         reside on, and subtraction of negative shapes is performed at the very
@@ -116,6 +119,8 @@ class QQ3DRenderer(QAnsysRenderer):
             open_pins (Union[list, None], optional): List of tuples of pins that are open. Defaults to None.
             box_plus_buffer (bool, optional): Either calculate a bounding box based on the location of rendered geometries
                                      or use chip size from design class.
+            incremental (bool, optional): Keep the objects of the components which did not change since the last
+                                     incremental render. Defaults to False.
         """
         self.qcomp_ids, self.case = self.get_unique_component_ids(selection)
 
@@ -130,6 +135,9 @@ class QQ3DRenderer(QAnsysRenderer):
 
         chip_list = self.get_chip_names()
 
+        setup = dict(open_pins=open_pins, box_plus_buffer=box_plus_buffer)
+        self.begin_incremental_render(incremental, **setup)
+
         self.render_tables(skip_junction=True)
         self.add_endcaps(open_pins)
 
@@ -141,6 +149,8 @@ class QQ3DRenderer(QAnsysRenderer):
         self.assign_thin_conductor()
         self.assign_nets()
 
+        self.end_incremental_render(incremental, **setup)
+
     def assign_thin_conductor(self,
                               material_type: str = 'pec',
                               thickness: str = '200 nm',
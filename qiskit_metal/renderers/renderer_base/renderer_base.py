@@ -180,6 +180,9 @@ class QRenderer(ABC):
         self.update_options(render_options=render_options,
                             render_template=render_template)
 
+        # Fingerprints and setup of the last render, see record_render()
+        self._render_record = None
+
         self.initiated = False
         if initiate:
             self.start()
@@ -439,6 +442,66 @@ class QRenderer(ABC):
         return [self.design.name_to_id[elt] for elt in unique_qcomponents
                ], 0  # Subset selected
 
+    def _render_fingerprints(self, qcomp_ids: Iterable[int]) -> dict:
+        """Fingerprint of the qgeometry rows and name of each component."""
+        components = self.design._components
+        if not qcomp_ids:  # Every component selected
+            qcomp_ids = list(components)
+        fingerprints = self.design.qgeometry.get_component_fingerprints(
+            qcomp_ids)
+        return {
+            comp_id: (fingerprint, components[comp_id].name)
+            for comp_id, fingerprint in fingerprints.items()
+            if comp_id in components
+        }
+
+    def record_render(self, qcomp_ids: Iterable[int], **setup):
+        """Remember what was rendered, for changed_since_render().
+
+        Args:
+            qcomp_ids (Iterable[int]): Ids of the rendered components, empty
+                for all the components.
+            **setup: Arguments of the render which change the whole render
+                when they change, such as the open pins.
+        """
+        self._render_record = Dict(
+            fingerprints=self._render_fingerprints(qcomp_ids),
+            setup=repr((setup, self._options)))
+
+    def forget_render(self):
+        """Forget the last render, so the next one redraws everything."""
+        self._render_record = None
+
+    def changed_since_render(self, qcomp_ids: Iterable[int],
+                             **setup) -> Union[Tuple[set, set], None]:
+        """Components whose qgeometry rows changed since the last render.
+
+        The rows of each component are compared by their fingerprint, see
+        QGeometryTables.get_component_fingerprints().  A renamed component
+        counts as changed, since renderers name their objects after it.
+
+        Args:
+            qcomp_ids (Iterable[int]): Ids of the components to render, empty
+                for all the components.
+            **setup: Arguments of the render, as given to record_render().
+
+        Returns:
+            Union[Tuple[set, set], None]: The ids of the components to redraw,
+            and of the rendered components to delete.  None if there was no
+            recorded render, or if its setup or the render options differ,
+            so that everything must be redrawn.
+        """
+        record = self._render_record
+        if record is None or record.setup != repr((setup, self._options)):
+            return None
+        fingerprints = self._render_fingerprints(qcomp_ids)
+        changed = {
+            comp_id for comp_id, fingerprint in fingerprints.items()
+            if record.fingerprints.get(comp_id) != fingerprint
+        }
+        removed = set(record.fingerprints) - set(fingerprints)
+        return changed, removed
+
     @abstractmethod
     def render_design(self):
         """Abstract method. Must be implemented by the subclass.
@@ -6,6 +6,7 @@ from qiskit_metal import Dict, draw
 from qiskit_metal.renderers.renderer_base import QRendererAnalysis
 from qiskit_metal.renderers.renderer_gmsh.gmsh_renderer import QGmshRenderer
 from qiskit_metal.renderers.renderer_elmer.elmer_runner import ElmerRunner
+from qiskit_metal.toolbox_python.profiler import profiled
 
 
 def load_capacitance_matrix_from_file(filename: str) -> pd.DataFrame:
@@ -177,6 +178,7 @@ class QElmerRenderer(QRendererAnalysis):
         """Public method to close the Gmsh renderer"""
         return self._close_renderer()
 
+    @profiled()
     def render_design(
         self,
         selection: Union[list, None] = None,
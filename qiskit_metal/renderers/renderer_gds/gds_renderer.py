@@ -14,28 +14,33 @@
 """ This module has a QRenderer to export QDesign to a GDS file."""
 # pylint: disable=too-many-lines
 
-from copy import deepcopy
+from concurrent.futures import Executor, ProcessPoolExecutor
+from copy import copy, deepcopy
 from operator import itemgetter
+from types import SimpleNamespace
 from typing import TYPE_CHECKING
 #from typing import Dict as Dict_
 from typing import Tuple, Union
 #from typing import List, Any, Iterable
 import math
 import os
+from shapely import affinity
 from shapely.geometry import LineString
 #from pandas.api.types import is_numeric_dtype
 
 import gdspy
 import geopandas
 import shapely
+from scipy.sparse import coo_matrix
+from scipy.sparse.csgraph import connected_components
 from scipy.spatial import distance
 import pandas as pd
 import numpy as np
 
 from qiskit_metal.renderers.renderer_base import QRenderer
 from qiskit_metal.renderers.renderer_gds.make_cheese import Cheesing
-from qiskit_metal.toolbox_metal.parsing import is_true
-from qiskit_metal import draw
+from qiskit_metal.toolbox_metal.parsing import is_true, parse_value
+from qiskit_metal.toolbox_python.profiler import profiled, profiler
 
 from ... import Dict
 
@@ -94,6 +99,7 @@ class QGDSRenderer(QRenderer):
         * junction_pad_overlap: '5um'
         * max_points: '199'
         * fabricate: 'False'
+        * hierarchical: 'False'
         * cheese: Dict
             * datatype: '100'
             * shape: '0'
@@ -158,6 +164,14 @@ class QGDSRenderer(QRenderer):
         #                                       ground_main_#
         fabricate='False',
 
+        # Export the QComponents whose geometries are identical, up to their
+        # position and orientation, as a single cell placed once per
+        # QComponent by a CellReference.  Such as an array of the same qubit.
+        # Used for the subtract=False geometries of a positive mask.  The
+        # ground plane is still made from the flattened subtract=True
+        # geometries, so it is unchanged.
+        hierarchical='False',
+
         # corners: ('natural', 'miter', 'bevel', 'round', 'smooth',
         # 'circular bend', callable, list)
         # Type of joins. A callable must receive 6 arguments
@@ -327,6 +341,12 @@ class QGDSRenderer(QRenderer):
 
         # if imported, hold the path to file name, otherwise None.
         self.imported_junction_gds = None
+        # Names of the cells read from that file.
+        self.imported_junction_cells = set()
+
+        # GDS fragments of each QComponent, reused by the next export.
+        # See _fix_short_segments_with_cache().
+        self._fragment_cache = dict()
 
         QGDSRenderer.load()
 
@@ -420,25 +440,6 @@ class QGDSRenderer(QRenderer):
         setattr(self, f'{chip_name}_{table_name}_subtract_false',
                 subtract_false)
 
-    @staticmethod
-    def _get_bounds(
-            gs_table: geopandas.GeoDataFrame
-    ) -> Tuple[float, float, float, float]:
-        """Get the bounds for all of the elements in gs_table.
-
-        Args:
-            gs_table (geopandas.GeoDataFrame): A GeoPandas GeoDataFrame used to describe
-                                        components in a design.
-
-        Returns:
-            Tuple[float, float, float, float]: The bounds of all of the
-            elements in this table. [minx, miny, maxx, maxy]
-        """
-        if len(gs_table) == 0:
-            return (0, 0, 0, 0)
-
-        return gs_table.total_bounds
-
     @staticmethod
     def _inclusive_bound(all_bounds: list) -> tuple:
         """Given a list of tuples which describe corners of a box, i.e. (minx,
@@ -575,8 +576,10 @@ class QGDSRenderer(QRenderer):
 
         return unique_qcomponents, 0
 
+    @profiled()
     def _create_qgeometry_for_gds(self,
-                                  highlight_qcomponents: list = None) -> int:
+                                  highlight_qcomponents: list = None,
+                                  convert: bool = True) -> int:
         """Using self.design, this method does the following:
 
         1. Gather the QGeometries to be used to write to file.
@@ -598,6 +601,9 @@ class QGDSRenderer(QRenderer):
                             If empty, render all components in design.
                             If QComponent names are duplicated,
                             duplicates will be ignored.
+            convert (bool): Convert the geometries to gdspy elements.  When
+                            False, they are converted later, by
+                            _qgeometry_to_gds_for_layer().  Defaults to True.
 
         Returns:
             int: 0 if all ended well.
@@ -610,61 +616,82 @@ class QGDSRenderer(QRenderer):
             return 1
         self.dict_bounds.clear()
 
-        for chip_name, _ in self.chip_info.items():
-            # put the QGeometry into GDS format.
-            # There can be more than one chip in QGeometry.
-            # They all export to one gds file.
-            self.chip_info[chip_name]['all_subtract'] = []
-            self.chip_info[chip_name]['all_no_subtract'] = []
+        for chip_name in self.chip_info:
+            self._create_qgeometry_for_chip(chip_name, unique_qcomponents,
+                                            highlight_qcomponents, convert)
 
-            self.dict_bounds[chip_name] = Dict()
-            self.dict_bounds[chip_name]['gather'] = []
-            self.dict_bounds[chip_name]['for_subtract'] = tuple()
-            all_table_subtracts = []
-            all_table_no_subtracts = []
+        return 0
 
-            for table_name in self.design.qgeometry.get_element_types():
+    def _create_qgeometry_for_chip(self,
+                                   chip_name: str,
+                                   unique_qcomponents: list,
+                                   highlight_qcomponents: list,
+                                   convert: bool = True):
+        """Do the steps 2 to 4 of _create_qgeometry_for_gds() for one chip.
+
+        Args:
+            chip_name (str): Name of the chip to gather.
+            unique_qcomponents (list): QComponents to render, from
+                            _check_qcomps().  Empty for all of them.
+            highlight_qcomponents (list): List of strings which denote the name
+                            of QComponents to render, as given by the user.
+            convert (bool): Convert the geometries to gdspy elements.
+                            Defaults to True.
+        """
+        # put the QGeometry into GDS format.
+        # There can be more than one chip in QGeometry.
+        # They all export to one gds file.
+        self.chip_info[chip_name]['all_subtract'] = []
+        self.chip_info[chip_name]['all_no_subtract'] = []
 
-                # Get table for chip and table_name, and reduce
-                # to keep just the list of unique_qcomponents.
-                table = self._get_table(table_name, unique_qcomponents,
-                                        chip_name)
+        self.dict_bounds[chip_name] = Dict()
+        self.dict_bounds[chip_name]['gather'] = []
+        self.dict_bounds[chip_name]['for_subtract'] = tuple()
+        all_table_subtracts = []
+        all_table_no_subtracts = []
 
-                if table_name == 'junction':
-                    self.chip_info[chip_name]['junction'] = deepcopy(table)
-                else:
-                    # For every chip, and layer, separate the "subtract"
-                    # and "no_subtract" elements and gather bounds.
-                    # self.dict_bounds[chip_name] = list_bounds
-                    self._gather_subtract_elements_and_bounds(
-                        chip_name, table_name, table, all_table_subtracts,
-                        all_table_no_subtracts)
-
-            # If list of QComponents provided, use the
-            # bounding_box_scale(x and y), otherwise use self._chips.
-            scaled_max_bound, max_bound = self._scale_max_bounds(
-                chip_name, self.dict_bounds[chip_name]['gather'])
-            if highlight_qcomponents:
-                self.dict_bounds[chip_name]['for_subtract'] = scaled_max_bound
-            else:
-                chip_box, status = self.design.get_x_y_for_chip(chip_name)
-                if status == 0:
-                    self.dict_bounds[chip_name]['for_subtract'] = chip_box
-                else:
-                    self.dict_bounds[chip_name]['for_subtract'] = max_bound
-                    self.logger.warning(
-                        f'design.get_x_y_for_chip() did NOT return a good '
-                        f'code for chip={chip_name},for ground subtraction-box'
-                        f' using the size calculated from QGeometry, '
-                        f'({max_bound}) will be used. ')
-            if is_true(self.options.ground_plane):
-                self._handle_ground_plane(chip_name, all_table_subtracts,
-                                          all_table_no_subtracts)
+        for table_name in self.design.qgeometry.get_element_types():
 
-        return 0
+            # Get table for chip and table_name, and reduce
+            # to keep just the list of unique_qcomponents.
+            table = self._get_table(table_name, unique_qcomponents, chip_name)
 
-    def _handle_ground_plane(self, chip_name: str, all_table_subtracts: list,
-                             all_table_no_subtracts: list):
+            if table_name == 'junction':
+                self.chip_info[chip_name]['junction'] = deepcopy(table)
+            else:
+                # For every chip, and layer, separate the "subtract"
+                # and "no_subtract" elements and gather bounds.
+                # self.dict_bounds[chip_name] = list_bounds
+                self._gather_subtract_elements_and_bounds(
+                    chip_name, table_name, table, all_table_subtracts,
+                    all_table_no_subtracts)
+
+        # If list of QComponents provided, use the
+        # bounding_box_scale(x and y), otherwise use self._chips.
+        scaled_max_bound, max_bound = self._scale_max_bounds(
+            chip_name, self.dict_bounds[chip_name]['gather'])
+        if highlight_qcomponents:
+            self.dict_bounds[chip_name]['for_subtract'] = scaled_max_bound
+        else:
+            chip_box, status = self.design.get_x_y_for_chip(chip_name)
+            if status == 0:
+                self.dict_bounds[chip_name]['for_subtract'] = chip_box
+            else:
+                self.dict_bounds[chip_name]['for_subtract'] = max_bound
+                self.logger.warning(
+                    f'design.get_x_y_for_chip() did NOT return a good '
+                    f'code for chip={chip_name},for ground subtraction-box'
+                    f' using the size calculated from QGeometry, '
+                    f'({max_bound}) will be used. ')
+        if is_true(self.options.ground_plane):
+            self._handle_ground_plane(chip_name, all_table_subtracts,
+                                      all_table_no_subtracts, convert)
+
+    def _handle_ground_plane(self,
+                             chip_name: str,
+                             all_table_subtracts: list,
+                             all_table_no_subtracts: list,
+                             convert: bool = True):
         """Place all the subtract geometries for one chip into
         self.chip_info[chip_name]['all_subtract_true'].
 
@@ -682,24 +709,26 @@ class QGDSRenderer(QRenderer):
             chip_name (str): Chip_name that is being processed.
             all_table_subtracts (list): Add to self.chip_info by layer number.
             all_table_no_subtracts (list): Add to self.chip_info by layer number.
+            convert (bool): Convert the geometries with _qgeometry_to_gds().
+                            Defaults to True.
         """
 
         fix_short_segments = self.parse_value(
             self.options.short_segments_to_not_fillet)
         all_layers = self.design.qgeometry.get_all_unique_layers(chip_name)
+        fragment_keys = self._fragment_keys(all_table_subtracts +
+                                            all_table_no_subtracts)
 
         for chip_layer in all_layers:
-            copy_subtract = []
-            copy_no_subtract = []
-            copy_subtract = deepcopy(all_table_subtracts)
-            copy_no_subtract = deepcopy(all_table_no_subtracts)
-
-            for item in copy_subtract:
-                item.drop(item.index[item['layer'] != chip_layer], inplace=True)
-
-            for item_no in copy_no_subtract:
-                item_no.drop(item_no.index[item_no['layer'] != chip_layer],
-                             inplace=True)
+            # Selecting the rows makes a copy, so the tables are not changed.
+            copy_subtract = [
+                item[item['layer'] == chip_layer]
+                for item in all_table_subtracts
+            ]
+            copy_no_subtract = [
+                item_no[item_no['layer'] == chip_layer]
+                for item_no in all_table_no_subtracts
+            ]
 
             self.chip_info[chip_name][chip_layer][
                 'all_subtract_true'] = geopandas.GeoDataFrame(
@@ -714,19 +743,303 @@ class QGDSRenderer(QRenderer):
             self.chip_info[chip_name][chip_layer][
                 'all_subtract_false'].reset_index(inplace=True)
 
-            if is_true(fix_short_segments):
-                self._fix_short_segments_within_table(chip_name, chip_layer,
-                                                      'all_subtract_true')
+            for table_key in ('all_subtract_true', 'all_subtract_false'):
+                self._fix_short_segments_with_cache(chip_name, chip_layer,
+                                                    table_key, fragment_keys,
+                                                    is_true(fix_short_segments))
+
+            self.chip_info[chip_name][chip_layer]['instances'] = []
+            if (is_true(self.options.hierarchical) and
+                    not self._is_negative_mask(chip_name, chip_layer)):
+                self._separate_instances(chip_name, chip_layer)
+
+            if convert:
+                self._qgeometry_to_gds_for_layer(chip_name, chip_layer)
+
+    def _qgeometry_to_gds_for_layer(self, chip_name: str, chip_layer: int):
+        """Convert the tables made by _handle_ground_plane() for one layer
+        to gdspy elements, in self.chip_info[chip_name][chip_layer]
+        ['q_subtract_true'] and ['q_subtract_false'].
+
+        Args:
+            chip_name (str): Chip_name that is being processed.
+            chip_layer (int): Layer that is being processed.
+        """
+        self.chip_info[chip_name][chip_layer][
+            'q_subtract_true'] = self._qgeometry_to_gds_with_cache(
+                chip_name, chip_layer, 'all_subtract_true')
+
+        self.chip_info[chip_name][chip_layer][
+            'q_subtract_false'] = self._qgeometry_to_gds_with_cache(
+                chip_name, chip_layer, 'all_subtract_false')
+
+    # Cache of the rows and gdspy elements of each QComponent.
+
+    def _fragment_keys(self, tables: list) -> dict:
+        """Key of the GDS fragments of each QComponent in tables.
+
+        The fragments of a QComponent are the rows left by
+        _fix_short_segments_within_table(), and their gdspy elements.  They
+        change with the qgeometry rows of the QComponent, or with the options
+        used to convert them, compared by value: '10um' and '0.01mm' give
+        the same key.
+
+        Args:
+            tables (list): Tables of QGeometry rows.
+
+        Returns:
+            dict: The key is the QComponent id, the value is the key of its
+            fragments.
+        """
+        options = tuple(
+            self.parse_value(self.options[name])
+            for name in ('short_segments_to_not_fillet',
+                         'check_short_segments_by_scaling_fillet', 'corners',
+                         'tolerance', 'precision', 'width_LineString',
+                         'max_points'))
+        options += (self.design.get_units(),)
+        component_ids = dict.fromkeys(component_id for table in tables
+                                      for component_id in table['component'])
+        fingerprints = self.design.qgeometry.get_component_fingerprints(
+            component_ids)
+        return {
+            component_id: (fingerprint, options)
+            for component_id, fingerprint in fingerprints.items()
+        }
+
+    def _fix_short_segments_with_cache(self, chip_name: str, chip_layer: int,
+                                       table_key: str, fragment_keys: dict,
+                                       fix_short_segments: bool):
+        """Do _fix_short_segments_within_table() for the QComponents which
+        changed since the last export, and reuse the rows of the others.
+
+        The rows of the table are grouped by QComponent.
+
+        Args:
+            chip_name (str): The name of chip.
+            chip_layer (int): The layer within the chip to be evaluated.
+            table_key (str): To be used within self.chip_info:
+                                'all_subtract_true' or 'all_subtract_false'.
+            fragment_keys (dict): Result of _fragment_keys().
+            fix_short_segments (bool): Whether to fix the short segments.
+        """
+        table = self.chip_info[chip_name][chip_layer][table_key]
+        if table.empty:
+            return
+
+        cache = self._fragment_cache
+        cache_keys = {
+            component_id: (chip_name, chip_layer, table_key, component_id)
+            for component_id in pd.unique(table['component'])
+        }
+        stale_ids = []
+        for component_id, cache_key in cache_keys.items():
+            fragment = cache.get(cache_key)
+            if fragment is None or fragment.key != fragment_keys[component_id]:
+                stale_ids.append(component_id)
+
+        if stale_ids:
+            self.chip_info[chip_name][chip_layer][table_key] = table[
+                table['component'].isin(stale_ids)]
+            if fix_short_segments:
                 self._fix_short_segments_within_table(chip_name, chip_layer,
-                                                      'all_subtract_false')
+                                                      table_key)
+            fixed = self.chip_info[chip_name][chip_layer][table_key]
+            for component_id, rows in fixed.groupby('component', sort=False):
+                cache[cache_keys[component_id]] = Dict(
+                    key=fragment_keys[component_id], rows=rows, elements=None)
+
+        self.chip_info[chip_name][chip_layer][
+            table_key] = geopandas.GeoDataFrame(
+                pd.concat([cache[key].rows for key in cache_keys.values()]))
+
+    def _qgeometry_to_gds_with_cache(self, chip_name: str, chip_layer: int,
+                                     table_key: str) -> pd.Series:
+        """Do _qgeometry_to_gds() for each row of a table made by
+        _fix_short_segments_with_cache(), reusing the gdspy elements of the
+        QComponents which did not change.
 
-            self.chip_info[chip_name][chip_layer][
-                'q_subtract_true'] = self.chip_info[chip_name][chip_layer][
-                    'all_subtract_true'].apply(self._qgeometry_to_gds, axis=1)
+        Args:
+            chip_name (str): The name of chip.
+            chip_layer (int): The layer within the chip.
+            table_key (str): To be used within self.chip_info:
+                                'all_subtract_true' or 'all_subtract_false'.
 
-            self.chip_info[chip_name][chip_layer][
-                'q_subtract_false'] = self.chip_info[chip_name][chip_layer][
-                    'all_subtract_false'].apply(self._qgeometry_to_gds, axis=1)
+        Returns:
+            pd.Series: The gdspy elements, in the order of the rows.
+        """
+        table = self.chip_info[chip_name][chip_layer][table_key]
+        if table.empty:
+            return table.apply(self._qgeometry_to_gds, axis=1)
+
+        elements = []
+        for component_id, rows in table.groupby('component', sort=False):
+            fragment = self._fragment_cache[(chip_name, chip_layer, table_key,
+                                             component_id)]
+            if fragment.elements is None:
+                fragment.elements = [
+                    self._qgeometry_to_gds(row) for _, row in rows.iterrows()
+                ]
+            elements += fragment.elements
+        return pd.Series(elements, index=table.index, dtype=object)
+
+    def clear_fragment_cache(self, chip_name: str = None):
+        """Forget the GDS fragments kept from the previous exports, so that
+        the next export converts every QComponent again.
+
+        Args:
+            chip_name (str): Only forget the fragments of this chip.
+                Defaults to None, for all chips.
+        """
+        if chip_name is None:
+            self._fragment_cache.clear()
+            return
+        for key in [key for key in self._fragment_cache if key[0] == chip_name]:
+            del self._fragment_cache[key]
+
+    def _component_frame(self, component_id: int) -> Union[tuple, None]:
+        """Position and orientation of a QComponent, from its options.
+
+        Args:
+            component_id (int): Id of the QComponent.
+
+        Returns:
+            Union[tuple, None]: (x, y, orientation in degrees), or None if the
+            QComponent has no pos_x and pos_y options, such as a route.
+        """
+        # pylint: disable=protected-access
+        qcomp = self.design._components.get(component_id)
+        if qcomp is None or 'pos_x' not in qcomp.options or (
+                'pos_y' not in qcomp.options):
+            return None
+        x, y, orientation = self.design.parse_value([
+            qcomp.options.pos_x, qcomp.options.pos_y,
+            qcomp.options.get('orientation', 0)
+        ])
+        return float(x), float(y), float(orientation)
+
+    def _separate_instances(self, chip_name: str, chip_layer: int):
+        """Group the QComponents whose subtract=False geometries are
+        identical in their own frame, and move the geometries of each group
+        with more than one QComponent out of 'all_subtract_false'.
+
+        The groups are placed in
+        self.chip_info[chip_name][chip_layer]['instances'].  Each is a Dict
+        with the name of its cell, the 'table' of the geometries of its first
+        QComponent in its own frame, their gdspy 'elements', and the
+        'placements' (x, y, rotation in degrees) of each QComponent.
+
+        Args:
+            chip_name (str): Chip_name that is being processed.
+            chip_layer (int): Layer that is being processed.
+        """
+        # pylint: disable=too-many-locals
+        layer_info = self.chip_info[chip_name][chip_layer]
+        table = layer_info['all_subtract_false']
+        if table.empty:
+            return
+
+        # Geometries which match on this grid, in the units of the design,
+        # are the same in the GDS file.
+        grid = float(self.parse_value(self.options.precision)) / float(
+            self.parse_value(self.options.gds_unit))
+
+        groups = dict()
+        for component_id, rows in table.groupby('component', sort=False):
+            frame = self._component_frame(component_id)
+            if frame is None:
+                continue
+            x, y, rotation = frame
+            local = [
+                affinity.rotate(affinity.translate(geom, -x, -y),
+                                -rotation,
+                                origin=(0, 0)) for geom in rows['geometry']
+            ]
+            key = self._instance_key(rows, local, grid)
+            if key not in groups:
+                groups[key] = Dict(rows=rows,
+                                   local=local,
+                                   component_ids=[],
+                                   placements=[])
+            groups[key].component_ids.append(component_id)
+            groups[key].placements.append(frame)
+
+        instanced_ids = []
+        for group in groups.values():
+            if len(group.component_ids) < 2:
+                continue
+            instanced_ids += group.component_ids
+            # pylint: disable=protected-access
+            class_name = self.design._components[
+                group.component_ids[0]].__class__.__name__
+            local_table = group.rows.copy()
+            local_table['geometry'] = group.local
+            name = (f'{class_name}_{chip_name}_{chip_layer}_'
+                    f'{len(layer_info["instances"])}')
+            layer_info['instances'].append(
+                Dict(name=name,
+                     table=local_table,
+                     elements=local_table.apply(self._qgeometry_to_gds, axis=1),
+                     placements=group.placements))
+
+        if instanced_ids:
+            layer_info['all_subtract_false'] = table[~table['component'].
+                                                     isin(instanced_ids)]
+
+    @staticmethod
+    def _instance_key(rows: pd.DataFrame, local: list, grid: float) -> tuple:
+        """Key which is equal for QComponents that export to the same GDS
+        geometries in their own frame.
+
+        Args:
+            rows (pd.DataFrame): The rows of the QComponent in a table.
+            local (list): The geometries of the rows, in the frame of the
+                            QComponent.
+            grid (float): Coordinates are compared on this grid.
+
+        Returns:
+            tuple: One entry per row, with its geometry type, width, fillet
+            and coordinates on the grid.
+        """
+
+        def column(name: str) -> list:
+            # NaN is not equal to itself, so use None in the key instead.
+            if name not in rows:
+                return [None] * len(rows)
+            return [None if pd.isna(value) else value for value in rows[name]]
+
+        key = []
+        for geom, width, fillet in zip(local, column('width'),
+                                       column('fillet')):
+            coords = np.round(shapely.get_coordinates(geom) / grid)
+            key.append((geom.geom_type, width, fillet,
+                        coords.astype(np.int64).tobytes()))
+        return tuple(key)
+
+    def _add_instances(self, lib: gdspy.GdsLibrary, chip_name: str,
+                       chip_layer: int, ground_cell: gdspy.library.Cell):
+        """Add a cell for each group of identical QComponents found by
+        _separate_instances(), and a reference to it in ground_cell for
+        each QComponent of the group.
+
+        Args:
+            lib (gdspy.GdsLibrary): The gdspy library to export.
+            chip_name (str): Name of chip to render.
+            chip_layer (int): Layer of the chip to render.
+            ground_cell (gdspy.library.Cell): The cell in lib to add to.
+                                            Cell created for each layer.
+        """
+        for instance in self.chip_info[chip_name][chip_layer].get(
+                'instances', []):
+            cell = lib.new_cell(instance.name, overwrite_duplicate=True)
+            cell.add([
+                element for element in instance.elements if element is not None
+            ])
+            for x, y, rotation in instance.placements:
+                reference = gdspy.CellReference(cell,
+                                                origin=(x, y),
+                                                rotation=rotation)
+                ground_cell.add(reference)
 
     # Handling Fillet issues.
 
@@ -1018,7 +1331,11 @@ class QGDSRenderer(QRenderer):
         """
 
         # Determine bound box and return scalar larger than size.
-        bounds = tuple(self._get_bounds(table))
+        # Read from the cached bounds of each component in the table.
+        bounds = self.design.qgeometry.get_bounds(pd.unique(table['component']),
+                                                  chip_name, [table_name])
+        if bounds is None:
+            bounds = (0, 0, 0, 0)
 
         # Add the bounds of each table to list.
         self.dict_bounds[chip_name]['gather'].append(bounds)
@@ -1220,30 +1537,45 @@ class QGDSRenderer(QRenderer):
 
         return code
 
+    @profiled()
     def _populate_cheese(self):
         """Iterate through each chip, then layer to determine the cheesing
         geometry."""
 
-        # lib = self.lib
+        for chip_name in self.chip_info:
+            self._populate_cheese_for_chip(chip_name)
+
+    def _populate_cheese_for_chip(self, chip_name: str):
+        """Determine the cheesing geometry of each layer of one chip.
+
+        Args:
+            chip_name (str): Name of chip to render.
+        """
+        layers_in_chip = self.design.qgeometry.get_all_unique_layers(chip_name)
+
+        for chip_layer in layers_in_chip:
+            self._populate_cheese_for_layer(chip_name, chip_layer)
+
+    def _populate_cheese_for_layer(self, chip_name: str, chip_layer: int):
+        """Determine the cheesing geometry of one layer of a chip.
+
+        Args:
+            chip_name (str): Name of chip to render.
+            chip_layer (int): Layer of the chip to render.
+        """
         cheese_sub_layer = int(self.parse_value(self.options.cheese.datatype))
         nocheese_sub_layer = int(
             self.parse_value(self.options.no_cheese.datatype))
 
-        for chip_name in self.chip_info:
-            layers_in_chip = self.design.qgeometry.get_all_unique_layers(
-                chip_name)
-
-            for chip_layer in layers_in_chip:
-                code = self._check_cheese(chip_name, chip_layer)
-                if code == 1:
-                    chip_box, status = self.design.get_x_y_for_chip(chip_name)
-                    if status == 0:
-                        minx, miny, maxx, maxy = chip_box
+        code = self._check_cheese(chip_name, chip_layer)
+        if code == 1:
+            chip_box, status = self.design.get_x_y_for_chip(chip_name)
+            if status == 0:
+                minx, miny, maxx, maxy = chip_box
 
-                        self._cheese_based_on_shape(minx, miny, maxx, maxy,
-                                                    chip_name, chip_layer,
-                                                    cheese_sub_layer,
-                                                    nocheese_sub_layer)
+                self._cheese_based_on_shape(minx, miny, maxx, maxy, chip_name,
+                                            chip_layer, cheese_sub_layer,
+                                            nocheese_sub_layer)
 
     def _cheese_based_on_shape(self, minx: float, miny: float, maxx: float,
                                maxy: float, chip_name: str, chip_layer: int,
@@ -1335,6 +1667,7 @@ class QGDSRenderer(QRenderer):
         if a_cheese is not None:
             dummy_a_lib = a_cheese.apply_cheesing()
 
+    @profiled()
     def _populate_no_cheese(self):
         """Iterate through every chip and layer.  If options choose to have
         either cheese or no-cheese, a MultiPolygon is placed
@@ -1346,6 +1679,27 @@ class QGDSRenderer(QRenderer):
         is data_type and denoted in the options.
         """
 
+        for chip_name in self.chip_info:
+            self._populate_no_cheese_for_chip(chip_name)
+
+    def _populate_no_cheese_for_chip(self, chip_name: str):
+        """Do _populate_no_cheese() for each layer of one chip.
+
+        Args:
+            chip_name (str): Name of chip to render.
+        """
+        layers_in_chip = self.design.qgeometry.get_all_unique_layers(chip_name)
+
+        for chip_layer in layers_in_chip:
+            self._populate_no_cheese_for_layer(chip_name, chip_layer)
+
+    def _populate_no_cheese_for_layer(self, chip_name: str, chip_layer: int):
+        """Do _populate_no_cheese() for one layer of a chip.
+
+        Args:
+            chip_name (str): Name of chip to render.
+            chip_layer (int): Layer of the chip to render.
+        """
         # pylint: disable=too-many-nested-blocks
 
         no_cheese_buffer = float(self.parse_value(
@@ -1355,56 +1709,47 @@ class QGDSRenderer(QRenderer):
 
         fab = is_true(self.options.fabricate)
 
-        for chip_name, _ in self.chip_info.items():
-            layers_in_chip = self.design.qgeometry.get_all_unique_layers(
-                chip_name)
+        code = self._check_either_cheese(chip_name, chip_layer)
 
-            for chip_layer in layers_in_chip:
-                code = self._check_either_cheese(chip_name, chip_layer)
-
-                if code in (1, 2, 3):
-                    if len(self.chip_info[chip_name][chip_layer]
-                           ['all_subtract_true']) != 0:
-
-                        sub_df = self.chip_info[chip_name][chip_layer][
-                            'all_subtract_true']
-                        no_cheese_multipolygon = self._cheese_buffer_maker(
-                            sub_df, chip_name, no_cheese_buffer)
-
-                        if no_cheese_multipolygon is not None:
-                            self.chip_info[chip_name][chip_layer][
-                                'no_cheese'] = no_cheese_multipolygon
-                            sub_layer = int(
-                                self.parse_value(
-                                    self.options.no_cheese.datatype))
-                            all_nocheese_gds = self._multipolygon_to_gds(
-                                no_cheese_multipolygon, chip_layer, sub_layer,
-                                no_cheese_buffer)
-                            self.chip_info[chip_name][chip_layer][
-                                'no_cheese_gds'] = all_nocheese_gds
-
-                            # If fabricate.fab is true, then
-                            # do not put nocheese in gds file.
-                            if self._check_no_cheese(
-                                    chip_name, chip_layer) == 1 and not fab:
-                                no_cheese_subtract_cell_name = (
-                                    f'TOP_{chip_name}_{chip_layer}'
-                                    f'_NoCheese_{sub_layer}')
-                                no_cheese_cell = lib.new_cell(
-                                    no_cheese_subtract_cell_name,
-                                    overwrite_duplicate=True)
-
-                                no_cheese_cell.add(all_nocheese_gds)
-
-                                # Keep the cell out to layer, it becomes part of ground.
-                                chip_only_top_name = f'TOP_{chip_name}'
-
-                                if no_cheese_cell.get_bounding_box(
-                                ) is not None:
-                                    lib.cells[chip_only_top_name].add(
-                                        gdspy.CellReference(no_cheese_cell))
-                                else:
-                                    lib.remove(no_cheese_cell)
+        if code in (1, 2, 3):
+            if len(self.chip_info[chip_name][chip_layer]
+                   ['all_subtract_true']) != 0:
+
+                sub_df = self.chip_info[chip_name][chip_layer][
+                    'all_subtract_true']
+                no_cheese_multipolygon = self._cheese_buffer_maker(
+                    sub_df, chip_name, no_cheese_buffer)
+
+                if no_cheese_multipolygon is not None:
+                    self.chip_info[chip_name][chip_layer][
+                        'no_cheese'] = no_cheese_multipolygon
+                    all_nocheese_gds = self._multipolygon_to_gds(
+                        no_cheese_multipolygon, chip_layer, sub_layer,
+                        no_cheese_buffer)
+                    self.chip_info[chip_name][chip_layer][
+                        'no_cheese_gds'] = all_nocheese_gds
+
+                    # If fabricate.fab is true, then
+                    # do not put nocheese in gds file.
+                    if self._check_no_cheese(chip_name,
+                                             chip_layer) == 1 and not fab:
+                        no_cheese_subtract_cell_name = (
+                            f'TOP_{chip_name}_{chip_layer}'
+                            f'_NoCheese_{sub_layer}')
+                        no_cheese_cell = lib.new_cell(
+                            no_cheese_subtract_cell_name,
+                            overwrite_duplicate=True)
+
+                        no_cheese_cell.add(all_nocheese_gds)
+
+                        # Keep the cell out to layer, it becomes part of ground.
+                        chip_only_top_name = f'TOP_{chip_name}'
+
+                        if no_cheese_cell.get_bounding_box() is not None:
+                            lib.cells[chip_only_top_name].add(
+                                gdspy.CellReference(no_cheese_cell))
+                        else:
+                            lib.remove(no_cheese_cell)
 
     def _cheese_buffer_maker(
         self, sub_df: geopandas.GeoDataFrame, chip_name: str,
@@ -1413,7 +1758,7 @@ class QGDSRenderer(QRenderer):
         """For each layer in each chip, and if it has a ground plane
         (subtract==True), determine the no-cheese buffer and return a shapely
         object. Before the buffer is created for no-cheese, the LineStrings and
-        Polygons are all combined.
+        Polygons are all combined, see _buffer_union_by_cluster().
 
         Args:
             sub_df (geopandas.GeoDataFrame): The subset of QGeometry tables
@@ -1428,33 +1773,33 @@ class QGDSRenderer(QRenderer):
             buffer as specified through default_options.
         """
         # pylint: disable=too-many-locals
-        style_cap = int(self.parse_value(self.options.no_cheese.cap_style))
-        style_join = int(self.parse_value(self.options.no_cheese.join_style))
-
-        poly_sub_df = sub_df[sub_df.geometry.apply(
-            lambda x: isinstance(x, shapely.geometry.polygon.Polygon))]
-        poly_sub_geo = poly_sub_df['geometry'].tolist()
-
-        path_sub_df = sub_df[sub_df.geometry.apply(
-            lambda x: isinstance(x, shapely.geometry.linestring.LineString))]
-        path_sub_geo = path_sub_df['geometry'].tolist()
-        path_sub_width = path_sub_df['width'].tolist()
-        #for n in range(len(path_sub_geo)):
-        for index, _ in enumerate(path_sub_geo):
-            path_sub_geo[index] = path_sub_geo[index].buffer(
-                path_sub_width[index] / 2,
-                cap_style=style_cap,
-                join_style=style_join)
-
-        #  Need to add buffer_size, cap style, and join style to default options
-        combo_list = path_sub_geo + poly_sub_geo
-        combo_shapely = draw.union(combo_list)
+        style_cap = shapely.BufferCapStyle(
+            int(self.parse_value(self.options.no_cheese.cap_style)))
+        style_join = shapely.BufferJoinStyle(
+            int(self.parse_value(self.options.no_cheese.join_style)))
+
+        geometries = sub_df.geometry.to_numpy()
+        type_ids = shapely.get_type_id(geometries)
+        is_path = type_ids == shapely.GeometryType.LINESTRING
+        is_poly = type_ids == shapely.GeometryType.POLYGON
+
+        # Buffer all the paths at once.
+        path_sub_width = sub_df['width'].to_numpy(dtype=float)[is_path]
+        path_sub_geo = shapely.buffer(geometries[is_path],
+                                      path_sub_width / 2,
+                                      cap_style=style_cap,
+                                      join_style=style_join)
+
+        combo_list = np.concatenate([path_sub_geo, geometries[is_poly]])
+        if len(combo_list) == 0:
+            return None
+
+        #Can return either Multipolygon or just one polygon.
+        combo_shapely = self._buffer_union_by_cluster(combo_list,
+                                                      no_cheese_buffer,
+                                                      style_cap, style_join)
 
         if not combo_shapely.is_empty:
-            #Can return either Multipolygon or just one polygon.
-            combo_shapely = combo_shapely.buffer(no_cheese_buffer,
-                                                 cap_style=style_cap,
-                                                 join_style=style_join)
             if isinstance(combo_shapely, shapely.geometry.polygon.Polygon):
                 combo_shapely = shapely.geometry.MultiPolygon([combo_shapely])
 
@@ -1481,6 +1826,46 @@ class QGDSRenderer(QRenderer):
             return combo_shapely
         return None  # Need explicitly to avoid lint warnings.
 
+    @staticmethod
+    def _buffer_union_by_cluster(
+        geometries: np.ndarray, buffer: float,
+        cap_style: shapely.BufferCapStyle, join_style: shapely.BufferJoinStyle
+    ) -> shapely.geometry.base.BaseGeometry:
+        """Buffer the union of geometries.
+
+        An STRtree finds the clusters of geometries which intersect each other.
+        Each cluster is merged on its own, which is cheaper than a single
+        union of all of them, then the clusters are buffered at once.  As the
+        clusters do not intersect, the union of their buffers is the buffer of
+        the union of all geometries.
+
+        Args:
+            geometries (np.ndarray): The shapely geometries.
+            buffer (float): Size of the buffer.
+            cap_style (shapely.BufferCapStyle): Used for the buffer.
+            join_style (shapely.BufferJoinStyle): Used for the buffer.
+
+        Returns:
+            shapely.geometry.base.BaseGeometry: The buffered union.
+        """
+        tree = shapely.STRtree(geometries)
+        first, second = tree.query(geometries, predicate='intersects')
+        graph = coo_matrix((np.ones(len(first)), (first, second)),
+                           shape=(len(geometries), len(geometries)))
+        _, labels = connected_components(graph, directed=False)
+
+        order = np.argsort(labels, kind='stable')
+        splits = np.cumsum(np.bincount(labels))[:-1]
+        clusters = [
+            shapely.union_all(cluster)
+            for cluster in np.split(geometries[order], splits)
+        ]
+        return shapely.union_all(
+            shapely.buffer(clusters,
+                           buffer,
+                           cap_style=cap_style,
+                           join_style=join_style))
+
     def _get_rectangle_points(self, chip_name: str) -> Tuple[list, list]:
         """There can be more than one chip in QGeometry. All chips export to
         one gds file. Each chip uses its own subtract rectangle.
@@ -1499,6 +1884,7 @@ class QGDSRenderer(QRenderer):
 
         return layers_in_chip, rectangle_points
 
+    @profiled()
     def _populate_poly_path_for_export(self):
         """Using the geometries for each table name in QGeometry, populate
         self.lib to eventually write to a GDS file.
@@ -1522,30 +1908,44 @@ class QGDSRenderer(QRenderer):
             all_chips_top_name = 'TOP'
             all_chips_top = lib.new_cell(all_chips_top_name,
                                          overwrite_duplicate=True)
-            for chip_name, _ in self.chip_info.items():
-                chip_only_top_name = f'TOP_{chip_name}'
-                chip_only_top = lib.new_cell(chip_only_top_name,
-                                             overwrite_duplicate=True)
+            for chip_name in self.chip_info:
+                self._populate_poly_path_for_chip(lib, all_chips_top, chip_name,
+                                                  precision, max_points)
 
-                layers_in_chip, rectangle_points = self._get_rectangle_points(
-                    chip_name)
+    def _populate_poly_path_for_chip(self, lib: gdspy.GdsLibrary,
+                                     all_chips_top: gdspy.library.Cell,
+                                     chip_name: str, precision: float,
+                                     max_points: int):
+        """Populate lib with the cell f'TOP_{chip_name}' of one chip, and
+        add it to all_chips_top unless it is empty.
 
-                for chip_layer in layers_in_chip:
-                    self._handle_photo_resist(lib, chip_only_top, chip_name,
-                                              chip_layer, rectangle_points,
-                                              precision, max_points)
+        Args:
+            lib (gdspy.GdsLibrary): The gdspy library to export.
+            all_chips_top (gdspy.library.Cell): The cell 'TOP' of all chips.
+            chip_name (str): Name of chip to render.
+            precision (float): Used for gdspy.
+            max_points (int): Used for gdspy. GDSpy uses 199 as the default.
+        """
+        chip_only_top_name = f'TOP_{chip_name}'
+        chip_only_top = lib.new_cell(chip_only_top_name,
+                                     overwrite_duplicate=True)
 
-                # If junction table, import the cell and cell to chip_only_top
-                if 'junction' in self.chip_info[chip_name]:
-                    self._import_junctions_to_one_cell(chip_name, lib,
-                                                       chip_only_top,
-                                                       layers_in_chip)
+        layers_in_chip, rectangle_points = self._get_rectangle_points(chip_name)
 
-                # put all chips into TOP
-                if chip_only_top.get_bounding_box() is not None:
-                    all_chips_top.add(gdspy.CellReference(chip_only_top))
-                else:
-                    lib.remove(chip_only_top)
+        for chip_layer in layers_in_chip:
+            self._handle_photo_resist(lib, chip_only_top, chip_name, chip_layer,
+                                      rectangle_points, precision, max_points)
+
+        # If junction table, import the cell and cell to chip_only_top
+        if 'junction' in self.chip_info[chip_name]:
+            self._import_junctions_to_one_cell(chip_name, lib, chip_only_top,
+                                               layers_in_chip)
+
+        # put all chips into TOP
+        if chip_only_top.get_bounding_box() is not None:
+            all_chips_top.add(gdspy.CellReference(chip_only_top))
+        else:
+            lib.remove(chip_only_top)
 
     def _handle_photo_resist(self, lib: gdspy.GdsLibrary,
                              chip_only_top: gdspy.library.Cell, chip_name: str,
@@ -1695,6 +2095,7 @@ class QGDSRenderer(QRenderer):
                 ground_cell.add(gdspy.CellReference(ground_chip_layer))
 
         self._handle_q_subtract_false(chip_name, chip_layer, ground_cell)
+        self._add_instances(lib, chip_name, chip_layer, ground_cell)
         QGDSRenderer._add_groundcell_to_chip_only_top(lib, chip_only_top,
                                                       ground_cell)
 
@@ -1859,8 +2260,10 @@ class QGDSRenderer(QRenderer):
             return True
 
         if os.path.isfile(self.options.path_filename):
+            names_before = set(lib.cells)
             lib.read_gds(self.options.path_filename, units='convert')
             self.imported_junction_gds = self.options.path_filename
+            self.imported_junction_cells = set(lib.cells) - names_before
             return True
         else:
             message_str = (
@@ -2123,9 +2526,12 @@ class QGDSRenderer(QRenderer):
         else:
             lib.remove(temp_cell)
 
+    @profiled()
     def export_to_gds(self,
                       file_name: str,
-                      highlight_qcomponents: list = None) -> int:
+                      highlight_qcomponents: list = None,
+                      stream: bool = False,
+                      max_workers: int = 1) -> int:
         """Use the design which was used to initialize this class. The
         QGeometry element types of both "path" and "poly", will be used, to
         convert QGeometry to GDS formatted file.
@@ -2136,6 +2542,15 @@ class QGDSRenderer(QRenderer):
             highlight_qcomponents (list): List of strings which denote
                                         the name of QComponents to render.
                                         If empty, render all components in design.
+            stream (bool): Write the file one chip at a time, and release the
+                            cells of each chip once written, so that only one
+                            chip is held in memory.  See
+                            _export_to_gds_stream().  Defaults to False.
+            max_workers (int): Number of processes which convert, subtract
+                            and cheese the layers of the chips, see
+                            _export_layers_parallel().  None for the number
+                            of CPUs.  Defaults to 1, to do it all in this
+                            process.
 
         Returns:
             int: 0=file_name can not be written, otherwise 1=file_name has been written
@@ -2157,6 +2572,36 @@ class QGDSRenderer(QRenderer):
 
         # if imported, hold the path to file name, otherwise None.
         self.imported_junction_gds = None
+        self.imported_junction_cells = set()
+
+        # Forget the GDS fragments of the QComponents deleted since the last
+        # export.
+        # pylint: disable=protected-access
+        self._fragment_cache = {
+            key: fragment
+            for key, fragment in self._fragment_cache.items()
+            if key[3] in self.design._components
+        }
+
+        if stream:
+            return self._export_to_gds_stream(file_name, highlight_qcomponents,
+                                              max_workers)
+
+        if max_workers != 1:
+            if self._create_qgeometry_for_gds(highlight_qcomponents,
+                                              convert=False) != 0:
+                return 0
+            lib = self.new_gds_library()
+            all_chips_top = None
+            if is_true(self.options.ground_plane):
+                all_chips_top = lib.new_cell('TOP', overwrite_duplicate=True)
+            with ProcessPoolExecutor(max_workers=max_workers) as executor:
+                self._export_layers_parallel(executor, lib,
+                                             list(self.chip_info),
+                                             all_chips_top)
+            with profiler.span('QGDSRenderer.write_gds'):
+                self.lib.write_gds(file_name)
+            return 1
 
         if self._create_qgeometry_for_gds(highlight_qcomponents) == 0:
             # Create self.lib and populate path and poly.
@@ -2173,12 +2618,296 @@ class QGDSRenderer(QRenderer):
             self._populate_cheese()
 
             # Export the file to disk from self.lib
-            self.lib.write_gds(file_name)
+            with profiler.span('QGDSRenderer.write_gds'):
+                self.lib.write_gds(file_name)
 
             return 1
 
         return 0
 
+    @profiled()
+    def _export_to_gds_stream(self,
+                              file_name: str,
+                              highlight_qcomponents: list,
+                              max_workers: int = 1) -> int:
+        """Export the design to file_name, one chip at a time.
+
+        Each chip goes through the same steps as in export_to_gds(): gather
+        its QGeometry, populate its cells, then the no-cheese and cheese.
+        Then its cells are written to the file, and removed from self.lib
+        along with the data of the chip in self.chip_info.  The GDS fragments
+        of the chip are kept for the next export.  The cell 'TOP', which
+        references the chips by name, is written last.  The cells imported
+        for the junctions are kept, as every chip may use them.
+
+        Args:
+            file_name (str): File name which can also include directory path.
+            highlight_qcomponents (list): List of strings which denote
+                                        the name of QComponents to render.
+                                        If empty, render all components in design.
+            max_workers (int): Number of processes for the layers of each
+                                chip, see _export_layers_parallel().
+                                Defaults to 1, for none.
+
+        Returns:
+            int: 0=file_name can not be written, otherwise 1=file_name has been written
+        """
+        unique_qcomponents, status = self._check_qcomps(highlight_qcomponents)
+        if status == 1:
+            return 0
+        self.dict_bounds.clear()
+
+        precision = float(self.parse_value(self.options.precision))
+        max_points = int(self.parse_value(self.options.max_points))
+        ground_plane = is_true(self.options.ground_plane)
+
+        lib = self.new_gds_library()
+        all_chips_top = None
+        if ground_plane:
+            all_chips_top = lib.new_cell('TOP', overwrite_duplicate=True)
+
+        writer = gdspy.GdsWriter(file_name,
+                                 unit=lib.unit,
+                                 precision=lib.precision)
+        written = set()
+        executor = None
+        if max_workers != 1:
+            executor = ProcessPoolExecutor(max_workers=max_workers)
+        try:
+            for chip_name in self.chip_info:
+                with profiler.span('QGDSRenderer.export_chip', chip=chip_name):
+                    self._create_qgeometry_for_chip(chip_name,
+                                                    unique_qcomponents,
+                                                    highlight_qcomponents,
+                                                    convert=executor is None)
+                    if executor is not None:
+                        self._export_layers_parallel(executor, lib, [chip_name],
+                                                     all_chips_top)
+                    else:
+                        if ground_plane:
+                            self._populate_poly_path_for_chip(
+                                lib, all_chips_top, chip_name, precision,
+                                max_points)
+                        self._populate_no_cheese_for_chip(chip_name)
+                        self._populate_cheese_for_chip(chip_name)
+
+                    self._write_finished_cells(writer, written, keep=['TOP'])
+                    self.chip_info[chip_name].clear()
+
+            if all_chips_top is not None:
+                writer.write_cell(all_chips_top)
+        finally:
+            writer.close()
+            if executor is not None:
+                executor.shutdown()
+
+        return 1
+
+    def _write_finished_cells(self, writer: gdspy.GdsWriter, written: set,
+                              keep: list):
+        """Write the cells of self.lib to writer, then remove them from
+        self.lib.
+
+        Args:
+            writer (gdspy.GdsWriter): The file being written.
+            written (set): Names of the cells already written.  Updated.
+            keep (list): Names of the cells to neither write nor remove.
+                        Their references to the removed cells are changed
+                        to references by name, so that the cells are freed.
+        """
+        for name, cell in list(self.lib.cells.items()):
+            if name in keep:
+                continue
+            if name in written:
+                if name not in self.imported_junction_cells:
+                    self.logger.warning(
+                        f'The cell {name} was already written to the GDS '
+                        f'file by a previous chip. It was not written again.')
+                continue
+            writer.write_cell(cell)
+            written.add(name)
+
+        for name in list(self.lib.cells):
+            if name not in keep and name not in self.imported_junction_cells:
+                self.lib.remove(name, remove_references=False)
+
+        for name in keep:
+            if name in self.lib.cells:
+                for reference in self.lib.cells[name].references:
+                    reference.ref_cell = getattr(reference.ref_cell, 'name',
+                                                 reference.ref_cell)
+
+    # Export the layers of the chips in worker processes.
+
+    @profiled()
+    def _export_layers_parallel(self,
+                                executor: Executor,
+                                lib: gdspy.GdsLibrary,
+                                chip_names: list,
+                                all_chips_top: gdspy.library.Cell = None):
+        """Populate lib with the chips of chip_names, with one job per layer
+        of each chip, run by executor.
+
+        Each job converts the geometries of its layer, gathered by
+        _create_qgeometry_for_chip() with convert=False, then makes the
+        ground, junctions, no-cheese and cheese of the layer, see
+        _export_layer().  The layers do not depend on each other, so the jobs
+        all run at once.  Their cells are then added to lib in the order of
+        the chips and of their layers, so the file does not depend on which
+        job ends first.
+
+        Args:
+            executor (Executor): Runs the jobs, such as a ProcessPoolExecutor.
+            lib (gdspy.GdsLibrary): The gdspy library to export.
+            chip_names (list): Names of the chips to render.
+            all_chips_top (gdspy.library.Cell): The cell 'TOP' of all chips.
+                                Defaults to None, for no ground plane.
+        """
+        jobs = []
+        for chip_name in chip_names:
+            layers_in_chip, rectangle_points = self._get_rectangle_points(
+                chip_name)
+            for chip_layer in layers_in_chip:
+                job = self._layer_job(chip_name, chip_layer)
+                future = executor.submit(job._export_layer, chip_name,
+                                         chip_layer, rectangle_points)
+                jobs.append((chip_name, chip_layer, future))
+
+        chip_tops = dict()
+        if all_chips_top is not None:
+            for chip_name in chip_names:
+                chip_tops[chip_name] = lib.new_cell(f'TOP_{chip_name}',
+                                                    overwrite_duplicate=True)
+                if 'junction' in self.chip_info[chip_name]:
+                    # The jobs use their own copy of the junction cells.
+                    dummy_status, directory_name = can_write_to_path(
+                        self.options.path_filename)
+                    self._import_junction_gds_file(lib, directory_name)
+
+        for chip_name, chip_layer, future in jobs:
+            self._merge_layer(lib, chip_tops.get(chip_name), chip_name,
+                              chip_layer, future.result())
+
+        # put all chips into TOP
+        for chip_only_top in chip_tops.values():
+            if chip_only_top.get_bounding_box() is not None:
+                all_chips_top.add(gdspy.CellReference(chip_only_top))
+            else:
+                lib.remove(chip_only_top)
+
+    def _layer_job(self, chip_name: str, chip_layer: int) -> 'QGDSRenderer':
+        """Copy of this renderer which holds only what _export_layer() needs
+        for one layer of a chip, so that it is cheap to send to a worker
+        process.
+
+        Args:
+            chip_name (str): Name of chip to render.
+            chip_layer (int): Layer of the chip to render.
+
+        Returns:
+            QGDSRenderer: The copy.
+        """
+        # pylint: disable=protected-access
+        job = copy(self)
+        job._design = _DesignSnapshot(self.design, chip_name)
+        job._render_record = None
+        job.lib = None
+        job.dict_bounds = Dict()
+        job.chip_info = {
+            chip_name: Dict({chip_layer: self.chip_info[chip_name][chip_layer]})
+        }
+        junction = self.chip_info[chip_name].get('junction')
+        if junction is not None:
+            job.chip_info[chip_name]['junction'] = junction[junction['layer'] ==
+                                                            chip_layer]
+        job.imported_junction_gds = None
+        job.imported_junction_cells = set()
+        job._fragment_cache = {
+            key: fragment
+            for key, fragment in self._fragment_cache.items()
+            if key[:2] == (chip_name, chip_layer)
+        }
+        return job
+
+    def _export_layer(self, chip_name: str, chip_layer: int,
+                      rectangle_points: list) -> Dict:
+        """Do for one layer of a chip what export_to_gds() does for every
+        layer, in a gdspy library of its own.  Run by a worker process, on a
+        copy made by _layer_job().
+
+        Args:
+            chip_name (str): Name of chip to render.
+            chip_layer (int): Layer of the chip to render.
+            rectangle_points (list): The rectangle to denote the ground
+                                    for the layer.
+
+        Returns:
+            Dict: The 'cells' made for the layer, the 'references' to them
+            to add to the cell f'TOP_{chip_name}', the 'layer_info' for
+            self.chip_info and the GDS 'fragments' of the layer.
+        """
+        precision = float(self.parse_value(self.options.precision))
+        max_points = int(self.parse_value(self.options.max_points))
+
+        unit = float(self.parse_value(self.options.gds_unit))
+
+        self.lib = gdspy.GdsLibrary(unit=unit, precision=precision)
+        chip_only_top = self.lib.new_cell(f'TOP_{chip_name}')
+
+        if is_true(self.options.ground_plane):
+            self._qgeometry_to_gds_for_layer(chip_name, chip_layer)
+            self._handle_photo_resist(self.lib, chip_only_top, chip_name,
+                                      chip_layer, rectangle_points, precision,
+                                      max_points)
+            # The junction table of the job only has the rows of the layer.
+            junction = self.chip_info[chip_name].get('junction')
+            if junction is not None and not junction.empty:
+                self._import_junctions_to_one_cell(chip_name, self.lib,
+                                                   chip_only_top, [chip_layer])
+
+        self._populate_no_cheese_for_layer(chip_name, chip_layer)
+        self._populate_cheese_for_layer(chip_name, chip_layer)
+
+        cells = [
+            cell for name, cell in self.lib.cells.items()
+            if name != chip_only_top.name and
+            name not in self.imported_junction_cells
+        ]
+        return Dict(cells=cells,
+                    references=list(chip_only_top.references),
+                    layer_info=self.chip_info[chip_name][chip_layer],
+                    fragments=self._fragment_cache)
+
+    def _merge_layer(self, lib: gdspy.GdsLibrary,
+                     chip_only_top: Union[gdspy.library.Cell, None],
+                     chip_name: str, chip_layer: int, result: Dict):
+        """Add the result of _export_layer() to lib, self.chip_info and the
+        cache of GDS fragments.
+
+        Args:
+            lib (gdspy.GdsLibrary): The gdspy library to export.
+            chip_only_top (Union[gdspy.library.Cell, None]): The cell
+                                f'TOP_{chip_name}'. None for no ground plane.
+            chip_name (str): Name of chip to render.
+            chip_layer (int): Layer of the chip to render.
+            result (Dict): Result of _export_layer().
+        """
+        references = list(result.references)
+        for cell in result.cells:
+            lib.add(cell, overwrite_duplicate=True, include_dependencies=False)
+            references += cell.references
+
+        # The job referenced its own copy of the junction cells.
+        for reference in references:
+            name = getattr(reference.ref_cell, 'name', reference.ref_cell)
+            if name in lib.cells:
+                reference.ref_cell = lib.cells[name]
+
+        if chip_only_top is not None:
+            chip_only_top.add(list(result.references))
+        self.chip_info[chip_name][chip_layer] = result.layer_info
+        self._fragment_cache.update(result.fragments)
+
     def _multipolygon_to_gds(
             self, multi_poly: shapely.geometry.multipolygon.MultiPolygon,
             layer: int, data_type: int, no_cheese_buffer: float) -> list:
@@ -2392,3 +3121,35 @@ class QGDSRenderer(QRenderer):
         for chip in unique_list:
             unique_dict[chip] = Dict()
         return unique_dict
+
+
+class _DesignSnapshot:
+    """The parts of a QDesign which QGDSRenderer._export_layer() uses, for
+    one chip.  Unlike the QDesign, it is cheap to send to a worker process.
+    """
+
+    def __init__(self, design: 'QDesign', chip_name: str):
+        """
+        Args:
+            design (QDesign): The design to export.
+            chip_name (str): Name of the chip to export.
+        """
+        self.variables = deepcopy(design.variables)
+        self.logger = design.logger
+        self._chip_box = design.get_x_y_for_chip(chip_name)
+        # Only the names of the QComponents, for the warnings.
+        # pylint: disable=protected-access
+        self._components = {
+            component_id: SimpleNamespace(_name=qcomp.name)
+            for component_id, qcomp in design._components.items()
+        }
+
+    def parse_value(self, value):
+        """Same as QDesign.parse_value(), with the variables of the design."""
+        return parse_value(value, self.variables)
+
+    def get_x_y_for_chip(self, chip_name: str) -> Tuple[tuple, int]:
+        """Same as QDesign.get_x_y_for_chip(), for the chip of the snapshot.
+        """
+        # pylint: disable=unused-argument
+        return self._chip_box
@@ -166,6 +166,9 @@ class Cheesing():
 
         self.hole = None
 
+        # Origins of the holes which do not overlap the no-cheese region.
+        self.clear_hole_origins = np.zeros((0, 2))
+
     def apply_cheesing(self) -> gdspy.GdsLibrary:
         """Prototype, not complete.
 
@@ -387,17 +390,23 @@ class Cheesing():
         diff_holes_cell_name = f'TOP_{self.chip_name}_{self.layer}_Cheese_diff'
         diff_holes_cell = self.lib.new_cell(diff_holes_cell_name,
                                             overwrite_duplicate=True)
-        diff_holes_cell.add(diff_holes)
+        if diff_holes is not None:
+            diff_holes_cell.add(diff_holes)
+
+        clear_holes = self._get_clear_holes()
+        if clear_holes is not None:
+            diff_holes_cell.add(clear_holes)
 
         self.lib.remove(temp_keepout_chip_layer_cell)
         return diff_holes_cell
 
     def _get_all_holes(self) -> gdspy.library.Cell:
-        """Return a cell with a grid of holes. The keepout has not been
-        applied yet.
+        """Return a cell with the holes of the grid which may overlap the
+        keepout.  The keepout has not been applied yet.  The origins of the
+        other holes are placed in self.clear_hole_origins.
 
         Returns:
-            gdspy.library.Cell: Cell containing all the holes.
+            gdspy.library.Cell: Cell containing the holes near the keepout.
         """
         gather_holes_cell_name = f'Gather_holes_{self.chip_name}_{self.layer}'
         gather_holes_cell = self.lib.new_cell(gather_holes_cell_name,
@@ -406,21 +415,75 @@ class Cheesing():
         x_holes = np.arange(self.grid_minx,
                             self.grid_maxx,
                             self.delta_x,
-                            dtype=float).tolist()
+                            dtype=float)
         y_holes = np.arange(self.grid_miny,
                             self.grid_maxy,
                             self.delta_y,
-                            dtype=float).tolist()
+                            dtype=float)
+        x_grid, y_grid = np.meshgrid(x_holes, y_holes, indexing='ij')
+        origins = np.column_stack([x_grid.ravel(), y_grid.ravel()])
+
+        touching = self._holes_touching_keepout(origins)
+        self.clear_hole_origins = origins[~touching]
 
         if self.one_hole_cell is not None:
-            for x_loc in x_holes:
-                for y_loc in y_holes:
-                    gather_holes_cell.add(
-                        gdspy.CellReference(self.one_hole_cell,
-                                            origin=(x_loc, y_loc)))
+            for x_loc, y_loc in origins[touching].tolist():
+                gather_holes_cell.add(
+                    gdspy.CellReference(self.one_hole_cell,
+                                        origin=(x_loc, y_loc)))
 
         return gather_holes_cell
 
+    def _holes_touching_keepout(self, origins: np.ndarray) -> np.ndarray:
+        """Find the holes whose bounding box intersects the no-cheese
+        region.  Only these need the boolean with the keepout, the others
+        are kept whole.
+
+        The parts of self.multi_poly are placed in an STRtree, which is
+        queried with the boxes of all the holes at once.
+
+        Args:
+            origins (np.ndarray): The origins of the holes, one row each.
+
+        Returns:
+            np.ndarray: True for each hole which may overlap the keepout.
+        """
+        touching = np.ones(len(origins), dtype=bool)
+        if self.hole is None or not isinstance(
+                self.multi_poly, shapely.geometry.base.BaseGeometry):
+            return touching
+
+        minx, miny, maxx, maxy = self.hole.bounds
+        boxes = shapely.box(origins[:, 0] + minx, origins[:, 1] + miny,
+                            origins[:, 0] + maxx, origins[:, 1] + maxy)
+        tree = shapely.STRtree(shapely.get_parts(self.multi_poly))
+        hits, _ = tree.query(boxes, predicate='intersects')
+
+        touching[:] = False
+        touching[hits] = True
+        return touching
+
+    def _get_clear_holes(self) -> Union[gdspy.PolygonSet, None]:
+        """The holes at self.clear_hole_origins, on the datatype of the
+        holes which went through the boolean with the keepout.
+
+        Returns:
+            Union[gdspy.PolygonSet, None]: The holes, or None if there are
+            none.
+        """
+        if self.one_hole_cell is None or len(self.clear_hole_origins) == 0:
+            return None
+
+        polygons = list()
+        for polygon in self.one_hole_cell.get_polygons():
+            polygons += list(polygon[np.newaxis, :, :] +
+                             self.clear_hole_origins[:, np.newaxis, :])
+        if not polygons:
+            return None
+        return gdspy.PolygonSet(polygons,
+                                layer=self.layer,
+                                datatype=self.datatype_cheese + 1)
+
     def _subtract_holes_from_ground(
             self, diff_holes_cell) -> Union[gdspy.library.Cell, None]:
         """Get reference to ground cell and then subtract the holes from
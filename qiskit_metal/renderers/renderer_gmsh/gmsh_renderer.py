@@ -9,6 +9,7 @@ from qiskit_metal.renderers.renderer_base import QRenderer
 from .gmsh_utils import Vec3D, Vec3DArray, line_width_offset_pts, render_path_curves
 from qiskit_metal.toolbox_metal.bounds_for_path_and_poly_tables import BoundsForPathAndPolyTables
 from qiskit_metal.toolbox_metal.parsing import parse_value
+from qiskit_metal.toolbox_python.profiler import profiled
 
 from qiskit_metal import Dict
 
@@ -202,6 +203,7 @@ class QGmshRenderer(QRenderer):
                 f"Could not find {props} for the layer_number={layer_num}. "
                 "Check your design and try again.")
 
+    @profiled()
     def render_design(
         self,
         selection: Union[list, None] = None,
@@ -271,6 +273,7 @@ class QGmshRenderer(QRenderer):
             except Exception as e:
                 self.logger.info(f"ERROR: Generate Mesh: {e}")
 
+    @profiled()
     def draw_geometries(self,
                         draw_sample_holder: bool,
                         selection: Union[list, None] = None,
@@ -310,6 +313,7 @@ class QGmshRenderer(QRenderer):
         self.subtract_from_layers(omit_layers=omit_ground_for_layers)
         self.gmsh_occ_synchronize()
 
+    @profiled()
     def apply_changes_for_simulation(self, ignore_metal_volume: bool,
                                      draw_sample_holder: bool):
         """This function fragments interfaces to fuse the boundaries and assigns
@@ -1154,6 +1158,7 @@ class QGmshRenderer(QRenderer):
         gmsh.option.setNumber("Mesh.MeshSizeMin", min_mesh_size)
         gmsh.option.setNumber("Mesh.MeshSizeMax", max_mesh_size)
 
+    @profiled()
     def add_mesh(self,
                  dim: int = 3,
                  intelli_mesh: bool = True,
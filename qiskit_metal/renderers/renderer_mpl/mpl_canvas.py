@@ -503,6 +503,30 @@ class PlotCanvas(FigureCanvas):
             main_plot()
             final()
 
+    def update_plot(self):
+        """Redraw only the components which changed since the last plot,
+        keeping the artists of the others, the annotations and the view.
+
+        Plots everything, see `plot`, when the axis was not plotted yet or
+        the renderer asks for it, such as after a layer is hidden.
+        """
+        ax = self.get_axis()
+        xlim, ylim = ax.get_xlim(), ax.get_ylim()
+        try:
+            with mpl.rc_context(rc=self.mpl_context):
+                updated = self.metal_renderer.update(ax)
+        except Exception as e:
+            log_error_easy(self.logger, post_text=f'Plotting error: {e}')
+            updated = False
+        if not updated:
+            self.plot()
+            return
+
+        # Adding collections requests an autoscale of the view
+        ax.set_xlim(xlim)
+        ax.set_ylim(ylim)
+        self.draw_idle()
+
     def _watermark_axis(self, ax: plt.Axes):
         """Add a watermark.
 
@@ -84,6 +84,13 @@ class QMplRenderer():
         # Set of component ids which are integers.
         self._hidden_components = set()
 
+        # Component id of each path of the collections drawn, and the
+        # fingerprint of the qgeometry of the components when drawn, see update.
+        self._owners = dict()  # collection -> np.ndarray of component ids
+        self._patches = dict()  # PatchCollection -> np.ndarray of its patches
+        self._fingerprints = dict()
+        self._rendered_ax = None
+
         self.colors = [
             '#1f77b4', '#ff7f0e', '#2ca02c', '#d62728', '#9467bd', '#8c564b',
             '#e377c2', '#7f7f7f', '#bcbd22', '#17becf'
@@ -102,33 +109,45 @@ class QMplRenderer():
 
     def hide_component(self, name):
         """Hide the component with the given name.
+        Its paths are removed from the drawn collections, without rendering
+        the design again.
         Args:
             name (str): Component name
         """
         comp_id = self.design.components[name].id
         self._hidden_components.add(comp_id)
+        self._remove_components({comp_id})
 
     def show_component(self, name):
         """Show the component with the given name.
+        Only this component is rendered, in its own collections.
         Args:
             name (str): Component name
         """
         comp_id = self.design.components[name].id
-        self._hidden_components.discard(name)
+        if comp_id not in self._hidden_components:
+            return
+        self._hidden_components.discard(comp_id)
+        if self._rendered_ax is not None:
+            self._render_component(self._rendered_ax, comp_id)
 
     def hide_layer(self, name):
         """Hide the layer with the given name.
+        The next update renders the whole design again.
         Args:
             name (str): Layer name
         """
         self.hidden_layers.add(name)
+        self.forget_render()
 
     def show_layer(self, name):
         """Show the layer with the given name.
+        The next update renders the whole design again.
         Args:
             name (str): Layer name
         """
         self.hidden_layers.discard(name)
+        self.forget_render()
 
     def set_design(self, design: QDesign):
         """Set the design.
@@ -137,7 +156,7 @@ class QMplRenderer():
         """
         self.design = design
         self.clear_options()
-        # TODO
+        self.forget_render()
 
     def clear_options(self):
         """Clear all options."""
@@ -153,6 +172,43 @@ class QMplRenderer():
         self.logger.debug('Rendering element tables to plot window.')
         self.render_tables(ax)
 
+    def update(self, ax: Axes) -> bool:
+        """Redraw only the components whose qgeometry changed since the last
+        render or update on the axis: their paths are removed from the drawn
+        collections, and they are drawn again in their own collections.  The
+        other components are kept as drawn.
+
+        Args:
+            ax (matplotlib.axes.Axes): mpl axis of the last render
+
+        Returns:
+            bool: False if the axis was not rendered yet, or was cleared since;
+            call `render` on the cleared axis instead.
+        """
+        if ax is not self._rendered_ax:
+            return False
+
+        fingerprints = self.qgeometry.get_component_fingerprints()
+        changed = set(
+            comp_id
+            for comp_id in set(fingerprints) | set(self._fingerprints)
+            if fingerprints.get(comp_id) != self._fingerprints.get(comp_id))
+        self._remove_components(changed)
+        for comp_id in changed:
+            if (comp_id in fingerprints and
+                    comp_id not in self._hidden_components):
+                self._render_component(ax, comp_id)
+        self._fingerprints = fingerprints
+        return True
+
+    def forget_render(self):
+        """Forget the collections of the last render, so that the next update
+        fails and the design is rendered again."""
+        self._owners.clear()
+        self._patches.clear()
+        self._fingerprints.clear()
+        self._rendered_ax = None
+
     def get_mask(self, table: pd.DataFrame) -> pd.Series:
         """Gets the mask.
         Args:
@@ -166,21 +222,10 @@ class QMplRenderer():
         # not direct access to underlying internal representation
 
         mask = table.layer.isin(self.hidden_layers)
-        mask = table.component.isin(self._hidden_components)
+        mask |= table.component.isin(self._hidden_components)
 
         return ~mask  # not
 
-    def _render_poly_array(self, ax: Axes, poly_array: np.array, mpl_kw: dict):
-        """Render the poly array.
-        Args:
-            ax (Axes): The axis
-            poly_array (np.array): The poly
-            mpl_kw (dict): The parameters dictionary
-        """
-        if len(poly_array) > 0:
-            poly_array = to_poly_patch(poly_array)
-            ax.add_collection(PatchCollection(poly_array, **mpl_kw))
-
     @property
     def qgeometry(self) -> 'QGeometryTables':
         """Return the qgeometry of the design."""
@@ -238,27 +283,99 @@ class QMplRenderer():
         return kw
 
     def render_tables(self, ax: Axes):
-        """Render the tables.
+        """Render the tables, with one collection per table, layer and
+        subtract flag.  The component of each path is kept for `update`,
+        `hide_component` and `show_component`.
         Args:
             ax (Axes): The axes
         """
+        self.forget_render()
         for element_type, table in self.qgeometry.tables.items():
             # Mask the table
-            table = table[self.get_mask(table)]
-
-            # subtracted
-            mask = table['subtract'] == True
-            render_func = getattr(self, f'render_{element_type}')
-            render_func(table[mask], ax, subtracted=True)
+            self._render_table(ax, element_type, table[self.get_mask(table)])
+        self._fingerprints = self.qgeometry.get_component_fingerprints()
+        self._rendered_ax = ax
 
-            # non-subtracted
-            table1 = table[~mask]
-            # TODO: do by layer and color
-            # self.get_color_num()
+    def _render_table(self, ax: Axes, element_type: str, table: pd.DataFrame):
+        """Render the rows of a table, per layer and subtract flag.
+        Args:
+            ax (Axes): The axes
+            element_type (str): Name of the table, such as 'poly'
+            table (pd.DataFrame): The rows to render
+        """
+        # TODO: Check that the function exists
+        render_func = getattr(self, f'render_{element_type}')
+        for (_, subtracted), rows in table.groupby(['layer', 'subtract'],
+                                                   sort=True):
+            render_func(rows, ax, subtracted=bool(subtracted))
+
+    def _render_component(self, ax: Axes, comp_id: int):
+        """Render the tables of one component, in its own collections.
+        Args:
+            ax (Axes): The axes
+            comp_id (int): Id of the component
+        """
+        for element_type in self.qgeometry.get_element_types():
+            table = self.qgeometry.tables.get_component(element_type, comp_id)
+            # Mask the hidden layers
+            self._render_table(ax, element_type,
+                               table[~table.layer.isin(self.hidden_layers)])
+
+    def _remove_components(self, comp_ids: set):
+        """Remove the paths of components from the drawn collections.
+        Args:
+            comp_ids (set): Ids of the components
+        """
+        if not comp_ids:
+            return
+        comp_ids = list(comp_ids)
+        for collection, owners in list(self._owners.items()):
+            keep = ~np.isin(owners, comp_ids)
+            if keep.all():
+                continue
+            if not keep.any():
+                collection.remove()
+                del self._owners[collection]
+                self._patches.pop(collection, None)
+                continue
+            if isinstance(collection, PatchCollection):
+                self._patches[collection] = self._patches[collection][keep]
+                collection.set_paths(list(self._patches[collection]))
+            else:
+                collection.set_segments([
+                    segment
+                    for segment, kept in zip(collection.get_segments(), keep)
+                    if kept
+                ])
+            self._owners[collection] = owners[keep]
+
+    @staticmethod
+    def get_zorder(layer: int, subtracted: bool) -> float:
+        """Get the zorder of the collections of a layer.
+        The subtracted shapes are drawn under the metal of their layer, and
+        the higher layers over the lower ones.
+        Args:
+            layer (int): The layer
+            subtracted (bool): True for the subtracted shapes
+        Return:
+            float: The zorder
+        """
+        return 1 + 0.01 * float(layer) + (0 if subtracted else 0.005)
 
-            # TODO: Check that the function exists
-            render_func = getattr(self, f'render_{element_type}')
-            render_func(table1, ax, subtracted=False)
+    def _add_collection(self, ax: Axes, collection, table: pd.DataFrame,
+                        subtracted: bool):
+        """Add a collection with one path per row of a table, all on one
+        layer, and keep the component of each path.
+        Args:
+            ax (Axes): The axes
+            collection (Collection): The collection
+            table (pd.DataFrame): The rows drawn by the collection
+            subtracted (bool): True for the subtracted rows
+        """
+        collection.set_zorder(
+            self.get_zorder(table.layer.iloc[0], subtracted))
+        ax.add_collection(collection)
+        self._owners[collection] = table.component.to_numpy()
 
     def render_junction(self,
                         table: pd.DataFrame,
@@ -306,7 +423,11 @@ class QMplRenderer():
             return
 
         kw = self.get_style('poly', subtracted=subtracted, extra=extra_kw)
-        self._render_poly_array(ax, table.geometry, kw)
+        patches = to_poly_patch(table.geometry)
+        collection = PatchCollection(patches, **kw)
+        self._add_collection(ax, collection, table, subtracted=subtracted)
+        # set_paths of a PatchCollection takes patches, kept to remove some
+        self._patches[collection] = np.asarray(patches, dtype=object)
 
     def render_fillet(self, table):
         """Renders fillet path.
@@ -484,7 +605,10 @@ class QMplRenderer():
         if len(table1) > 0:
             kw = self.get_style('path', subtracted=subtracted, extra=extra_kw)
             line_segments = LineCollection(table1.geometry)
-            ax.add_collection(line_segments)
+            self._add_collection(ax,
+                                 line_segments,
+                                 table1,
+                                 subtracted=subtracted)
 
 
 # DEFAULT['renderer_mpl'] = Dict(
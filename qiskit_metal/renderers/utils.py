@@ -16,20 +16,10 @@ def get_min_bounding_box(design: QDesign, qcomp_ids: List[int], case: int,
     max_x_main = max_y_main = float("-inf")
     if case == 2:  # One or more components not in QDesign.
         logger.warning("One or more components not found.")
-    elif case == 1:  # All components rendered.
-        for qcomp in design.components:
-            min_x, min_y, max_x, max_y = design.components[
-                qcomp].qgeometry_bounds()
-            min_x_main = min(min_x, min_x_main)
-            min_y_main = min(min_y, min_y_main)
-            max_x_main = max(max_x, max_x_main)
-            max_y_main = max(max_y, max_y_main)
-    else:  # Strict subset rendered.
-        for qcomp_id in qcomp_ids:
-            min_x, min_y, max_x, max_y = design._components[
-                qcomp_id].qgeometry_bounds()
-            min_x_main = min(min_x, min_x_main)
-            min_y_main = min(min_y, min_y_main)
-            max_x_main = max(max_x, max_x_main)
-            max_y_main = max(max_y, max_y_main)
+    else:
+        # Aggregated from the cached bounds of each component.
+        # Case 1 renders all components, else a strict subset.
+        bounds = design.qgeometry.get_bounds(None if case == 1 else qcomp_ids)
+        if bounds is not None:
+            min_x_main, min_y_main, max_x_main, max_y_main = bounds
     return min_x_main, min_y_main, max_x_main, max_y_main
@@ -18,23 +18,60 @@
 # pylint: disable-msg=too-many-public-methods
 """Qiskit Metal unit tests analyses functionality."""
 
+from contextlib import redirect_stdout
+import io
 from pathlib import Path
+import tempfile
 import unittest
+from unittest.mock import patch
 
 import numpy as np
 import pandas as pd
 
 from qiskit_metal.analyses.quantization import lumped_capacitive
+from qiskit_metal.analyses.quantization.lom_core_analysis import (
+    CircuitGraph, Cell, CompositeSystem, CouplingType, Subsystem)
 from qiskit_metal.analyses.hamiltonian.transmon_charge_basis import Hcpb
+from qiskit_metal.analyses.hamiltonian import charge_dispersion
+from qiskit_metal.analyses.hamiltonian import states_energies
 from qiskit_metal.analyses.hamiltonian.HO_wavefunctions import wavefunction
 from qiskit_metal.analyses.em import cpw_calculations, kappa_calculation
 from qiskit_metal.analyses.sweep_and_optimize.sweeper import Sweeper
+from qiskit_metal.analyses.sweep_and_optimize.sweep_store import SweepStore
+from qiskit_metal.analyses.sweep_and_optimize.optimizer import (
+    GaussianProcessSurrogate, SurrogateOptimizer, grid_points,
+    latin_hypercube_points)
+from qiskit_metal.analyses.core.base import QAnalysis
+from qiskit_metal.qlibrary.qubits.transmon_pocket import TransmonPocket
 from qiskit_metal.tests.assertions import AssertionsMixin
 from qiskit_metal import designs
 
 TEST_DATA = Path(__file__).parent / "test_data"
 
 
+class MockPadAnalysis(QAnalysis):
+    """Analysis which reads the geometry instead of running a renderer."""
+
+    data_labels = ['pad_width', 'pad_height']
+
+    def __init__(self, design=None, renderer_name=None):
+        super().__init__()
+        self.design = design
+        self.renderer_name = renderer_name
+
+    def run(self, *args, **kwargs):
+        """Store the size of the pad of Q1 as built."""
+        pads = self.design.components['Q1'].qgeometry_table('poly')
+        bounds = pads[pads['name'] == 'pad_top'].total_bounds
+        self.set_data('pad_width', round(bounds[2] - bounds[0], 6))
+        self.set_data('pad_height', round(bounds[3] - bounds[1], 6))
+
+
+def failing_analysis_factory(design):
+    """Any point which is actually run would raise."""
+    raise RuntimeError('Point should have been read from the store.')
+
+
 class TestAnalyses(unittest.TestCase, AssertionsMixin):
     """Unit test class."""
 
@@ -269,6 +306,56 @@ class TestAnalyses(unittest.TestCase, AssertionsMixin):
         with self.assertRaises(ValueError):
             lumped_capacitive.levels_vs_ng_real_units(100, 100, N=-10)
 
+    def test_analyses_lumped_extract_transmon_coupled_noscillator_batch(self):
+        """Test extract_transmon_coupled_Noscillator_batch in
+        lumped_capacitives.py against the single matrix version."""
+        df_cmat = lumped_capacitive.readin_q3d_matrix(TEST_DATA /
+                                                      'q3d_example.txt')[0]
+        # Reorder to bus1, bus2, ground, pad1, pad2, readout
+        df_cmat = df_cmat.iloc[[1, 2, 0, 3, 4, 5], [1, 2, 0, 3, 4, 5]]
+        all_passes = {
+            idx + 1: df_cmat.values * scale
+            for idx, scale in enumerate([0.98, 1.0, 1.03])
+        }
+        args = (1.1e-8, 2e-15, 3, [6.0, 6.2], 7.0)
+
+        result = lumped_capacitive.extract_transmon_coupled_Noscillator_batch(
+            all_passes, *args)
+
+        self.assertEqual(list(result.index), [1, 2, 3])
+        for idx, cmat in all_passes.items():
+            expected = lumped_capacitive.extract_transmon_coupled_Noscillator(
+                cmat, *args)
+            for key in ['fQ', 'EC', 'EJ', 'alpha']:
+                self.assertAlmostEqualRel(expected[key],
+                                          result.loc[idx, key],
+                                          rel_tol=1e-9)
+            self.assertAlmostEqualRel(expected['dispersion'],
+                                      result.loc[idx, 'dispersion'],
+                                      rel_tol=1e-4)
+            self.assertIterableAlmostEqual(expected['gbus'],
+                                           result.loc[idx, 'gbus'],
+                                           rel_tol=1e-9)
+            self.assertIterableAlmostEqual(expected['chi_in_MHz'],
+                                           result.loc[idx, 'chi_in_MHz'],
+                                           rel_tol=1e-9)
+
+        # The batch prints the same summary of the last matrix
+        def printed(function, cmat):
+            with redirect_stdout(io.StringIO()) as out:
+                function(cmat, *args, print_info=True)
+            return [line.split(' ')[0] for line in out.getvalue().splitlines()]
+
+        self.assertEqual(
+            printed(lumped_capacitive.extract_transmon_coupled_Noscillator_batch,
+                    all_passes),
+            printed(lumped_capacitive.extract_transmon_coupled_Noscillator,
+                    all_passes[3]))
+
+        with self.assertRaises(ValueError):
+            lumped_capacitive.extract_transmon_coupled_Noscillator_batch(
+                all_passes, 1.1e-8, 2e-15, 2, [6.0], 7.0)
+
     def test_analyses_lumped_get_c_and_ic(self):
         """Test the functionality of get_C_and_Ic in lumped_capacitives.py."""
         # Setup expected test results
@@ -765,6 +852,75 @@ class TestAnalyses(unittest.TestCase, AssertionsMixin):
         hcpb = Hcpb(nlevels=15, Ej=13971.3, Ec=295.2, ng=0.001)
         self.assertAlmostEqual(hcpb.n_ij(1, 2), 1.4670047579229986)
 
+    def test_analysis_transmon_charge_basis_levels_vs_ng(self):
+        """Test the batched levels_vs_ng and charge_dispersion of the Hcpb
+        class against one diagonalization per offset charge."""
+        hcpb = Hcpb(nlevels=15, Ej=13971.3, Ec=295.2, ng=0.001)
+        charges = np.linspace(-1, 1, 11)
+        levels = hcpb.levels_vs_ng(charges, num_levels=4)
+        self.assertEqual(levels.shape, (11, 4))
+        for charge, level in zip(charges, levels):
+            hcpb.ng = charge
+            self.assertIterableAlmostEqual(level, hcpb.evals[:4], rel_tol=1e-9)
+
+        dispersion = hcpb.charge_dispersion()
+        energies = []
+        for charge in [0, 0.5]:
+            hcpb.ng = charge
+            energies.append(hcpb.evals[:3] - hcpb.evals[0])
+        self.assertIterableAlmostEqual(dispersion,
+                                       np.abs(energies[0] - energies[1]),
+                                       rel_tol=1e-6)
+
+    def test_analysis_charge_dispersion_params_from_spectrum(self):
+        """Test the vectorized params_from_spectrum by computing the spectrum
+        of the Ej and Ec it returns."""
+        f01 = np.array([4500., 5200., 6100.])
+        anharm = np.array([-350., -300., -220.])
+        Ej, Ec = charge_dispersion.params_from_spectrum(f01, anharm)
+
+        hcpb = Hcpb(nlevels=15, Ej=13971.3, Ec=295.2, ng=0.5)
+        for i, _ in enumerate(f01):
+            hcpb.Ej, hcpb.Ec = Ej[i], Ec[i]
+            self.assertAlmostEqualRel(hcpb.fij(0, 1), f01[i], rel_tol=1e-9)
+            self.assertAlmostEqualRel(hcpb.anharm(), anharm[i], rel_tol=1e-9)
+
+        # Same solution from the Hcpb method, and no solution for a target
+        # anharmonicity larger than the frequency
+        self.assertIterableAlmostEqual(hcpb.params_from_spectrum(
+            f01[1], anharm[1]), [Ej[1], Ec[1]],
+                                       rel_tol=1e-9)
+        self.assertTrue(
+            np.isnan(charge_dispersion.params_from_spectrum(5000, 6000)[0]))
+
+    def test_analysis_states_energies_low_lying_eigensystem(self):
+        """Test the sparse low-lying eigenstates give the same frequencies and
+        chi's as the full diagonalization."""
+        dims = [5, 6]
+        num = [np.arange(dim) for dim in dims]
+        diag = np.add.outer(5000. * num[0] - 150. * num[0] * (num[0] - 1),
+                            7000. * num[1]).ravel()
+        ladders = [np.diag(np.sqrt(np.arange(1, dim)), 1) for dim in dims]
+        coupling = 50. * np.kron(ladders[0] + ladders[0].T,
+                                 ladders[1] + ladders[1].T)
+        hamiltonian = np.diag(diag) + coupling
+
+        evals, evecs = np.linalg.eigh(hamiltonian)
+        expected = states_energies.extract_energies((evals, evecs), dims)
+
+        evals, evecs = states_energies.low_lying_eigensystem(hamiltonian, dims)
+        self.assertLess(len(evals), hamiltonian.shape[0])
+        actual = states_energies.extract_energies((evals.copy(), evecs), dims)
+        self.assertTrue(np.allclose(actual[0], expected[0]))
+        self.assertTrue(np.allclose(actual[1], expected[1]))
+        self.assertAlmostEqual(actual[1][0, 0], -300., delta=20.)
+
+        # Starting from the eigenstates of a nearby hamiltonian
+        warm = states_energies.low_lying_eigensystem(1.01 * hamiltonian,
+                                                     dims,
+                                                     warm_start=(evals, evecs))
+        self.assertTrue(np.allclose(warm[0], 1.01 * evals))
+
     def test_analysis_kappa_calculation_kappa_in(self):
         """Test the kappa_in function in kappa_calculation.py."""
         self.assertAlmostEqual(
@@ -781,6 +937,236 @@ class TestAnalyses(unittest.TestCase, AssertionsMixin):
         self.assertEqual(sweeper.option_value(in_dict, 'a'), 1)
         self.assertEqual(sweeper.option_value(in_dict, 'b'), 'bee')
 
+    def test_analysis_sweeper_run_sweep_parallel(self):
+        """Test run_sweep_parallel in the Sweeper class, and resuming from the
+        SweepStore."""
+        design = designs.DesignPlanar()
+        TransmonPocket(design, 'Q1', options=dict(pad_width='400um'))
+        analysis = MockPadAnalysis(design)
+        sweep = ['300um', '350um', '450um']
+
+        with tempfile.TemporaryDirectory() as store_path:
+            all_sweep, code = analysis.run_sweep_parallel('Q1',
+                                                          'pad_width',
+                                                          sweep[:2],
+                                                          store_path=store_path,
+                                                          max_workers=1)
+            self.assertEqual(code, 0)
+            self.assertEqual(all_sweep['300um'].variables.pad_width, 0.3)
+            self.assertEqual(all_sweep['350um'].variables.pad_width, 0.35)
+            # The original design is not modified.
+            self.assertEqual(design.components['Q1'].options.pad_width, '400um')
+            self.assertEqual(len(SweepStore(store_path).completed()), 2)
+
+            # Completed points are read back, the new one runs in a pool.
+            all_sweep, code = analysis.run_sweep_parallel('Q1',
+                                                          'pad_width',
+                                                          sweep,
+                                                          store_path=store_path,
+                                                          max_workers=2)
+            self.assertEqual(code, 0)
+            self.assertEqual(list(all_sweep.keys()), sweep)
+            self.assertEqual(all_sweep['450um'].variables.pad_width, 0.45)
+
+            all_sweep, code = analysis.run_sweep_parallel(
+                'Q1',
+                'pad_width',
+                sweep,
+                store_path=store_path,
+                max_workers=1,
+                analysis_factory=failing_analysis_factory)
+            self.assertEqual(len(all_sweep), 3)
+
+            # The store refuses results of a different sweep.
+            _, code = analysis.run_sweep_parallel('Q1',
+                                                  'pad_height',
+                                                  sweep,
+                                                  store_path=store_path)
+            self.assertEqual(code, 7)
+
+            # Or run with different arguments, or a different setup.
+            _, code = analysis.run_sweep_parallel('Q1',
+                                                  'pad_width',
+                                                  sweep,
+                                                  store_path=store_path,
+                                                  max_workers=1,
+                                                  freq_ghz=6)
+            self.assertEqual(code, 7)
+            analysis.setup.freq_ghz = 6
+            _, code = analysis.run_sweep_parallel('Q1',
+                                                  'pad_width',
+                                                  sweep,
+                                                  store_path=store_path,
+                                                  max_workers=1)
+            self.assertEqual(code, 7)
+
+    def test_analysis_sweeper_run_multi_sweep(self):
+        """Test run_multi_sweep with grid and latin hypercube points."""
+        design = designs.DesignPlanar()
+        TransmonPocket(design, 'Q1')
+        analysis = MockPadAnalysis(design)
+
+        option_keys, points = grid_points({
+            ('Q1', 'pad_width'): [0.3, 0.4],
+            ('Q1', 'pad_height'): [0.1, 0.2, 0.25]
+        })
+        self.assertEqual(len(points), 6)
+        all_sweep, code = analysis.run_multi_sweep(option_keys,
+                                                   points,
+                                                   max_workers=1)
+        self.assertEqual(code, 0)
+        self.assertEqual(all_sweep[(0.4, 0.25)].variables.pad_width, 0.4)
+        self.assertEqual(all_sweep[(0.4, 0.25)].variables.pad_height, 0.25)
+        self.assertEqual(all_sweep[(0.3, 0.1)].options['Q1.pad_height'], 0.1)
+
+        option_keys, points = latin_hypercube_points(
+            {('Q1', 'pad_width'): (0.3, 0.6)}, 5, seed=1)
+        self.assertEqual(len(points), 5)
+        for point in points:
+            self.assertTrue(0.3 <= point[0] <= 0.6)
+
+        _, code = analysis.run_multi_sweep([('Q1', 'not_an_option.x')],
+                                           points,
+                                           max_workers=1)
+        self.assertEqual(code, 3)
+
+    def test_analysis_surrogate_optimizer(self):
+        """Test the SurrogateOptimizer finds the pad width of a target."""
+        design = designs.DesignPlanar()
+        TransmonPocket(design, 'Q1')
+        analysis = MockPadAnalysis(design)
+
+        def objective(sweep_values):
+            return (sweep_values.variables.pad_width - 0.42)**2
+
+        optimizer = SurrogateOptimizer(analysis,
+                                       bounds={('Q1', 'pad_width'): (0.3, 0.6)},
+                                       objective=objective,
+                                       batch_size=2,
+                                       max_workers=1,
+                                       seed=3)
+        result = optimizer.run(num_iterations=3)
+        self.assertEqual(len(result.history), 10)
+        self.assertAlmostEqual(result.best_point['Q1.pad_width'], 0.42, 2)
+
+    def test_analysis_surrogate_singular_kernel(self):
+        """Test the surrogate retries a singular kernel with more noise, and
+        raises if it still can't be factorized."""
+        surrogate = GaussianProcessSurrogate(noise=0.)
+        # Duplicate points make the kernel singular without noise
+        surrogate.fit(np.array([[0.], [0.], [1.]]), np.array([1., 1., 2.]))
+        self.assertIsNotNone(surrogate.length_scale)
+        mean, std = surrogate.predict(np.array([[0.5]]))
+        self.assertTrue(np.all(np.isfinite(mean)) and np.all(np.isfinite(std)))
+
+        with patch.object(np.linalg,
+                          'cholesky',
+                          side_effect=np.linalg.LinAlgError):
+            with self.assertRaises(ValueError):
+                surrogate.fit(np.array([[0.], [1.]]), np.array([1., 2.]))
+
+    def test_analysis_lom_circuit_graph_reduction(self):
+        """Test CircuitGraph removes the nodes only touched by capacitors, and
+        reuses the reduction when only the capacitances change."""
+        nodes = ['grd', 'pad', 'coupler']
+
+        def circuit_graph(c_coupler):
+            cmat = pd.DataFrame([[60., -40., -c_coupler], [-40., 50., -10.],
+                                 [-c_coupler, -10., 30.]],
+                                index=nodes,
+                                columns=nodes)
+            return CircuitGraph(nodes, 'grd', [cmat], [{
+                ('pad', 'grd'): 10.
+            }], {('pad', 'grd'): 'j1'})
+
+        cg = circuit_graph(20.)
+        self.assertEqual(cg.get_nodes_keep(), ['j1'])
+        self.assertEqual(cg.get_nodes_remove(), ['coupler'])
+        # C_k is the series combination through the removed coupler node
+        self.assertAlmostEqual(cg.C_k[0, 0], 50. - 100. / 30., places=9)
+        self.assertAlmostEqual(cg.L_inv_k[0, 0], 0.1, places=12)
+
+        # Changing the basis of one circuit does not change the cache
+        cg.node_jj_basis.append('not_a_node')
+        self.assertNotIn('not_a_node', circuit_graph(20.).node_jj_basis)
+
+        num_cached = len(CircuitGraph._topology_cache)
+        cg = circuit_graph(25.)
+        _ = cg.C_k
+        self.assertEqual(len(CircuitGraph._topology_cache), num_cached)
+        self.assertEqual(cg.get_nodes_remove(), ['coupler'])
+
+        # An inductor between two floating nodes can't be reduced
+        cg = CircuitGraph(nodes, 'grd',
+                          [pd.DataFrame(np.eye(3), index=nodes, columns=nodes)],
+                          [{
+                              ('pad', 'coupler'): 10.
+                          }], {})
+        with self.assertRaises(ValueError):
+            _ = cg.S_remove
+
+    @staticmethod
+    def _lumped_resonator_pair():
+        """Two lumped resonators n1 and n2, coupled by a 2 fF capacitor and a
+        100 nH inductor, with their zero point fluctuations set."""
+        nodes = ['grd', 'n1', 'n2']
+        cmat = pd.DataFrame([[176., -98., -78.], [-98., 100., -2.],
+                             [-78., -2., 80.]],
+                            index=nodes,
+                            columns=nodes)
+        cell = Cell(
+            dict(cap_mat=cmat,
+                 ind_dict={
+                     ('n1', 'grd'): 10.,
+                     ('n2', 'grd'): 12.,
+                     ('n1', 'n2'): 100.
+                 },
+                 jj_dict={}))
+        subsystems = [
+            Subsystem(name='r1', sys_type='LUMPED_RESONATOR', nodes=['n1']),
+            Subsystem(name='r2', sys_type='LUMPED_RESONATOR', nodes=['n2'])
+        ]
+        for sub, q_zpf, phi_zpf in zip(subsystems, (2e-19, 3e-19),
+                                       (4e-17, 5e-17)):
+            sub._h_params[sub.nodes[0]].update(Q_zpf=q_zpf, Phi_zpf=phi_zpf)
+        return CompositeSystem(subsystems=subsystems,
+                               cells=[cell],
+                               grd_node='grd')
+
+    def test_analysis_lom_compute_gs_capacitive(self):
+        """Test the capacitive couplings of CompositeSystem.compute_gs."""
+        composite_sys = self._lumped_resonator_pair()
+        i_1, i_2 = composite_sys.node_indices(['n1', 'n2'])
+
+        g_mat = composite_sys.compute_gs()
+        # C^{-1}_{12} = 2 / (100 * 80 - 2 * 2) 1/fF, times Q_zpf1 * Q_zpf2,
+        # over hbar, in MHz
+        self.assertAlmostEqual(g_mat[i_1, i_2] / 22.649177662262737,
+                               1,
+                               places=9)
+        self.assertAlmostEqual(g_mat[i_2, i_1], g_mat[i_1, i_2], places=12)
+        self.assertEqual(g_mat[i_1, i_1], 0)
+        self.assertEqual(g_mat[i_2, i_2], 0)
+
+    def test_analysis_lom_compute_gs_inductive(self):
+        """Test the inductive couplings of CompositeSystem.compute_gs."""
+        composite_sys = self._lumped_resonator_pair()
+        i_1, i_2 = composite_sys.node_indices(['n1', 'n2'])
+
+        g_mat = composite_sys.compute_gs(CouplingType.INDUCTIVE)
+        # L^{-1}_{12} = -1 / 100 1/nH, times Phi_zpf1 * Phi_zpf2, over hbar,
+        # in MHz
+        self.assertAlmostEqual(g_mat[i_1, i_2] / -30.18380409790881,
+                               1,
+                               places=9)
+        self.assertAlmostEqual(g_mat[i_2, i_1], g_mat[i_1, i_2], places=12)
+        self.assertEqual(g_mat[i_1, i_1], 0)
+
+        # The zero point fluctuations of the coupled nodes are needed
+        del composite_sys.subsystems[1].h_params['n2']['Phi_zpf']
+        with self.assertRaises(ValueError):
+            composite_sys.compute_gs(CouplingType.INDUCTIVE)
+
 
 if __name__ == '__main__':
     unittest.main(verbosity=2)
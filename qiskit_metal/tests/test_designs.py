@@ -30,7 +30,9 @@ from qiskit_metal.designs.interface_components import Components
 from qiskit_metal.designs.net_info import QNet
 from qiskit_metal.qlibrary.core import QComponent
 from qiskit_metal.qlibrary.qubits.transmon_pocket import TransmonPocket
+from qiskit_metal.qlibrary.tlines.straight_path import RouteStraight
 from qiskit_metal.tests.assertions import AssertionsMixin
+from qiskit_metal.toolbox_python.profiler import profiler
 
 from qiskit_metal.qlibrary.lumped.resonator_coil_rect import ResonatorCoilRect
 
@@ -218,6 +220,38 @@ class TestDesign(unittest.TestCase, AssertionsMixin):
         self.assertEqual('my_name-1' in design.name_to_id, False)
         self.assertEqual('my_name-2' in design.name_to_id, False)
 
+    def test_design_children_options_cache(self):
+        """Test that the gathered default options follow the class edits."""
+
+        class MyComponent(QComponent):
+            """Component with its own default options."""
+            default_options = dict(width='1um', nested=dict(gap='2um'))
+
+        design = DesignPlanar(metadata={})
+        options = MyComponent._gather_all_children_options()
+        self.assertEqual(options['width'], '1um')
+
+        # A replaced dict is picked up at once
+        MyComponent.default_options = dict(width='3um',
+                                           nested=dict(gap='2um'))
+        options = MyComponent._gather_all_children_options()
+        self.assertEqual(options['width'], '3um')
+
+        # An edit within the dict is picked up once the design is cleared
+        MyComponent.default_options['width'] = '4um'
+        self.assertEqual(
+            MyComponent._gather_all_children_options()['width'], '3um')
+        design.delete_all_components()
+        options = MyComponent._gather_all_children_options()
+        self.assertEqual(options['width'], '4um')
+
+        # Only a shallow copy is returned
+        options['width'] = '5um'
+        self.assertEqual(
+            MyComponent._gather_all_children_options()['width'], '4um')
+        self.assertIs(options['nested'],
+                      MyComponent._gather_all_children_options()['nested'])
+
     def test_design_get_and_set_design_name(self):
         """Test getting the design name in design_base.py."""
         design = DesignPlanar(metadata={})
@@ -518,6 +552,112 @@ class TestDesign(unittest.TestCase, AssertionsMixin):
         self.assertEqual(result['aedt_hfss_inductance'], 10e-9)
         self.assertEqual(result['aedt_hfss_capacitance'], 0)
 
+        # The cached defaults are refreshed when a renderer adds a column
+        design.add_default_data_for_qgeometry_tables('junction', 'hfss',
+                                                     'my_column', 'my_value')
+        result = q1._get_table_values_from_renderers(design)
+        self.assertEqual(len(result), 18)
+        self.assertEqual(result['hfss_my_column'], 'my_value')
+
+    def test_design_rebuild_profile(self):
+        """Test that the profiler times the make of each component in a
+        rebuild, with its rows and parse calls."""
+        design = DesignPlanar()
+        TransmonPocket(design, 'Q1')
+        TransmonPocket(design, 'Q2', options=dict(pos_x='1mm'))
+
+        with profiler.enabled_for():
+            design.rebuild()
+
+        table = profiler.to_dataframe()
+        rebuild = table[table['name'] == 'QDesign.rebuild']
+        makes = table[table['name'] == 'QComponent.make']
+        self.assertEqual(len(rebuild), 1)
+        self.assertEqual(list(makes['component']), ['Q1', 'Q2'])
+        self.assertTrue((makes['depth'] == 1).all())
+        self.assertTrue((makes['qgeometry_rows'] > 0).all())
+        self.assertTrue((makes['parse_value'] > 0).all())
+        self.assertEqual(rebuild['qgeometry_rows'].iloc[0],
+                         makes['qgeometry_rows'].sum())
+        self.assertIn('qgeometry_rows', design.build_logs.data()[0])
+
+        trace = profiler.to_chrome_trace()
+        self.assertEqual(len(trace['traceEvents']), len(table))
+
+    def test_design_rebuild_components_stop_progress(self):
+        """Test the rebuild of some components, with its progress and an
+        early stop."""
+        design = DesignPlanar()
+        for name in ['Q1', 'Q2', 'Q3']:
+            TransmonPocket(design, name)
+
+        calls = []
+        complete = design.rebuild(['Q3', 'deleted', 'Q1'],
+                                  progress=lambda *args: calls.append(args))
+        self.assertTrue(complete)
+        self.assertEqual(calls, [(1, 2, 'Q3'), (2, 2, 'Q1')])
+
+        calls = []
+        complete = design.rebuild(stop=lambda: len(calls) == 2,
+                                  progress=lambda *args: calls.append(args))
+        self.assertFalse(complete)
+        self.assertEqual(calls, [(1, 3, 'Q1'), (2, 3, 'Q2')])
+
+    def test_design_variable_dependents(self):
+        """Test that only the components using a variable, and the routes
+        attached to them, depend on it."""
+        design = DesignPlanar()
+        design.variables['q1_x'] = '-1mm'
+        TransmonPocket(design,
+                       'Q1',
+                       options=dict(pos_x='q1_x',
+                                    connection_pads=dict(a=dict())))
+        TransmonPocket(design,
+                       'Q2',
+                       options=dict(pos_x='1mm',
+                                    connection_pads=dict(b=dict())))
+        TransmonPocket(design, 'Q3', options=dict(pos_x='3mm'))
+        RouteStraight(design,
+                      'R',
+                      options=dict(pin_inputs=dict(
+                          start_pin=dict(component='Q1', pin='a'),
+                          end_pin=dict(component='Q2', pin='b'))))
+
+        self.assertIn('q1_x', design.components['Q1'].variables_used)
+        self.assertEqual(design.variable_dependents(['q1_x']), ['Q1', 'R'])
+        self.assertEqual(design.variable_dependents(['not_used']), [])
+
+        design.variables['q1_x'] = '-2mm'
+        design.rebuild(design.variable_dependents(['q1_x']))
+        self.assertAlmostEqual(design.components['Q1'].p.pos_x, -2)
+
+        # Components unpickled from older designs did not record variables
+        del design.components['Q3']._variables_used
+        self.assertEqual(design.components['Q3'].variables_used, set())
+        self.assertEqual(design.variable_dependents(['q1_x']), ['Q1', 'R'])
+
+    def test_design_component_listeners(self):
+        """Test the events sent to the component listeners."""
+        design = DesignPlanar()
+        events = []
+        listener = lambda event, comp_id: events.append((event, comp_id))
+        design.add_component_listener(listener)
+
+        q_1 = TransmonPocket(design, 'Q1')
+        design.rename_component(q_1.id, 'Q2')
+        design.delete_component('Q2')
+        design.delete_all_components()
+        self.assertEqual(events, [('added', q_1.id), ('status', q_1.id),
+                                  ('renamed', q_1.id), ('deleted', q_1.id),
+                                  ('cleared', None)])
+
+        # The listeners are not pickled
+        self.assertEqual(design.__getstate__()['_component_listeners'], [])
+
+        design.remove_component_listener(listener)
+        TransmonPocket(design, 'Q3')
+        self.assertEqual(len(events), 5)
+
 
 if __name__ == '__main__':
     unittest.main(verbosity=2)
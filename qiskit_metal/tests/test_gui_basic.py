@@ -19,11 +19,49 @@
 Test a planar design and launching the GUI.
 """
 
+import logging
+import threading
+import time
 import unittest
+from types import SimpleNamespace
+
+from PySide2.QtWidgets import QApplication
+
+from qiskit_metal._gui.rebuild_worker import RebuildWorker
 from qiskit_metal._gui.widgets.bases.dict_tree_base import BranchNode
 from qiskit_metal._gui.widgets.bases.dict_tree_base import LeafNode
 
 
+class BlockingDesign:
+    """Fake design whose rebuild waits, after the first component, until it
+    is released."""
+
+    def __init__(self):
+        self.calls = []
+        self.started = threading.Event()
+        self.release = threading.Event()
+
+    def rebuild(self, component_names, stop, progress):
+        """Record the names, and make them until stop returns True."""
+        self.calls.append(component_names)
+        for index, name in enumerate(component_names):
+            if stop():
+                return False
+            if not self.started.is_set():
+                self.started.set()
+                self.release.wait(5)
+            progress(index + 1, len(component_names), name)
+        return True
+
+
+def process_events_until(condition, timeout=5):
+    """Run the Qt events until condition returns True."""
+    end = time.time() + timeout
+    while not condition() and time.time() < end:
+        QApplication.processEvents()
+        time.sleep(0.005)
+
+
 class TestGUIBasic(unittest.TestCase):
     """Unit test class."""
 
@@ -51,6 +89,46 @@ class TestGUIBasic(unittest.TestCase):
             message = "LeafNode instantiation failed"
             self.fail(message)
 
+    def test_rebuild_worker_coalesce_and_stop(self):
+        """Test that RebuildWorker coalesces the requests, stops the running
+        rebuild on a new request, and finishes once."""
+        _ = QApplication.instance() or QApplication([])
+        design = BlockingDesign()
+        gui = SimpleNamespace(design=design, logger=logging.getLogger('test'))
+        worker = RebuildWorker(gui, delay=0)
+        finished = []
+        worker.finished.connect(finished.append)
+
+        worker.request(['Q1'])
+        worker.request(['Q2'])
+        worker.request(['Q1'])
+        process_events_until(design.started.is_set)
+        self.assertEqual(design.calls, [['Q1', 'Q2']])
+        self.assertTrue(worker.is_running)
+
+        # A new request stops the running rebuild after Q1; Q2 is redone
+        worker.request(['Q3'])
+        design.release.set()
+        process_events_until(lambda: finished)
+        self.assertEqual(design.calls, [['Q1', 'Q2'], ['Q3', 'Q2']])
+        self.assertEqual(finished, [True])
+        self.assertFalse(worker.is_running)
+
+        # Editing stops the running rebuild, and none starts within the block
+        design = BlockingDesign()
+        gui.design = design
+        worker.request(['Q1', 'Q2'])
+        process_events_until(design.started.is_set)
+        threading.Timer(0.05, design.release.set).start()
+        with worker.editing():
+            self.assertFalse(worker.is_running)
+            process_events_until(lambda: False, timeout=0.1)
+            self.assertEqual(design.calls, [['Q1', 'Q2']])
+            self.assertFalse(worker.is_running)
+        process_events_until(lambda: len(finished) > 1)
+        self.assertEqual(design.calls, [['Q1', 'Q2'], ['Q2']])
+        self.assertEqual(finished, [True, True])
+
 
 if __name__ == '__main__':
     unittest.main(verbosity=2)
@@ -21,12 +21,13 @@
 import unittest
 import numpy as np
 
-from geopandas import GeoDataFrame
+from geopandas import GeoDataFrame, GeoSeries
 
 from qiskit_metal import designs
 from qiskit_metal import draw
 
 from qiskit_metal.qgeometries import qgeometries_handler
+from qiskit_metal.qgeometries.component_tables import FixedPointFrame
 from qiskit_metal.qgeometries.qgeometries_handler import QGeometryTables
 from qiskit_metal.qlibrary.qubits.transmon_pocket import TransmonPocket
 
@@ -329,6 +330,151 @@ class TestElements(unittest.TestCase):
         self.assertEqual(actual['poly'], None)
         self.assertEqual(actual['junction'], None)
 
+    def test_qgeometry_rebuild_only_touches_own_rows(self):
+        """Test that deleting and rebuilding a component leaves the rows of
+        the other components untouched, and that the tables stay whole."""
+        design = designs.DesignPlanar()
+        q_1 = TransmonPocket(design, 'Q1')
+        q_2 = TransmonPocket(design, 'Q2', options=dict(pos_x='1mm'))
+        num_rows = len(design.qgeometry.tables['poly'])
+        q2_frames = design.qgeometry.tables._parts['poly'][q_2.id]
+
+        q_1.options.pad_gap = '40um'
+        q_1.rebuild()
+
+        self.assertIs(design.qgeometry.tables._parts['poly'][q_2.id], q2_frames)
+        table = design.qgeometry.tables['poly']
+        self.assertEqual(len(table), num_rows)
+        self.assertEqual(set(table.component), {q_1.id, q_2.id})
+        self.assertEqual(
+            len(q_1.qgeometry_table('poly')) + len(q_2.qgeometry_table('poly')),
+            num_rows)
+
+        design.qgeometry.delete_component_id(q_1.id)
+        self.assertEqual(set(design.qgeometry.tables['poly'].component),
+                         {q_2.id})
+
+    def test_qgeometry_cached_bounds(self):
+        """Test that the cached bounds of components and of the design match
+        the bounds of the geometry, and follow a rebuild."""
+        design = designs.DesignPlanar()
+        q_1 = TransmonPocket(design, 'Q1')
+        q_2 = TransmonPocket(design, 'Q2', options=dict(pos_x='1mm'))
+        qgt = design.qgeometry
+
+        for qcomp in [q_1, q_2]:
+            np.testing.assert_allclose(
+                qcomp.qgeometry_bounds(),
+                qgt.get_component_geometry(qcomp.name).total_bounds)
+        expected = GeoSeries(
+            np.concatenate([
+                np.asarray(qgt.tables[name].geometry, dtype=object)
+                for name in qgt.tables
+            ])).total_bounds
+        np.testing.assert_allclose(qgt.get_bounds(), expected)
+        np.testing.assert_allclose(qgt.get_bounds([q_1.id]),
+                                   q_1.qgeometry_bounds())
+        np.testing.assert_allclose(qgt.get_bounds([q_1.id], chip='main'),
+                                   q_1.qgeometry_bounds())
+        self.assertIsNone(qgt.get_bounds([q_1.id], chip='not-a-chip'))
+
+        q_2.options.pos_x = '2mm'
+        q_2.rebuild()
+        np.testing.assert_allclose(
+            q_2.qgeometry_bounds(),
+            qgt.get_component_geometry('Q2').total_bounds)
+        self.assertAlmostEqual(qgt.get_bounds()[2], q_2.qgeometry_bounds()[2])
+
+    def test_qgeometry_component_fingerprints(self):
+        """Test that the fingerprint of a component follows its rows, and
+        only its rows."""
+        design = designs.DesignPlanar()
+        q_1 = TransmonPocket(design, 'Q1')
+        q_2 = TransmonPocket(design, 'Q2', options=dict(pos_x='1mm'))
+        qgt = design.qgeometry
+
+        before = qgt.get_component_fingerprints()
+        self.assertEqual(set(before), {q_1.id, q_2.id})
+        self.assertNotEqual(before[q_1.id], before[q_2.id])
+
+        q_2.rebuild()
+        self.assertEqual(qgt.get_component_fingerprints(), before)
+
+        q_2.options.pos_x = '2mm'
+        q_2.rebuild()
+        after = qgt.get_component_fingerprints([q_1.id, q_2.id])
+        self.assertEqual(after[q_1.id], before[q_1.id])
+        self.assertNotEqual(after[q_2.id], before[q_2.id])
+
+        q_2.options.pos_x = '1mm'
+        q_2.rebuild()
+        self.assertEqual(qgt.get_component_fingerprints(), before)
+
+    def test_qgeometry_fixed_point_coordinates(self):
+        """Test the snapping of the coordinates to the database unit, and
+        their integer representation."""
+        design = designs.DesignPlanar()
+        qgt = design.qgeometry
+        with self.assertRaises(ValueError):
+            qgt.get_fixed_point_coordinates('poly')
+
+        # Components built before the database unit is set are snapped to it
+        q_1 = TransmonPocket(design, 'Q1', options=dict(pos_x='0.1234567mm'))
+        before = qgt.get_component_fingerprints()
+        qgt.set_dbu('1 nm')
+        self.assertEqual(design.template_options.DBU, '1 nm')
+        self.assertNotEqual(qgt.get_component_fingerprints(), before)
+        coords, offsets = qgt.get_fixed_point_coordinates('poly')
+        table = qgt.tables['poly']
+        self.assertEqual(coords.dtype, np.int64)
+        self.assertEqual(len(offsets), len(table) + 1)
+        self.assertEqual(offsets[-1], len(coords))
+
+        # The geometry is exactly on the grid of the database unit
+        first = np.asarray(table.geometry.iloc[0].exterior.coords)
+        self.assertTrue(
+            np.array_equal(first, coords[:len(first)] * qgt.dbu))
+
+        # The integer coordinates are what is stored, the geometry is built
+        # from them, with the same columns and rows
+        frames = qgt.tables._parts['poly'][q_1.id]
+        self.assertTrue(
+            all(isinstance(frame, FixedPointFrame) for frame in frames))
+        self.assertTrue(all('geometry' not in frame.values for frame in frames))
+        self.assertEqual(list(table.columns),
+                         list(qgt.tables._empty['poly'].columns))
+        self.assertEqual(len(q_1.qgeometry_table('poly')), len(table))
+        self.assertTrue(
+            table.geometry.geom_equals_exact(q_1.qgeometry_table('poly').geometry,
+                                             0).all())
+        np.testing.assert_allclose(q_1.qgeometry_bounds(),
+                                   GeoSeries(table.geometry).total_bounds)
+
+        before = qgt.get_component_fingerprints()
+        q_1.rebuild()
+        self.assertEqual(qgt.get_component_fingerprints(), before)
+
+        # A coarser unit snaps the geometry again
+        qgt.set_dbu('1 um')
+        coords_um, _ = qgt.get_fixed_point_coordinates('poly')
+        first = np.asarray(qgt.tables['poly'].geometry.iloc[0].exterior.coords)
+        self.assertTrue(
+            np.array_equal(first, coords_um[:len(first)] * qgt.dbu))
+        self.assertTrue(np.all(np.abs(coords_um * 1000 - coords) <= 500))
+        self.assertNotEqual(qgt.get_component_fingerprints(), before)
+
+        dbu_um = qgt.dbu
+        qgt.set_dbu(None)
+        self.assertIsNone(qgt.dbu)
+        with self.assertRaises(ValueError):
+            qgt.get_fixed_point_coordinates('poly')
+        self.assertTrue(
+            all(
+                isinstance(frame, GeoDataFrame)
+                for frame in qgt.tables._parts['poly'][q_1.id]))
+        first = np.asarray(qgt.tables['poly'].geometry.iloc[0].exterior.coords)
+        self.assertTrue(np.array_equal(first, coords_um[:len(first)] * dbu_um))
+
 
 if __name__ == '__main__':
     unittest.main(verbosity=2)
@@ -19,9 +19,19 @@
 # pylint: disable-msg=protected-access
 """Qiskit Metal unit tests analyses functionality."""
 
+import os
+import pickle
+import sys
+import tempfile
 import unittest
-from unittest.mock import MagicMock
+from collections import defaultdict
+from concurrent.futures import ThreadPoolExecutor
+from types import SimpleNamespace
+from unittest.mock import MagicMock, patch
 import matplotlib.pyplot as _plt
+import numpy as np
+import shapely
+from shapely.geometry import LineString, Polygon, box
 
 from qiskit_metal import designs
 from qiskit_metal.renderers import setup_default
@@ -31,7 +41,9 @@ from qiskit_metal.renderers.renderer_ansys.hfss_renderer import QHFSSRenderer
 from qiskit_metal.renderers.renderer_base.renderer_base import QRenderer
 from qiskit_metal.renderers.renderer_base.renderer_gui_base import QRendererGui
 from qiskit_metal.renderers.renderer_gds.gds_renderer import QGDSRenderer
+from qiskit_metal.renderers.renderer_gds.make_cheese import Cheesing
 from qiskit_metal.renderers.renderer_mpl.mpl_interaction import MplInteraction
+from qiskit_metal.renderers.renderer_mpl.mpl_renderer import QMplRenderer
 from qiskit_metal.renderers.renderer_gmsh.gmsh_renderer import QGmshRenderer
 from qiskit_metal.renderers.renderer_elmer.elmer_renderer import QElmerRenderer
 from qiskit_metal.renderers.renderer_ansys_pyaedt.hfss_renderer_eigenmode_aedt import QHFSSEigenmodePyaedt
@@ -39,12 +51,84 @@ from qiskit_metal.renderers.renderer_ansys_pyaedt.hfss_renderer_drivenmodal_aedt
 from qiskit_metal.renderers.renderer_ansys_pyaedt.q3d_renderer_aedt import QQ3DPyaedt
 
 from qiskit_metal.renderers.renderer_ansys import ansys_renderer
+from qiskit_metal.renderers.renderer_gds import gds_renderer
 
 from qiskit_metal.qgeometries.qgeometries_handler import QGeometryTables
 from qiskit_metal.qlibrary.qubits.transmon_pocket import TransmonPocket
 from qiskit_metal import draw
 
 
+class RecordingModeler:
+    """Fake pyEPR modeler which records the calls made to it."""
+
+    class Object(str):
+        """Drawn object, renamed like the pyEPR ones."""
+
+        def __new__(cls, name, modeler):
+            obj = super().__new__(cls, name)
+            obj.modeler = modeler
+            return obj
+
+        def rename(self, new_name):
+            self.modeler.calls.append(('rename', (self, new_name), {}))
+            return RecordingModeler.Object(new_name, self.modeler)
+
+    def __init__(self):
+        self.calls = []
+
+    def __getattr__(self, method):
+
+        def record(*args, **kwargs):
+            self.calls.append((method, args, kwargs))
+            if method.startswith('draw_'):
+                return RecordingModeler.Object(
+                    kwargs.get('name', f'{method}{len(self.calls)}'), self)
+            return None
+
+        return record
+
+
+class ObjectModeler(RecordingModeler):
+    """Fake pyEPR modeler which also lists the objects in the design."""
+
+    def object_names(self):
+        """Names of the objects, replayed from the calls."""
+        names = []
+        for index, (method, args, kwargs) in enumerate(self.calls):
+            if method.startswith('draw_'):
+                names.append(kwargs.get('name', f'{method}{index + 1}'))
+            elif method in ('rename', 'rename_obj'):
+                names[names.index(args[0])] = args[1]
+            elif method in ('subtract', 'delete'):
+                for name in args[-1]:
+                    names.remove(name)
+        return names
+
+    def delete(self, names):
+        """Delete the named objects."""
+        self.calls.append(('delete', (list(names),), {}))
+
+
+class AssignmentModule:
+    """Fake boundaries and mesh modules of an Ansys design."""
+
+    def __init__(self):
+        self.names = []
+
+    def GetBoundaries(self):
+        """Names of the boundaries."""
+        return list(self.names)
+
+    def DeleteBoundaries(self, names):
+        """Delete the named boundaries."""
+        for name in names:
+            self.names.remove(name)
+
+    def GetOperationNames(self, kind):  # pylint: disable=unused-argument
+        """Names of the mesh operations."""
+        return []
+
+
 class TestRenderers(unittest.TestCase):
     """Unit test class."""
 
@@ -162,7 +246,7 @@ class TestRenderers(unittest.TestCase):
         renderer = QAnsysRenderer(design, initiate=False)
         options = renderer.default_options
 
-        self.assertEqual(len(options), 14)
+        self.assertEqual(len(options), 15)
         self.assertEqual(options['Lj'], '10nH')
         self.assertEqual(options['Cj'], 0)
         self.assertEqual(options['_Rj'], 0)
@@ -176,6 +260,7 @@ class TestRenderers(unittest.TestCase):
         self.assertEqual(options['wb_threshold'], '400um')
         self.assertEqual(options['wb_offset'], '0um')
         self.assertEqual(options['wb_size'], 5)
+        self.assertEqual(options['batch_geometry'], 'False')
 
         self.assertEqual(len(options['plot_ansys_fields_options']), 13)
         self.assertEqual(options['plot_ansys_fields_options']['name'],
@@ -323,7 +408,7 @@ class TestRenderers(unittest.TestCase):
         renderer = QGDSRenderer(design)
         options = renderer.default_options
 
-        self.assertEqual(len(options), 17)
+        self.assertEqual(len(options), 18)
         self.assertEqual(options['short_segments_to_not_fillet'], 'True')
         self.assertEqual(options['check_short_segments_by_scaling_fillet'],
                          '2.0')
@@ -342,6 +427,7 @@ class TestRenderers(unittest.TestCase):
         self.assertEqual(options['bounding_box_scale_y'], '1.2')
 
         self.assertEqual(options['fabricate'], 'False')
+        self.assertEqual(options['hierarchical'], 'False')
 
         self.assertEqual(len(options['cheese']), 9)
         self.assertEqual(len(options['no_cheese']), 5)
@@ -530,6 +616,260 @@ class TestRenderers(unittest.TestCase):
         self.assertEqual(etd['junction']['resistance'], 0)
         self.assertEqual(etd['junction']['mesh_kw_jj'], 7e-06)
 
+    def test_renderer_changed_since_render(self):
+        """Test the comparison of the components with the last render."""
+        design = designs.DesignPlanar()
+        q_1 = TransmonPocket(design, 'Q1')
+        q_2 = TransmonPocket(design, 'Q2', options=dict(pos_x='1mm'))
+        renderer = QGDSRenderer(design, initiate=False)
+
+        self.assertIsNone(renderer.changed_since_render([], open_pins=None))
+        renderer.record_render([], open_pins=None)
+        self.assertEqual(renderer.changed_since_render([], open_pins=None),
+                         (set(), set()))
+        self.assertIsNone(renderer.changed_since_render([], open_pins=[]))
+
+        q_2.options.pos_x = '2mm'
+        q_2.rebuild()
+        self.assertEqual(renderer.changed_since_render([], open_pins=None),
+                         ({q_2.id}, set()))
+        self.assertEqual(
+            renderer.changed_since_render([q_1.id], open_pins=None),
+            (set(), {q_2.id}))
+
+        design.rename_component(q_1.id, 'Q3')
+        self.assertEqual(
+            renderer.changed_since_render([q_1.id], open_pins=None),
+            ({q_1.id}, {q_2.id}))
+
+        renderer.forget_render()
+        self.assertIsNone(renderer.changed_since_render([], open_pins=None))
+
+    def test_renderer_mpl_renderer_update(self):
+        """Test that QMplRenderer renders one collection per table, layer and
+        subtract flag, and that update only redraws the changed components."""
+        design = designs.DesignPlanar()
+        q_1 = TransmonPocket(design, 'Q1')
+        q_2 = TransmonPocket(design, 'Q2', options=dict(pos_x='1mm'))
+        renderer = QMplRenderer(None, design, design.logger)
+        _, ax = _plt.subplots()
+
+        def paths_of(comp_id):
+            return sum((owners == comp_id).sum()
+                       for owners in renderer._owners.values())
+
+        self.assertFalse(renderer.update(ax))
+        renderer.render(ax)
+        collections = list(ax.collections)
+        num_paths_1 = paths_of(q_1.id)
+        self.assertTrue(num_paths_1)
+        for collection in collections:
+            self.assertEqual(set(renderer._owners[collection]),
+                             {q_1.id, q_2.id})
+
+        # Subtracted shapes are drawn under the metal
+        zorders = {
+            subtracted: renderer.get_zorder(1, subtracted)
+            for subtracted in (True, False)
+        }
+        self.assertLess(zorders[True], zorders[False])
+        self.assertEqual(
+            sorted(set(collection.get_zorder() for collection in collections)),
+            sorted(zorders.values()))
+
+        q_2.options.pos_x = '2mm'
+        q_2.rebuild()
+        self.assertTrue(renderer.update(ax))
+        for collection in collections:
+            self.assertIn(collection, ax.collections)
+            self.assertEqual(set(renderer._owners[collection]), {q_1.id})
+            self.assertEqual(len(collection.get_paths()),
+                             len(renderer._owners[collection]))
+        self.assertEqual(paths_of(q_1.id), num_paths_1)
+        self.assertEqual(paths_of(q_2.id), num_paths_1)
+
+        renderer.hide_component('Q1')
+        self.assertEqual(paths_of(q_1.id), 0)
+        renderer.show_component('Q1')
+        self.assertEqual(paths_of(q_1.id), num_paths_1)
+
+        design.delete_component('Q1')
+        renderer.update(ax)
+        self.assertEqual(paths_of(q_1.id), 0)
+        self.assertEqual(len(ax.collections), len(renderer._owners))
+
+        renderer.hide_layer(1)
+        self.assertFalse(renderer.update(ax))
+        _plt.close(ax.figure)
+
+    def test_renderer_ansys_renderer_incremental(self):
+        """Test that an incremental render of QAnsysRenderer only redraws
+        the changed components, and the shapes subtracted from the ground."""
+        design = designs.DesignPlanar()
+        TransmonPocket(design, 'Q1')
+        q_2 = TransmonPocket(design, 'Q2', options=dict(pos_x='1mm'))
+
+        renderer = QAnsysRenderer(design, initiate=False)
+        modeler = ObjectModeler()
+        boundaries = AssignmentModule()
+        renderer._pinfo = SimpleNamespace(
+            design=SimpleNamespace(modeler=modeler,
+                                   _boundaries=boundaries,
+                                   _mesh=AssignmentModule()),
+            get_all_object_names=modeler.object_names)
+        renderer.delete_objects = modeler.delete
+        renderer.get_active_design_name = lambda: 'Design'
+
+        # Each junction makes a boundary, like the lumped RLC of QHFSSRenderer
+        render_junction = renderer.render_element_junction
+
+        def render_junction_with_boundary(qgeom):
+            render_junction(qgeom)
+            boundaries.names.append(
+                f'Lj_{qgeom["component"]}_{len(modeler.calls)}')
+
+        renderer.render_element_junction = render_junction_with_boundary
+
+        def render():
+            renderer.qcomp_ids, renderer.case = [], 1
+            renderer.chip_subtract_dict = defaultdict(set)
+            renderer.assign_perfE = []
+            renderer.assign_mesh = []
+            num_calls = len(modeler.calls)
+            renderer.begin_incremental_render(True, open_pins=None)
+            with patch.object(ansys_renderer, 'parse_units',
+                              lambda value: design.parse_value(value)):
+                renderer.render_tables()
+            subtracted = set().union(*renderer.chip_subtract_dict.values())
+            modeler.subtract('ground_main_plane', sorted(subtracted))
+            renderer.end_incremental_render(True, open_pins=None)
+            draws = [
+                call for call in modeler.calls[num_calls:]
+                if call[0].startswith('draw_')
+            ]
+            return (sorted(modeler.object_names()),
+                    sorted(renderer.assign_perfE), sorted(renderer.assign_mesh),
+                    len(draws), len(subtracted))
+
+        names, perf_e, mesh, num_draws, num_subtracted = render()
+        self.assertGreater(num_draws, num_subtracted)
+        self.assertGreater(num_subtracted, 0)
+        self.assertEqual(len(names), len(set(names)))
+        self.assertEqual(len(boundaries.names), 2)
+        q1_boundary, q2_boundary = boundaries.names
+
+        # Nothing changed: only the subtracted shapes are drawn again
+        again = render()
+        self.assertEqual(again[:3], (names, perf_e, mesh))
+        self.assertEqual(again[3], num_subtracted)
+        self.assertEqual(boundaries.names, [q1_boundary, q2_boundary])
+
+        # Q2 changed: it is drawn whole, and Q1 keeps its objects
+        q_2.options.pos_x = '2mm'
+        q_2.rebuild()
+        changed = render()
+        self.assertEqual(changed[:3], (names, perf_e, mesh))
+        self.assertEqual(changed[3],
+                         num_subtracted + (num_draws - num_subtracted) // 2)
+        # The boundary of the junction of Q2 is made again, not duplicated
+        self.assertEqual(len(boundaries.names), 2)
+        self.assertEqual(boundaries.names[0], q1_boundary)
+        self.assertNotEqual(boundaries.names[1], q2_boundary)
+
+    def test_renderer_ansys_renderer_batch_geometry(self):
+        """Test the batch_geometry option of QAnsysRenderer groups the same
+        modeler calls as the rendering of each element."""
+        design = designs.DesignPlanar()
+        q1 = TransmonPocket(design, 'Q1')
+        q1.add_qgeometry('poly', {
+            'ring':
+                Polygon([(0, 0), (1, 0), (1, 1), (0, 1)], [
+                    [(0.1, 0.1), (0.4, 0.1), (0.4, 0.4)],
+                    [(0.6, 0.6), (0.9, 0.6), (0.9, 0.9)],
+                ])
+        },
+                         fillet=0.05)
+        q1.add_qgeometry('path',
+                         {'trace': LineString([(0, 0), (1, 0), (1, 1)])},
+                         width=0.01,
+                         fillet=0.1)
+
+        class ComError(Exception):
+            """Stands for pythoncom.com_error, which is Windows-only."""
+
+        def render(batch_geometry, modeler=None):
+            renderer = QAnsysRenderer(
+                design,
+                initiate=False,
+                options=dict(batch_geometry=batch_geometry))
+            modeler = modeler or RecordingModeler()
+            renderer._pinfo = SimpleNamespace(design=SimpleNamespace(
+                modeler=modeler))
+            renderer.case = 1
+            renderer.chip_subtract_dict = defaultdict(set)
+            renderer.assign_perfE = []
+            renderer.assign_mesh = []
+            with patch.object(ansys_renderer, 'parse_units',
+                              lambda value: design.parse_value(value)), \
+                    patch.dict(sys.modules,
+                               pythoncom=SimpleNamespace(com_error=ComError)):
+                renderer.render_components('poly')
+                num_poly_calls = len(modeler.calls)
+                renderer.render_components('path')
+            return modeler.calls, num_poly_calls
+
+        def count(calls, method):
+            return sum(call[0] == method for call in calls)
+
+        calls, _ = render(False)
+        batched, num_poly_calls = render(True)
+        methods = [call[0] for call in batched]
+
+        # The renames are folded into the draws, which all come first
+        self.assertEqual(count(calls, 'draw_polyline'),
+                         count(batched, 'draw_polyline'))
+        self.assertEqual(count(calls, 'draw_rect_corner'),
+                         count(batched, 'draw_rect_corner'))
+        self.assertGreater(
+            count(calls, 'rename') + count(calls, 'rename_obj'), 0)
+        self.assertEqual(
+            count(batched, 'rename') + count(batched, 'rename_obj'), 0)
+        for table_methods in (methods[:num_poly_calls],
+                              methods[num_poly_calls:]):
+            num_draws = sum(
+                method.startswith('draw_') for method in table_methods)
+            self.assertTrue(
+                all(
+                    method.startswith('draw_')
+                    for method in table_methods[:num_draws]))
+
+        # Same fillets and sweeps, on the objects drawn under the final names
+        self.assertEqual(count(calls, '_fillet'), count(batched, '_fillet'))
+        self.assertEqual(count(calls, '_sweep_along_path'), 1)
+        self.assertEqual(count(batched, '_sweep_along_path'), 1)
+        sweep = batched[methods.index('_sweep_along_path')]
+        self.assertEqual(sweep[1][1], 'trace_Q1')
+
+        # The two interiors of the ring are subtracted in one call
+        self.assertEqual(count(calls, 'subtract'), 2)
+        self.assertEqual(count(batched, 'subtract'), 1)
+        subtract = batched[methods.index('subtract')]
+        self.assertEqual(subtract[1][0], 'ring_Q1')
+        self.assertEqual(len(subtract[1][1]), 2)
+
+        # A design which is not writable is reported when the batch is run
+        class ReadOnlyModeler(RecordingModeler):
+            """Fails to sweep, like a design which is not writable."""
+
+            def _sweep_along_path(self, *args):
+                raise ComError(-2147352567, 'Exception occurred.', None, None)
+
+        for batch_geometry in (False, True):
+            with patch.object(design.logger, 'error') as log_error:
+                with self.assertRaises(ComError):
+                    render(batch_geometry, ReadOnlyModeler())
+                self.assertIn('writable design', log_error.call_args[0][0])
+
     def test_renderer_gdsrenderer_high_level(self):
         """Test that high level defaults were not accidentally changed in
         gds_renderer.py."""
@@ -585,6 +925,182 @@ class TestRenderers(unittest.TestCase):
             for y, _ in enumerate(expected[x][0]):
                 self.assertTrue(_ in actual[x][0])
 
+    def test_renderer_gdsrenderer_hierarchical_instances(self):
+        """Test that identical QComponents share a cell in hierarchical GDS
+        export, placed at their own position and orientation."""
+        design = designs.DesignPlanar()
+        TransmonPocket(design, 'Q1', options=dict(pos_x='-1mm'))
+        TransmonPocket(design,
+                       'Q2',
+                       options=dict(pos_x='2mm', pos_y='1mm', orientation='90'))
+        TransmonPocket(design, 'Q3', options=dict(pad_width='300um'))
+        renderer = QGDSRenderer(design)
+        renderer.options.hierarchical = 'True'
+        renderer.chip_info.update(renderer._get_chip_names())
+        self.assertEqual(renderer._create_qgeometry_for_gds(), 0)
+
+        layer_info = renderer.chip_info['main'][1]
+        self.assertEqual(len(layer_info['instances']), 1)
+        instance = layer_info['instances'][0]
+        self.assertEqual(instance.name, 'TransmonPocket_main_1_0')
+        self.assertEqual(instance.placements, [(-1., 0., 0.), (2., 1., 90.)])
+        # Only the different Q3 is left to export flat
+        self.assertEqual(set(layer_info['all_subtract_false']['component']),
+                         {design.components['Q3'].id})
+
+        # The cell placed as Q2 gives back its geometries
+        q2_pads = design.qgeometry.tables['poly']
+        q2_pads = q2_pads[(q2_pads['component'] == design.components['Q2'].id) &
+                          ~q2_pads['subtract']]
+        for local, geom in zip(instance.table['geometry'], q2_pads['geometry']):
+            placed = draw.translate(draw.rotate(local, 90, origin=(0, 0)), 2, 1)
+            self.assertLess(placed.symmetric_difference(geom).area, 1e-12)
+
+    def test_renderer_gdsrenderer_stream_export(self):
+        """Test that the streaming GDS export writes and frees the cells of
+        each chip, and writes TOP last."""
+        design = designs.DesignPlanar()
+        TransmonPocket(design, 'Q1')
+        renderer = QGDSRenderer(design)
+
+        chip_cell = SimpleNamespace(name='TOP_main', references=[])
+        top = SimpleNamespace(name='TOP',
+                              references=[SimpleNamespace(ref_cell=chip_cell)])
+        cells = dict(TOP=top, TOP_main=chip_cell, my_jj=SimpleNamespace())
+        renderer.lib = SimpleNamespace(
+            cells=cells,
+            remove=lambda name, remove_references=True: cells.pop(name))
+        renderer.imported_junction_cells = {'my_jj'}
+        writer = MagicMock()
+        written = set()
+        renderer._write_finished_cells(writer, written, keep=['TOP'])
+        self.assertEqual(written, {'TOP_main', 'my_jj'})
+        self.assertEqual(set(cells), {'TOP', 'my_jj'})
+        self.assertEqual(top.references[0].ref_cell, 'TOP_main')
+        # The junction cells are kept for the next chip, but written once
+        renderer._write_finished_cells(writer, written, keep=['TOP'])
+        self.assertEqual(writer.write_cell.call_count, 2)
+
+        path = os.path.join(tempfile.gettempdir(), 'test_stream_export.gds')
+        with patch.object(gds_renderer.gdspy, 'GdsWriter') as gds_writer:
+            self.assertEqual(renderer.export_to_gds(path, stream=True), 1)
+        gds_writer.return_value.close.assert_called_once()
+        self.assertEqual(renderer.chip_info['main'], {})
+
+    def test_renderer_gdsrenderer_fragment_cache(self):
+        """Test that a second GDS export only converts the QComponents which
+        changed."""
+        design = designs.DesignPlanar()
+        TransmonPocket(design, 'Q1', options=dict(pos_x='-1mm'))
+        TransmonPocket(design, 'Q2', options=dict(pos_x='1mm'))
+        renderer = QGDSRenderer(design)
+        path = os.path.join(tempfile.gettempdir(), 'test_fragment_cache.gds')
+
+        def converted_components():
+            with patch.object(renderer,
+                              '_qgeometry_to_gds',
+                              wraps=renderer._qgeometry_to_gds) as convert:
+                self.assertEqual(renderer.export_to_gds(path), 1)
+            return {call.args[0]['component'] for call in convert.mock_calls}
+
+        q1_id = design.components['Q1'].id
+        q2_id = design.components['Q2'].id
+        self.assertEqual(converted_components(), {q1_id, q2_id})
+        self.assertEqual(converted_components(), set())
+
+        design.components['Q2'].options.pad_width = '300um'
+        design.rebuild()
+        self.assertEqual(converted_components(), {q2_id})
+        subtract_false = renderer.chip_info['main'][1]['all_subtract_false']
+        self.assertEqual(set(subtract_false['component']), {q1_id, q2_id})
+
+        renderer.options.precision = '0.000000002'
+        self.assertEqual(converted_components(), {q1_id, q2_id})
+
+        # The options are compared by value
+        renderer.options.width_LineString = '0.01mm'
+        self.assertEqual(converted_components(), set())
+
+        # A stream export keeps the fragments for the next export
+        with patch.object(gds_renderer.gdspy, 'GdsWriter'):
+            self.assertEqual(renderer.export_to_gds(path, stream=True), 1)
+        self.assertTrue(renderer._fragment_cache)
+        self.assertEqual(converted_components(), set())
+
+    def test_renderer_gdsrenderer_parallel_export(self):
+        """Test that the parallel GDS export makes one job per layer, and
+        merges them in the order of the layers."""
+        design = designs.DesignPlanar()
+        TransmonPocket(design, 'Q1', options=dict(pos_x='-1mm'))
+        TransmonPocket(design, 'Q2', options=dict(pos_x='1mm', layer='2'))
+        renderer = QGDSRenderer(design)
+        path = os.path.join(tempfile.gettempdir(), 'test_parallel_export.gds')
+
+        # The job of a layer can be sent to a worker process
+        renderer.chip_info.update(renderer._get_chip_names())
+        renderer._create_qgeometry_for_gds(convert=False)
+        job = pickle.loads(pickle.dumps(renderer._layer_job('main', 2)))
+        self.assertEqual(list(job.chip_info['main']), [2, 'junction'])
+        self.assertEqual(job.parse_value('1um'), 0.001)
+        self.assertEqual(job.design.get_x_y_for_chip('main'),
+                         design.get_x_y_for_chip('main'))
+
+        # And its result, with the gdspy cells, can be sent back
+        _, rectangle_points = renderer._get_rectangle_points('main')
+        result = pickle.loads(
+            pickle.dumps(job._export_layer('main', 2, rectangle_points)))
+        self.assertTrue(result.cells)
+        self.assertEqual({key[:2] for key in result.fragments}, {('main', 2)})
+        lib = gds_renderer.gdspy.GdsLibrary()
+        renderer._merge_layer(lib, None, 'main', 2, result)
+        self.assertTrue({cell.name for cell in result.cells} <= set(lib.cells))
+        self.assertEqual(
+            len(renderer.chip_info['main'][2]['q_subtract_false']), 2)
+
+        merged = []
+        merge_layer = renderer._merge_layer
+
+        def record_merge(lib, chip_only_top, chip_name, chip_layer, result):
+            merged.append((chip_name, chip_layer))
+            merge_layer(lib, chip_only_top, chip_name, chip_layer, result)
+
+        # Threads run the same jobs, without pickling the gdspy results
+        with patch.object(gds_renderer, 'ProcessPoolExecutor',
+                          ThreadPoolExecutor):
+            with patch.object(renderer, '_merge_layer', record_merge):
+                self.assertEqual(renderer.export_to_gds(path, max_workers=2), 1)
+        self.assertEqual(merged, [('main', 1), ('main', 2)])
+        for chip_layer in (1, 2):
+            self.assertEqual(
+                len(renderer.chip_info['main'][chip_layer]['q_subtract_false']),
+                2)
+        self.assertEqual({key[1] for key in renderer._fragment_cache}, {1, 2})
+
+    def test_renderer_gdsrenderer_no_cheese_buffer(self):
+        """Test that the no-cheese buffer made by clusters is the buffer of
+        the union, and that only the holes near it go through the boolean."""
+        geometries = np.array([
+            box(0, 0, 1, 1),
+            box(0.5, 0.5, 2, 2),
+            box(5, 5, 6, 6),
+            LineString([(10, 0), (10, 3)]).buffer(0.1)
+        ])
+        styles = (shapely.BufferCapStyle.flat, shapely.BufferJoinStyle.mitre)
+        result = QGDSRenderer._buffer_union_by_cluster(geometries, 0.2, *styles)
+        expected = shapely.union_all(geometries).buffer(0.2,
+                                                        cap_style=styles[0],
+                                                        join_style=styles[1])
+        self.assertEqual(len(result.geoms), 3)
+        self.assertAlmostEqual(result.symmetric_difference(expected).area, 0)
+
+        cheese = Cheesing(result, [], MagicMock(), 0, 0, 12, 12, 'main', 0, 1,
+                          False, 100, 99, False, MagicMock(), 199, 1e-9)
+        cheese.hole = box(-0.05, -0.05, 0.05, 0.05)
+        origins = np.array([(0.5, 0.5), (3.5, 3.5), (10, 1.5), (10.4, 1.5)])
+        self.assertEqual(
+            cheese._holes_touching_keepout(origins).tolist(),
+            [True, False, True, False])
+
     def test_renderer_mpl_interaction_disconnect(self):
         """Test disconnect in MplInteraction in mpl_interaction.py."""
         mpl = MplInteraction(_plt)
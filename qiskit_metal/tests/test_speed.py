@@ -18,8 +18,12 @@
 # pylint: disable-msg=import-error
 """Qiskit Metal unit tests for speed."""
 
+import json
+import os
+import tempfile
 import unittest
 import time
+from qiskit_metal.benchmarks import run_benchmarks, save_results
 from qiskit_metal.tests.custom_decorators import timeout
 
 
@@ -42,6 +46,37 @@ class TestSpeed(unittest.TestCase):
         time.sleep(4)
         self.assertEqual(4, 2 + 2)
 
+    def test_benchmarks_synthetic_grid(self):
+        """Test run_benchmarks on a small grid, and its JSON results."""
+        with self.assertRaises(ValueError):
+            run_benchmarks(stages=['nope'])
+
+        results = run_benchmarks(rows=1,
+                                 cols=2,
+                                 stages=['lom', 'route'],
+                                 repeat=2,
+                                 profile=True)
+        self.assertEqual(results.parameters.stages, ['build', 'route', 'lom'])
+        # Two qubits and the meander between them
+        self.assertEqual(results.parameters.num_components, 3)
+        for stage in results.parameters.stages:
+            result = results.stages[stage]
+            self.assertEqual(result.status, 'ok', result.error)
+            self.assertEqual(len(result.times), 2)
+            self.assertLessEqual(result.min, result.mean)
+        self.assertIn('benchmark.route',
+                      [row['name'] for row in results.profile])
+
+        with tempfile.TemporaryDirectory() as folder:
+            path = os.path.join(folder, 'benchmarks.jsonl')
+            save_results(results, path, append=True)
+            save_results(results, path, append=True)
+            with open(path) as file:
+                lines = [json.loads(line) for line in file]
+        self.assertEqual(len(lines), 2)
+        self.assertEqual(lines[0]['stages']['lom']['times'],
+                         results.stages.lom.times)
+
 
 if __name__ == '__main__':
     unittest.main(verbosity=2)
@@ -137,6 +137,16 @@ class TestToolboxMetal(unittest.TestCase, AssertionsMixin):
         for x, _ in enumerate(expected):
             self.assertTrue(_ in actual)
 
+    def test_toolbox_metal_parsing_record_variables(self):
+        """Test record_variables in parsing.py."""
+        variables = {'width': '10um', 'gap': 'width'}
+        with parsing.record_variables() as outer:
+            parsing.parse_value(['1mm', 'gap'], variables)
+            with parsing.record_variables() as inner:
+                parsing.parse_value({'x': 'missing'}, variables)
+        self.assertEqual(inner, {'missing'})
+        self.assertEqual(outer, {'gap', 'width', 'missing'})
+
     def test_toolbox_metal_is_true(self):
         """Test is_true in toolbox_metal.py."""
         self.assertTrue(parsing.is_true('true'))
@@ -23,7 +23,9 @@ from qiskit_metal.toolbox_python.display import Color
 from qiskit_metal.toolbox_python.display import MetalTutorialMagics
 from qiskit_metal.toolbox_python import display
 from qiskit_metal.toolbox_python import utility_functions
+from qiskit_metal.toolbox_python.profiler import Profiler
 from qiskit_metal.toolbox_python._logging import LogStore
+from qiskit_metal.toolbox_python.attr_dict import Dict
 
 
 class TestToolboxPython(unittest.TestCase):
@@ -142,6 +144,62 @@ class TestToolboxPython(unittest.TestCase):
         self.assertEqual(utility_functions.copy_update({'a': 1}, {'a': 2}),
                          {'a': 2})
 
+    def test_utility_copy_options(self):
+        """Test functionality of copy_options in utility_functions.py."""
+        options = {'a': '1um', 'b': {'c': [1, 2]}, 'd': (3, {'e': 4})}
+        result = utility_functions.copy_options(options, dict_type=Dict)
+
+        self.assertEqual(result, options)
+        self.assertIsInstance(result, Dict)
+        self.assertIsInstance(result.b, Dict)
+        self.assertEqual(result.b.c, [1, 2])
+
+        result.b.c.append(3)
+        result.d[1]['e'] = 5
+        self.assertEqual(options['b']['c'], [1, 2])
+        self.assertEqual(options['d'][1]['e'], 4)
+
+    def test_profiler_spans_and_counters(self):
+        """Test the nesting, counters and exports of Profiler."""
+        prof = Profiler()
+        with prof.span('disabled') as span:
+            prof.count('calls')
+        self.assertIsNone(span)
+        self.assertEqual(prof.spans, [])
+
+        with prof.enabled_for():
+            with prof.span('outer', component='Q1'):
+                prof.count('calls')
+                for _ in range(2):
+                    with prof.span('inner'):
+                        prof.count('calls')
+                        prof.count('rows', 3)
+        self.assertFalse(prof.enabled)
+
+        outer = prof.spans[-1]
+        self.assertEqual(outer.name, 'outer')
+        self.assertEqual(outer.counters, {'calls': 3, 'rows': 6})
+        self.assertGreaterEqual(outer.duration, outer.child_time)
+
+        table = prof.to_dataframe()
+        self.assertEqual(list(table['name']), ['outer', 'inner', 'inner'])
+        self.assertEqual(list(table['depth']), [0, 1, 1])
+        self.assertEqual(table['component'][0], 'Q1')
+
+        summary = prof.summary()
+        self.assertEqual(summary.loc['inner', 'spans'], 2)
+        self.assertEqual(summary.loc['inner', 'rows'], 6)
+        self.assertEqual(summary.loc['outer', 'spans'], 1)
+
+        events = prof.to_chrome_trace()['traceEvents']
+        self.assertEqual([event['ph'] for event in events], ['X'] * 3)
+        self.assertEqual(events[0]['args'], {
+            'component': 'Q1',
+            'calls': 3,
+            'rows': 6
+        })
+        self.assertLessEqual(events[0]['ts'], events[1]['ts'])
+
     def test_utility_bad_fillet_idxs(self):
         """Test functionality of bad_fillet_idxs in utility_functions.py."""
         results = utility_functions.bad_fillet_idxs([(1.0, 1.0), (1.5, 1.5),
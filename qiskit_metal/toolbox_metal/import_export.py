@@ -21,7 +21,9 @@ import pickle
 #from ..designs.base
 from ..toolbox_python.utility_functions import log_error_easy
 
-__all__ = ['save_metal', 'load_metal_design']
+__all__ = [
+    'save_metal', 'load_metal_design', 'design_to_bytes', 'design_from_bytes'
+]
 
 
 def save_metal(filename: str, design):
@@ -83,3 +85,39 @@ def load_metal_design(filename: str):
     design.logger = logger  #TODO: fix from save pikcle
 
     return design
+
+
+def design_to_bytes(design) -> bytes:
+    """Serialize the design in memory, e.g. to send a copy of it to another
+    process.
+
+    Args:
+        design (QDesign): Design to copy.
+
+    Returns:
+        bytes: The pickled design.
+    """
+    logger = design.logger
+    design.logger = None
+    try:
+        data = pickle.dumps(design)
+    finally:
+        design.logger = logger
+    return data
+
+
+def design_from_bytes(data: bytes):
+    """Recreate a design serialized by design_to_bytes.
+
+    Args:
+        data (bytes): The pickled design.
+
+    Returns:
+        QDesign: An independent copy of the design.
+    """
+    design = pickle.loads(data)
+
+    from .. import logger
+    design.logger = logger
+
+    return design
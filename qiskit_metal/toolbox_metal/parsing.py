@@ -171,15 +171,18 @@ Returns:
 
 from collections.abc import Iterable
 from collections.abc import Mapping
+from contextlib import contextmanager
 from numbers import Number
-from typing import Union
+from typing import Set, Union
 
 import ast
+import threading
 import numpy as np
 import pint
 from pint import UnitRegistry
 
 from .. import Dict, config, logger
+from ..toolbox_python.profiler import profiler
 
 __all__ = [
     'parse_value',  # Main function
@@ -187,7 +190,8 @@ __all__ = [
     'is_numeric_possible',
     'is_for_ast_eval',
     'is_true',
-    'parse_options'
+    'parse_options',
+    'record_variables'
 ]
 
 #########################################################################
@@ -203,6 +207,9 @@ FALSE_STR = [
     0.0
 ]
 
+# Names looked up as variables by parse_value, per thread, see record_variables
+_RECORDING = threading.local()
+
 
 def is_true(value: Union[str, int, bool, float]) -> bool:
     """Check if a value is true or not.
@@ -304,6 +311,36 @@ def is_numeric_possible(test_str: str):
     # look into pyparsing
 
 
+@contextmanager
+def record_variables() -> Set[str]:
+    """Record the names that `parse_value` looks up as variables within the
+    block, in the current thread.  Names which are not variables (yet) are
+    recorded too, since adding such a variable changes the parsed value.
+
+    Recordings can be nested; the outer one also gets the names of the inner
+    ones.
+
+    Example:
+        .. code-block:: python
+
+            with record_variables() as names:
+                parse_value('cpw_width', design.variables)
+            # names == {'cpw_width'}
+
+    Yields:
+        Set[str]: The names recorded so far
+    """
+    outer = getattr(_RECORDING, 'names', None)
+    names = set()
+    _RECORDING.names = names
+    try:
+        yield names
+    finally:
+        _RECORDING.names = outer
+        if outer is not None:
+            outer.update(names)
+
+
 # pylint: disable-msg=too-many-branches
 # pylint: disable-msg=too-many-return-statements
 def parse_value(value: str, variable_dict: dict):
@@ -346,6 +383,8 @@ def parse_value(value: str, variable_dict: dict):
     Return:
         str, float, list, tuple, or ast eval: Parsed value
     """
+    if profiler.enabled:
+        profiler.count('parse_value')
 
     if isinstance(value, str):
 
@@ -357,6 +396,9 @@ def parse_value(value: str, variable_dict: dict):
                 # we have a string that could be interpreted as a variable
                 # check if there is such a variable name, else return as string
                 # logger.warning(f'Missing variable {opts[name]} from variable list.\n')
+                recorded = getattr(_RECORDING, 'names', None)
+                if recorded is not None:
+                    recorded.add(val)
 
                 if val in variable_dict:
                     # Parse the returned value
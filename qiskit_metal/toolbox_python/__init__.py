@@ -39,6 +39,7 @@ Submodules
 
     _logging
     display
+    profiler
     utility_functions
 
 """
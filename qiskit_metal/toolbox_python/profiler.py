@@ -0,0 +1,325 @@
+# -*- coding: utf-8 -*-
+
+# This code is part of Qiskit.
+#
+# (C) Copyright IBM 2017, 2021.
+#
+# This code is licensed under the Apache License, Version 2.0. You may
+# obtain a copy of this license in the LICENSE.txt file in the root directory
+# of this source tree or at http://www.apache.org/licenses/LICENSE-2.0.
+#
+# Any modifications or derivative works of this code must retain this
+# copyright notice, and modified files need to carry a notice indicating
+# that they have been altered from the originals.
+"""Hierarchical timing and counters for the rebuild and render pipeline.
+
+The stages of the pipeline, such as ``QDesign.rebuild``, the make of each
+component, ``QGeometryTables.add_qgeometry`` and the ``render_design`` of the
+renderers, open a span of the module profiler.  Spans nest, and hold the
+counters incremented while they are open, such as the number of qgeometry
+rows added, or of calls to ``parse_value``.
+
+The profiler is off by default, so that the spans and counters cost a single
+check.  Switch it on around the code to measure:
+
+.. code-block:: python
+
+    from qiskit_metal.toolbox_python.profiler import profiler
+
+    with profiler.enabled_for():
+        design.rebuild()
+
+    profiler.summary()  # pandas table, one row per stage
+    profiler.to_dataframe()  # pandas table, one row per span
+    profiler.save_chrome_trace('rebuild.json')  # open in chrome://tracing
+"""
+
+import functools
+import json
+import os
+import threading
+import time
+from contextlib import contextmanager
+from typing import Any, Callable, Dict as Dict_, List, Union
+
+import pandas as pd
+
+__all__ = ['Profiler', 'ProfileSpan', 'profiler', 'profiled']
+
+
+class ProfileSpan:
+    """A timed stage of the pipeline, with the counters incremented while it
+    was open.  The times are in nanoseconds from `time.perf_counter_ns`."""
+
+    __slots__ = ('name', 'args', 'depth', 'start', 'end', 'counters',
+                 'child_time', 'thread')
+
+    def __init__(self, name: str, args: dict, depth: int, thread: int):
+        self.name = name
+        self.args = args
+        self.depth = depth
+        self.thread = thread
+        self.counters = dict()  # type: Dict_[str, int]
+        self.child_time = 0
+        self.end = None
+        self.start = time.perf_counter_ns()
+
+    @property
+    def duration(self) -> int:
+        """Time from the start to the end of the span, in ns."""
+        end = self.end if self.end is not None else time.perf_counter_ns()
+        return end - self.start
+
+    @property
+    def self_time(self) -> int:
+        """Time spent in the span but in none of its children, in ns."""
+        return self.duration - self.child_time
+
+    def __repr__(self):
+        return (f'ProfileSpan({self.name!r}, {self.duration / 1e6:.3f} ms, '
+                f'{self.counters})')
+
+
+class _NullSpan:
+    """Context returned by a disabled profiler, which does nothing."""
+
+    def __enter__(self):
+        return None
+
+    def __exit__(self, *exc):
+        return False
+
+
+_NULL_SPAN = _NullSpan()
+
+
+class Profiler:
+    """Collects nested timed spans and counters.
+
+    Each thread has its own stack of open spans.  The finished spans are kept,
+    in the order they closed, up to `max_spans`.
+    """
+
+    def __init__(self, max_spans: int = 100000):
+        """
+        Args:
+            max_spans (int): Number of finished spans to keep. The oldest are
+                dropped first. Defaults to 100000.
+        """
+        self.enabled = False
+        self.max_spans = max_spans
+        self._spans = []  # type: List[ProfileSpan]
+        self._local = threading.local()
+        self._origin = time.perf_counter_ns()
+
+    def _stack(self) -> List[ProfileSpan]:
+        stack = getattr(self._local, 'stack', None)
+        if stack is None:
+            stack = self._local.stack = []
+        return stack
+
+    def enable(self):
+        """Start collecting spans and counters."""
+        self.enabled = True
+
+    def disable(self):
+        """Stop collecting. The spans collected so far are kept."""
+        self.enabled = False
+
+    def reset(self):
+        """Drop the spans collected so far."""
+        self._spans = []
+        self._origin = time.perf_counter_ns()
+
+    @contextmanager
+    def enabled_for(self, reset: bool = True):
+        """Collect the spans of the code run in the context.
+
+        Args:
+            reset (bool): Drop the spans collected before. Defaults to True.
+        """
+        if reset:
+            self.reset()
+        was_enabled, self.enabled = self.enabled, True
+        try:
+            yield self
+        finally:
+            self.enabled = was_enabled
+
+    def span(self, name: str, **args):
+        """Context which times a stage of the pipeline, nested in the spans
+        open in the same thread.
+
+        Args:
+            name (str): Name of the stage, such as 'QComponent.make'.
+            **args: Values which describe this span, such as the component.
+
+        Returns:
+            The context, which gives the ProfileSpan, or None if the
+            profiler is disabled.
+        """
+        if not self.enabled:
+            return _NULL_SPAN
+        return self._span(name, args)
+
+    @contextmanager
+    def _span(self, name: str, args: dict):
+        stack = self._stack()
+        span = ProfileSpan(name, args, len(stack), threading.get_ident())
+        stack.append(span)
+        try:
+            yield span
+        finally:
+            span.end = time.perf_counter_ns()
+            stack.pop()
+            if stack:
+                parent = stack[-1]
+                parent.child_time += span.duration
+                for key, value in span.counters.items():
+                    parent.counters[key] = parent.counters.get(key, 0) + value
+            self._spans.append(span)
+            if len(self._spans) > self.max_spans:
+                del self._spans[:len(self._spans) - self.max_spans]
+
+    def count(self, name: str, value: int = 1):
+        """Add value to a counter of the innermost open span.  The counters
+        of a span are added to its parent when it closes.
+
+        Args:
+            name (str): Name of the counter, such as 'rows'.
+            value (int): Amount to add. Defaults to 1.
+        """
+        if not self.enabled:
+            return
+        stack = self._stack()
+        if stack:
+            counters = stack[-1].counters
+            counters[name] = counters.get(name, 0) + value
+
+    def current(self) -> Union[ProfileSpan, None]:
+        """The innermost open span of this thread, None if there is none."""
+        stack = self._stack() if self.enabled else None
+        return stack[-1] if stack else None
+
+    @property
+    def spans(self) -> List[ProfileSpan]:
+        """The finished spans, in the order they closed."""
+        return list(self._spans)
+
+    def to_dataframe(self) -> pd.DataFrame:
+        """Table of the finished spans, in the order they started.
+
+        Returns:
+            pd.DataFrame: One row per span, with its name, depth, start,
+            duration and self time in ms, the args of the span, and one
+            column per counter.
+        """
+        rows = []
+        for span in sorted(self._spans, key=lambda span: span.start):
+            row = dict(name=span.name,
+                       depth=span.depth,
+                       start_ms=(span.start - self._origin) / 1e6,
+                       duration_ms=span.duration / 1e6,
+                       self_ms=span.self_time / 1e6)
+            row.update(span.args)
+            row.update(span.counters)
+            rows.append(row)
+        return pd.DataFrame(rows)
+
+    def summary(self) -> pd.DataFrame:
+        """Table of the time and counters of each stage, summed over its
+        spans.
+
+        Returns:
+            pd.DataFrame: One row per span name, sorted by total time, with the
+            number of spans, the total, self and mean time in ms, and the sum
+            of each counter.
+        """
+        table = self.to_dataframe()
+        if table.empty:
+            return pd.DataFrame(
+                columns=['spans', 'total_ms', 'self_ms', 'mean_ms'
+                        ]).rename_axis('name')
+        counters = sorted(
+            {key for span in self._spans for key in span.counters})
+        grouped = table.groupby('name')
+        summary = pd.DataFrame({
+            'spans': grouped.size(),
+            'total_ms': grouped['duration_ms'].sum(),
+            'self_ms': grouped['self_ms'].sum()
+        })
+        summary['mean_ms'] = summary['total_ms'] / summary['spans']
+        for counter in counters:
+            summary[counter] = grouped[counter].sum().astype(int)
+        return summary.sort_values('total_ms', ascending=False)
+
+    def to_chrome_trace(self) -> dict:
+        """The finished spans as Chrome trace events.
+
+        Returns:
+            dict: In the Trace Event Format, for chrome://tracing or Perfetto.
+            Each span is a complete ('X') event, with its args and counters
+            in the event args.
+        """
+        pid = os.getpid()
+        events = []
+        for span in sorted(self._spans, key=lambda span: span.start):
+            args = {key: _json_value(value) for key, value in span.args.items()}
+            args.update(span.counters)
+            events.append(
+                dict(name=span.name,
+                     cat='qiskit_metal',
+                     ph='X',
+                     ts=(span.start - self._origin) / 1e3,
+                     dur=span.duration / 1e3,
+                     pid=pid,
+                     tid=span.thread,
+                     args=args))
+        return dict(traceEvents=events, displayTimeUnit='ms')
+
+    def save_chrome_trace(self, path: str):
+        """Write the finished spans to a Chrome trace JSON file.
+
+        Args:
+            path (str): Path of the file to write.
+        """
+        with open(path, 'w') as file:
+            json.dump(self.to_chrome_trace(), file)
+
+
+def _json_value(value: Any) -> Any:
+    """Value itself if JSON can hold it, else its string."""
+    if value is None or isinstance(value, (bool, int, float, str)):
+        return value
+    return str(value)
+
+
+profiler = Profiler()
+"""The profiler of the rebuild and render pipeline."""
+
+
+def profiled(name: str = None) -> Callable:
+    """Decorator which times each call of a function in a span of the module
+    profiler.
+
+    Args:
+        name (str): Name of the span. Defaults to None, for the qualified
+            name of the function.
+
+    Returns:
+        Callable: The decorator.
+    """
+
+    def decorator(func: Callable) -> Callable:
+        span_name = name or func.__qualname__
+
+        @functools.wraps(func)
+        def wrapper(*args, **kwargs):
+            if not profiler.enabled:
+                return func(*args, **kwargs)
+            with profiler.span(span_name):
+                return func(*args, **kwargs)
+
+        return wrapper
+
+    return decorator
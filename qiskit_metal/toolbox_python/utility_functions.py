@@ -19,6 +19,7 @@ import re
 import sys
 import traceback
 import warnings
+from collections import OrderedDict
 from copy import deepcopy
 from typing import Dict, List, TYPE_CHECKING, Tuple, Callable, Union
 import inspect
@@ -26,17 +27,19 @@ import inspect
 import pandas as pd
 
 from qiskit_metal.draw import Vector
+from qiskit_metal.toolbox_python.attr_dict import Dict as AttrDict
 from qiskit_metal.toolbox_metal.exceptions import InputError
 
 if TYPE_CHECKING:
     from qiskit_metal import logger
 
 __all__ = [
-    'copy_update', 'dict_start_with', 'data_frame_empty_typed', 'clean_name',
-    'enable_warning_traceback', 'get_traceback', 'print_traceback_easy',
-    'log_error_easy', 'monkey_patch', 'can_write_to_path',
-    'can_write_to_path_with_warning', 'toggle_numbers', 'bad_fillet_idxs',
-    'compress_vertex_list', 'get_range_of_vertex_to_not_fillet'
+    'copy_update', 'copy_options', 'dict_start_with', 'data_frame_empty_typed',
+    'clean_name', 'enable_warning_traceback', 'get_traceback',
+    'print_traceback_easy', 'log_error_easy', 'monkey_patch',
+    'can_write_to_path', 'can_write_to_path_with_warning', 'toggle_numbers',
+    'bad_fillet_idxs', 'compress_vertex_list',
+    'get_range_of_vertex_to_not_fillet'
 ]
 
 ####################################################################################
@@ -63,6 +66,45 @@ def copy_update(options, *args, deep_copy=True, **kwargs):
     return options
 
 
+# Types of dict which copy_options copies itself
+_COPIED_DICT_TYPES = (dict, AttrDict, OrderedDict)
+
+# Values which can be shared between copies, since they cannot be mutated
+_IMMUTABLE_TYPES = (str, int, float, complex, bool, bytes, type(None),
+                    frozenset)
+
+
+def copy_options(options, dict_type: type = None):
+    """Copy of a tree of options, equivalent to deepcopy for the dicts,
+    lists, tuples, strings and numbers options are made of, but much faster.
+
+    The containers are copied, while the values which cannot be mutated,
+    such as strings and numbers, are shared between the copies.  Any other
+    value is deep copied.
+
+    Args:
+        options (object): Options, usually a dict of dicts.
+        dict_type (type): If given, every dict in the tree is copied into a
+            dict of this type, such as Dict.  Defaults to None, to keep the
+            types.
+
+    Returns:
+        object: The copy.
+    """
+    if isinstance(options, _IMMUTABLE_TYPES):
+        return options
+    if isinstance(options, dict) and (dict_type is not None or
+                                      type(options) in _COPIED_DICT_TYPES):
+        copied = (dict_type or type(options))()
+        for key, value in options.items():
+            copied[key] = copy_options(value, dict_type)
+        return copied
+    if type(options) in (list, tuple):
+        return type(options)(
+            copy_options(value, dict_type) for value in options)
+    return deepcopy(options)
+
+
 def dict_start_with(my_dict, start_with, as_=list):
     """Case sensitive https://stackoverflow.com/questions/17106819/accessing-
     python-dict-values-with-the-key-start-characters.